@@ -32,6 +32,7 @@
 #include <stdbool.h>
 
 #include <nuttx/mutex.h>
+#include <nuttx/drivers/drivers.h>
 #include <nuttx/fs/fs.h>
 
 /****************************************************************************
@@ -40,22 +41,52 @@
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+/* The sector cache */
+
+#define BCH_NCACHE        CONFIG_BCH_CACHE_NSECTORS
+
+#if CONFIG_BCH_READAHEAD + 1 < BCH_NCACHE
+#  define BCH_RAMAX       (CONFIG_BCH_READAHEAD + 1)
+#else
+#  define BCH_RAMAX       BCH_NCACHE
+#endif
+
+/* The buffer of the cache entry 'i' */
+
+#define BCH_CACHE_BUFFER(bch, i) \
+  (&(bch)->buffer[(size_t)(i) * (bch)->sectsize])
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One entry of the sector cache.  The buffers of all entries are laid out
+ * in order in one allocation, so that adjacent entries holding adjacent
+ * sectors can be read or written with a single request.
+ */
+
+struct bchlib_cache_s
+{
+  size_t sector;           /* The sector in the entry, (size_t)-1 if none */
+  uint32_t stamp;          /* LRU stamp of the last access, 0 if unused */
+  bool dirty;              /* true: Data has been written to the entry */
+};
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
+  size_t rasector;         /* The next sector of a sequential access */
+  uint32_t stamp;          /* LRU clock of the sector cache */
   mutex_t lock;            /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
-  bool dirty;              /* true: Data has been written to the buffer */
+  uint8_t rawindow;        /* Sectors to read on the next sequential miss */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* Buffers of the sector cache */
+  struct bchlib_cache_s cache[BCH_NCACHE];
+  struct bch_cachestats_s stats;
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -81,7 +112,12 @@ EXTERN const struct file_operations g_bch_fops;
  * Public Function Prototypes
  ****************************************************************************/
 
+EXTERN void bchlib_initcache(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch, bool discard);
+EXTERN int  bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors);
+EXTERN void bchlib_discardrange(FAR struct bchlib_s *bch, size_t sector,
+                                size_t nsectors);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
 
 #undef EXTERN
@@ -431,6 +431,30 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+      /* This is a request to get the sector cache statistics */
+
+      case DIOC_CACHESTATS:
+        {
+          FAR struct bch_cachestats_s *stats =
+            (FAR struct bch_cachestats_s *)((uintptr_t)arg);
+
+          if (stats == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          ret = nxmutex_lock(&bch->lock);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          memcpy(stats, &bch->stats, sizeof(*stats));
+          nxmutex_unlock(&bch->lock);
+        }
+        break;
+
       case BIOC_FLUSH:
         {
           /* Flush any dirty pages remaining in the cache */
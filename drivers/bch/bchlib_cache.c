@@ -27,6 +27,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -60,10 +61,11 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *data,
+                      size_t sector, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)data;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -71,7 +73,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -89,15 +91,154 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 }
 #endif
 
+/****************************************************************************
+ * Name: bch_cachelookup
+ *
+ * Description:
+ *   Return the cache entry holding 'sector', or -ENOENT if not cached.
+ *
+ ****************************************************************************/
+
+static int bch_cachelookup(FAR struct bchlib_s *bch, size_t sector)
+{
+  int i;
+
+  for (i = 0; i < BCH_NCACHE; i++)
+    {
+      if (bch->cache[i].sector == sector)
+        {
+          return i;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: bch_cachetouch
+ *
+ * Description:
+ *   Mark the cache entries [index, index + count) as the most recently
+ *   used ones.
+ *
+ ****************************************************************************/
+
+static void bch_cachetouch(FAR struct bchlib_s *bch, int index, int count)
+{
+  int i;
+
+  if (++bch->stamp == 0)
+    {
+      /* The clock wrapped, forget the order of the used entries */
+
+      bch->stamp = 1;
+      for (i = 0; i < BCH_NCACHE; i++)
+        {
+          if (bch->cache[i].stamp != 0)
+            {
+              bch->cache[i].stamp = 1;
+            }
+        }
+
+      bch->stamp++;
+    }
+
+  for (i = index; i < index + count; i++)
+    {
+      bch->cache[i].stamp = bch->stamp;
+    }
+}
+
+/****************************************************************************
+ * Name: bch_cachevictim
+ *
+ * Description:
+ *   Select 'count' adjacent cache entries to be reused, the run whose most
+ *   recently used entry is the oldest one.  Unused entries are taken first.
+ *
+ ****************************************************************************/
+
+static int bch_cachevictim(FAR struct bchlib_s *bch, int count)
+{
+  uint32_t oldest = UINT32_MAX;
+  int victim = 0;
+  int i;
+  int j;
+
+  for (i = 0; i + count <= BCH_NCACHE; i++)
+    {
+      uint32_t stamp = 0;
+
+      for (j = i; j < i + count; j++)
+        {
+          if (bch->cache[j].stamp > stamp)
+            {
+              stamp = bch->cache[j].stamp;
+            }
+        }
+
+      if (stamp < oldest)
+        {
+          oldest = stamp;
+          victim = i;
+          if (stamp == 0)
+            {
+              break;
+            }
+        }
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Name: bch_cacheinval
+ *
+ * Description:
+ *   Drop the content of one cache entry, dirty or not.
+ *
+ ****************************************************************************/
+
+static void bch_cacheinval(FAR struct bchlib_s *bch, int index)
+{
+  bch->cache[index].sector = (size_t)-1;
+  bch->cache[index].stamp  = 0;
+  bch->cache[index].dirty  = false;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: bchlib_initcache
+ *
+ * Description:
+ *   Initialize the sector cache to the empty state.  The buffers are
+ *   allocated on first use.
+ *
+ ****************************************************************************/
+
+void bchlib_initcache(FAR struct bchlib_s *bch)
+{
+  int i;
+
+  for (i = 0; i < BCH_NCACHE; i++)
+    {
+      bch_cacheinval(bch, i);
+    }
+
+  bch->rasector = (size_t)-1;
+  bch->rawindow = 1;
+}
+
 /****************************************************************************
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Write all dirty sectors of the cache back to the media, in sector
+ *   order.  Runs of adjacent sectors held by adjacent cache entries are
+ *   written with a single request.  Drop all cached sectors if 'discard'.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -106,58 +247,177 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 
 int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 {
-  FAR struct inode *inode;
+  FAR struct inode *inode = bch->inode;
+  uint8_t order[BCH_NCACHE];
   ssize_t ret = OK;
+  int ndirty = 0;
+  int first;
+  int count;
+  int i;
+  int j;
 
-  /* Check if the sector has been modified and is out of synch with the
-   * media.
-   */
+  /* Sort the dirty entries by sector */
 
-  if (bch->dirty && bch->buffer != NULL)
+  for (i = 0; i < BCH_NCACHE; i++)
     {
-      inode = bch->inode;
+      if (bch->cache[i].dirty)
+        {
+          for (j = ndirty++; j > 0; j--)
+            {
+              if (bch->cache[order[j - 1]].sector < bch->cache[i].sector)
+                {
+                  break;
+                }
+
+              order[j] = order[j - 1];
+            }
+
+          order[j] = i;
+        }
+    }
+
+  for (i = 0; i < ndirty; i += count)
+    {
+      size_t sector;
+
+      /* Extend the run while the next dirty sector is the next one on the
+       * media and is held by the next cache entry.
+       */
+
+      first  = order[i];
+      sector = bch->cache[first].sector;
+      for (count = 1; i + count < ndirty; count++)
+        {
+          if (order[i + count] != first + count ||
+              bch->cache[first + count].sector != sector + count)
+            {
+              break;
+            }
+        }
 
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      for (j = 0; j < count; j++)
+        {
+          bch_cypher(bch, BCH_CACHE_BUFFER(bch, first + j), sector + j,
+                     CYPHER_ENCRYPT);
+        }
 #endif
 
-      /* Write the sector to the media */
+      /* Write the sectors to the media */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
-      if (ret < 0)
-        {
-          ferr("Write failed: %zd\n", ret);
-          return (int)ret;
-        }
+      ret = inode->u.i_bops->write(inode, BCH_CACHE_BUFFER(bch, first),
+                                   sector, count);
 
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Computation overhead to save memory for extra sector buffer
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      for (j = 0; j < count; j++)
+        {
+          bch_cypher(bch, BCH_CACHE_BUFFER(bch, first + j), sector + j,
+                     CYPHER_DECRYPT);
+        }
 #endif
 
-      /* The sector is now in sync with the media */
+      if (ret < 0)
+        {
+          ferr("Write failed: %zd\n", ret);
+          return (int)ret;
+        }
+
+      /* The sectors are now in sync with the media */
+
+      for (j = first; j < first + count; j++)
+        {
+          bch->cache[j].dirty = false;
+        }
 
-      bch->dirty = false;
+      bch->stats.nwriteback += count;
+      bch->stats.nwrites++;
+      ret = OK;
     }
 
   if (discard)
     {
-      bch->sector = (size_t)-1;
+      for (i = 0; i < BCH_NCACHE; i++)
+        {
+          bch_cacheinval(bch, i);
+        }
     }
 
   return (int)ret;
 }
 
+/****************************************************************************
+ * Name: bchlib_flushrange
+ *
+ * Description:
+ *   Write the dirty sectors back to the media if any of them is in the
+ *   range [sector, sector + nsectors), before the range is read directly
+ *   from the media.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                      size_t nsectors)
+{
+  int i;
+
+  for (i = 0; i < BCH_NCACHE; i++)
+    {
+      if (bch->cache[i].dirty && bch->cache[i].sector >= sector &&
+          bch->cache[i].sector < sector + nsectors)
+        {
+          return bchlib_flushsector(bch, false);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_discardrange
+ *
+ * Description:
+ *   Drop the cached sectors in the range [sector, sector + nsectors), after
+ *   the range is written directly to the media.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_discardrange(FAR struct bchlib_s *bch, size_t sector,
+                         size_t nsectors)
+{
+  int i;
+
+  for (i = 0; i < BCH_NCACHE; i++)
+    {
+      if (bch->cache[i].sector >= sector &&
+          bch->cache[i].sector < sector + nsectors)
+        {
+          bch_cacheinval(bch, i);
+        }
+    }
+}
+
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Read the current sector contents into buffer
+ *   Make the sector available in the cache, reading it from the media (and
+ *   the following sectors if the access is sequential) on a miss.
+ *
+ * Returned Value:
+ *   The index of the cache entry holding the sector, see BCH_CACHE_BUFFER,
+ *   or a negated errno value on failure.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -167,14 +427,19 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
   FAR struct inode *inode;
-  ssize_t ret = OK;
+  bool sequential;
+  ssize_t ret;
+  int index;
+  int count;
+  int i;
 
   if (bch->buffer == NULL)
     {
 #if CONFIG_BCH_BUFFER_ALIGNMENT != 0
-      bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, bch->sectsize);
+      bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT,
+                                 (size_t)BCH_NCACHE * bch->sectsize);
 #else
-      bch->buffer = kmm_malloc(bch->sectsize);
+      bch->buffer = kmm_malloc((size_t)BCH_NCACHE * bch->sectsize);
 #endif
       if (bch->buffer == NULL)
         {
@@ -183,29 +448,96 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
         }
     }
 
-  if (bch->sector != sector)
+  sequential    = sector == bch->rasector;
+  bch->rasector = sector + 1;
+
+  index = bch_cachelookup(bch, sector);
+  if (index >= 0)
     {
-      inode = bch->inode;
+      bch_cachetouch(bch, index, 1);
+      bch->stats.nhits++;
+      return index;
+    }
 
-      ret = bchlib_flushsector(bch, true);
-      if (ret < 0)
+  bch->stats.nmisses++;
+
+  /* Grow the read-ahead window on a sequential miss, shrink it back on a
+   * random one.
+   */
+
+  if (!sequential)
+    {
+      bch->rawindow = 1;
+    }
+  else if (bch->rawindow < BCH_RAMAX)
+    {
+      bch->rawindow = bch->rawindow * 2 < BCH_RAMAX ?
+                      bch->rawindow * 2 : BCH_RAMAX;
+    }
+
+  /* Stop the read-ahead at the end of the media or at a sector already in
+   * the cache, which may be newer than the media.
+   */
+
+  count = sequential ? bch->rawindow : 1;
+  if ((size_t)count > bch->nsectors - sector)
+    {
+      count = bch->nsectors - sector;
+    }
+
+  for (i = 1; i < count; i++)
+    {
+      if (bch_cachelookup(bch, sector + i) >= 0)
         {
-          ferr("Flush failed: %zd\n", ret);
-          return (int)ret;
+          count = i;
+          break;
         }
+    }
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
-      if (ret < 0)
+  /* Write back the dirty sectors all together if any of the entries to be
+   * reused is dirty.
+   */
+
+  index = bch_cachevictim(bch, count);
+  for (i = index; i < index + count; i++)
+    {
+      if (bch->cache[i].dirty)
         {
-          ferr("Read failed: %zd\n", ret);
-          return (int)ret;
+          ret = bchlib_flushsector(bch, false);
+          if (ret < 0)
+            {
+              ferr("Flush failed: %zd\n", ret);
+              return (int)ret;
+            }
+
+          break;
         }
+    }
+
+  for (i = index; i < index + count; i++)
+    {
+      bch_cacheinval(bch, i);
+    }
 
-      bch->sector = sector;
+  inode = bch->inode;
+  ret = inode->u.i_bops->read(inode, BCH_CACHE_BUFFER(bch, index),
+                              sector, count);
+  if (ret < 0)
+    {
+      ferr("Read failed: %zd\n", ret);
+      return (int)ret;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      bch->cache[index + i].sector = sector + i;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, BCH_CACHE_BUFFER(bch, index + i), sector + i,
+                 CYPHER_DECRYPT);
 #endif
     }
 
-  return (int)ret;
+  bch_cachetouch(bch, index, count);
+  bch->stats.nreadahead += count - 1;
+  return index;
 }
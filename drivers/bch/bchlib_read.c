@@ -118,7 +118,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nbytes = len;
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+      memcpy(buffer, BCH_CACHE_BUFFER(bch, ret) + sectoffset, nbytes);
 
       /* Adjust pointers and counts */
 
@@ -146,6 +146,15 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
+      /* Write back the cached sectors which are newer than the media */
+
+      ret = bchlib_flushrange(bch, sector, nsectors);
+      if (ret < 0)
+        {
+          ferr("ERROR: Flush failed: %d\n", ret);
+          return ret;
+        }
+
       ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
                                        sector, nsectors);
       if (ret < 0)
@@ -160,6 +169,10 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
       nbytes     = nsectors * bch->sectsize;
       bytesread += nbytes;
 
+      /* A partial sector following this one is a sequential access */
+
+      bch->rasector = sector;
+
       if (sector >= bch->nsectors)
         {
           return bytesread;
@@ -183,7 +196,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      memcpy(buffer, BCH_CACHE_BUFFER(bch, ret), len);
 
       /* Adjust counts */
 
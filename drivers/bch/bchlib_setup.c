@@ -108,8 +108,8 @@ int bchlib_setup(FAR const char *blkdev, bool readonly, FAR void **handle)
   nxmutex_init(&bch->lock);
   bch->nsectors = geo.geo_nsectors;
   bch->sectsize = geo.geo_sectorsize;
-  bch->sector   = (size_t)-1;
   bch->readonly = readonly;
+  bchlib_initcache(bch);
   *handle = bch;
   return OK;
 
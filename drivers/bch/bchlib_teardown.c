@@ -68,7 +68,7 @@ int bchlib_teardown(FAR void *handle)
 
   close_blockdriver(bch->inode);
 
-  /* Free the BCH state structure */
+  /* Free the sector cache and the BCH state structure */
 
   if (bch->buffer)
     {
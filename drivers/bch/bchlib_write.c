@@ -102,8 +102,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           nbytes = len;
         }
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      memcpy(BCH_CACHE_BUFFER(bch, ret) + sectoffset, buffer, nbytes);
+      bch->cache[ret].dirty = true;
 
       /* Adjust pointers and counts */
 
@@ -131,16 +131,19 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      /* Flush the dirty sector to keep the sector sequence */
+      /* Flush the dirty sectors to keep the sector sequence, the cached
+       * copies of the sectors written below become stale.
+       */
 
-      ret = bchlib_flushsector(bch, sector <= bch->sector &&
-                               bch->sector < (sector + nsectors));
+      ret = bchlib_flushsector(bch, false);
       if (ret < 0)
         {
           ferr("ERROR: Flush failed: %d\n", ret);
           return ret;
         }
 
+      bchlib_discardrange(bch, sector, nsectors);
+
       /* Write the contiguous sectors */
 
       ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
@@ -180,8 +183,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       /* Copy the head end of the sector from the user buffer */
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      memcpy(BCH_CACHE_BUFFER(bch, ret), buffer, len);
+      bch->cache[ret].dirty = true;
 
       /* Adjust counts */
 
@@ -44,6 +44,8 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/drivers/rwbuffer.h>
 
+#include "ftl_log.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -54,6 +56,14 @@
 #  define FTL_HAVE_RWBUFFER 1
 #endif
 
+/* Check if the device uses the log-structured mapping */
+
+#ifdef CONFIG_FTL_LOG
+#  define ftl_is_log(dev) ((dev)->log != NULL)
+#else
+#  define ftl_is_log(dev) false
+#endif
+
 /* The maximum length of the device name paths is the maximum length of a
  * name plus 5 for the the length of "/dev/" and a NUL terminator.
  */
@@ -80,6 +90,10 @@ struct ftl_struct_s
 
   FAR off_t            *lptable;
   off_t                 lpcount;
+
+#ifdef CONFIG_FTL_LOG
+  FAR struct ftl_log_s *log;      /* Log-structured mapping */
+#endif
 };
 
 /****************************************************************************
@@ -201,6 +215,25 @@ static size_t ftl_get_cblock(FAR struct ftl_struct_s *dev, off_t start,
   return count;
 }
 
+/****************************************************************************
+ * Name: ftl_nsectors
+ *
+ * Description: Return the number of sectors of the block device
+ *
+ ****************************************************************************/
+
+static blkcnt_t ftl_nsectors(FAR struct ftl_struct_s *dev)
+{
+#ifdef CONFIG_FTL_LOG
+  if (ftl_is_log(dev))
+    {
+      return ftl_log_nsectors(dev->log);
+    }
+#endif
+
+  return dev->geo.neraseblocks * dev->blkper;
+}
+
 /****************************************************************************
  * Name: ftl_open
  *
@@ -215,7 +248,7 @@ static int ftl_open(FAR struct inode *inode)
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
-  if (dev->refs == 0)
+  if (dev->refs == 0 && !ftl_is_log(dev))
     {
       /* Allocate one, in-memory erase block buffer */
 
@@ -254,13 +287,32 @@ static int ftl_close(FAR struct inode *inode)
       if (dev->eblock)
         {
           kmm_free(dev->eblock);
+          dev->eblock = NULL;
+        }
+
+#ifdef CONFIG_FTL_LOG
+      /* The sectors written last are safe once their erase block is
+       * closed.
+       */
+
+      if (ftl_is_log(dev))
+        {
+          ftl_log_sync(dev->log);
         }
+#endif
 
       if (dev->unlinked)
         {
 #ifdef FTL_HAVE_RWBUFFER
           rwb_uninitialize(&dev->rwb);
 #endif
+#ifdef CONFIG_FTL_LOG
+          if (ftl_is_log(dev))
+            {
+              ftl_log_uninitialize(dev->log);
+            }
+#endif
+
           kmm_free(dev);
         }
     }
@@ -440,6 +492,13 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
 {
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
 
+#ifdef CONFIG_FTL_LOG
+  if (ftl_is_log(dev))
+    {
+      return ftl_log_read(dev->log, startblock, nblocks, buffer);
+    }
+#endif
+
   /* Read the full erase block into the buffer */
 
   return ftl_mtd_bread(dev, startblock, nblocks, buffer);
@@ -490,6 +549,15 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
   int    nbytes;
   int    ret;
 
+#ifdef CONFIG_FTL_LOG
+  /* The log-structured mapping never rewrites an erase block in place */
+
+  if (ftl_is_log(dev))
+    {
+      return ftl_log_write(dev->log, startblock, nblocks, buffer);
+    }
+#endif
+
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
    * alignment.
@@ -680,7 +748,7 @@ static int ftl_geometry(FAR struct inode *inode,
       geometry->geo_available     = true;
       geometry->geo_mediachanged  = false;
       geometry->geo_writeenabled  = true;
-      geometry->geo_nsectors      = dev->geo.neraseblocks * dev->blkper;
+      geometry->geo_nsectors      = ftl_nsectors(dev);
       geometry->geo_sectorsize    = dev->geo.blocksize;
 
       strlcpy(geometry->geo_model, dev->geo.model,
@@ -719,7 +787,24 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #ifdef CONFIG_FTL_WRITEBUFFER
       rwb_flush(&dev->rwb);
 #endif
+
+#ifdef CONFIG_FTL_LOG
+      if (ftl_is_log(dev))
+        {
+          ret = ftl_log_sync(dev->log);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+#endif
+    }
+#ifdef CONFIG_FTL_LOG
+  else if (cmd == BIOC_FTLSTATS && ftl_is_log(dev))
+    {
+      return ftl_log_stats(dev->log, (FAR struct ftl_stats_s *)arg);
     }
+#endif
 
   /* No other block driver ioctl commands are not recognized by this
    * driver.  Other possible MTD driver ioctl commands are passed through
@@ -756,6 +841,12 @@ static int ftl_unlink(FAR struct inode *inode)
 #ifdef FTL_HAVE_RWBUFFER
       rwb_uninitialize(&dev->rwb);
 #endif
+#ifdef CONFIG_FTL_LOG
+      if (ftl_is_log(dev))
+        {
+          ftl_log_uninitialize(dev->log);
+        }
+#endif
 
       kmm_free(dev);
     }
@@ -822,18 +913,33 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
       DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
 
+#ifdef CONFIG_FTL_LOG
+      /* Rebuild the log-structured mapping from the device */
+
+      ret = ftl_log_initialize(mtd, &dev->geo, &dev->log);
+      if (ret < 0)
+        {
+          ferr("ERROR: ftl_log_initialize failed: %d\n", ret);
+          kmm_free(dev);
+          return ret;
+        }
+#endif
+
       /* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
       dev->rwb.blocksize     = dev->geo.blocksize;
-      dev->rwb.nblocks       = dev->geo.neraseblocks * dev->blkper;
+      dev->rwb.nblocks       = ftl_nsectors(dev);
       dev->rwb.dev           = (FAR void *)dev;
       dev->rwb.wrflush       = ftl_flush;
       dev->rwb.rhreload      = ftl_reload;
 
 #if defined(CONFIG_FTL_WRITEBUFFER)
       dev->rwb.wrmaxblocks   = dev->blkper;
-      dev->rwb.wralignblocks = dev->blkper;
+
+      /* Padding to the erase block would only add writes to the log */
+
+      dev->rwb.wralignblocks = ftl_is_log(dev) ? 1 : dev->blkper;
 #endif
 
 #ifdef CONFIG_FTL_READAHEAD
@@ -844,12 +950,17 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
       if (ret < 0)
         {
           ferr("ERROR: rwb_initialize failed: %d\n", ret);
+#ifdef CONFIG_FTL_LOG
+          ftl_log_uninitialize(dev->log);
+#endif
           kmm_free(dev);
           return ret;
         }
 #endif
 
-      if (MTD_ISBAD(dev->mtd, 0) != -ENOSYS)
+      /* The log-structured mapping handles the bad blocks itself */
+
+      if (!ftl_is_log(dev) && MTD_ISBAD(dev->mtd, 0) != -ENOSYS)
         {
           ret = ftl_init_map(dev);
           if (ret < 0)
@@ -868,6 +979,9 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
 out:
 #ifdef FTL_HAVE_RWBUFFER
           rwb_uninitialize(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_LOG
+          ftl_log_uninitialize(dev->log);
 #endif
           kmm_free(dev);
         }
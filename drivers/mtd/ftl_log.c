@@ -0,0 +1,1278 @@
+/****************************************************************************
+ * drivers/mtd/ftl_log.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The log-structured mapping of the FTL.
+ *
+ * Each erase block holds blkper - 1 data pages followed by a summary page,
+ * which records the logical page held by each data page, a sequence number
+ * and the erase count of the erase block.  A sector is never rewritten in
+ * place: it is written to the next page of the open erase block and the
+ * map is updated, the previous copy becoming garbage.  The summary is
+ * written when the open erase block is full or synced, and the map is
+ * rebuilt at initialization by replaying the summaries in sequence order.
+ *
+ * The garbage collection moves the live pages out of the closed erase
+ * block with the fewest of them, and the wear leveling out of the least
+ * worn one.  A collected erase block is only reused once the pages moved
+ * out of it are covered by a summary, so that a power loss can't lose both
+ * copies.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/crc32.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mtd/mtd.h>
+
+#include "ftl_log.h"
+
+#ifdef CONFIG_FTL_LOG
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FTL_LOG_MAGIC     0x4c4c5446  /* "FTLL" */
+#define FTL_LOG_NONE      UINT32_MAX  /* No page or erase block */
+
+/* Free erase blocks left to the garbage collection by the writers, one to
+ * move the live pages to and one to replace it if it turns bad meanwhile.
+ */
+
+#define FTL_LOG_RESERVE   2
+
+/* Size of a summary describing n data pages */
+
+#define FTL_LOG_SUMMARY_SIZE(n) \
+  (offsetof(struct ftl_log_summary_s, lpn) + (n) * sizeof(uint32_t))
+
+/* The CRC covers the summary from the sequence number on */
+
+#define FTL_LOG_CRC_OFFSET offsetof(struct ftl_log_summary_s, seq)
+
+/* Collect the garbage ahead of the writers if there is a work queue */
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+#  define FTL_LOG_GCWORK 1
+#  ifdef CONFIG_SCHED_LPWORK
+#    define FTL_LOG_WORK  LPWORK
+#  else
+#    define FTL_LOG_WORK  HPWORK
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* State of an erase block */
+
+enum ftl_log_state_e
+{
+  FTL_LOG_FREE = 0,       /* No live data, erased when allocated */
+  FTL_LOG_OPEN,           /* Being written */
+  FTL_LOG_CLOSED,         /* Full or synced, its summary written */
+  FTL_LOG_PENDING,        /* Collected, free once the open block is closed */
+  FTL_LOG_BAD             /* Bad erase block */
+};
+
+/* The summary in the last page of an erase block */
+
+struct ftl_log_summary_s
+{
+  uint32_t magic;         /* FTL_LOG_MAGIC */
+  uint32_t crc;           /* CRC32 of the rest of the summary */
+  uint32_t seq;           /* Sequence number of the erase block */
+  uint32_t erases;        /* Erase count of the erase block */
+  uint32_t lpn[1];        /* Logical page held by each data page */
+};
+
+/* The in-memory state of an erase block */
+
+struct ftl_log_block_s
+{
+  uint32_t erases;        /* Erase count */
+  uint16_t valid;         /* Number of live data pages */
+  uint8_t  state;         /* See enum ftl_log_state_e */
+};
+
+/* Used to replay the summaries in sequence order */
+
+struct ftl_log_order_s
+{
+  uint32_t seq;           /* Sequence number of the erase block */
+  uint32_t blk;           /* Erase block number */
+};
+
+struct ftl_log_s
+{
+  FAR struct mtd_dev_s *mtd;    /* Contained MTD interface */
+  mutex_t  lock;                /* Protects the map */
+  uint32_t blocksize;           /* Size of a page */
+  uint16_t blkper;              /* Pages per erase block */
+  uint16_t pagesper;            /* Data pages per erase block */
+  uint32_t neblocks;            /* Number of erase blocks */
+  uint32_t nlpages;             /* Number of logical pages */
+  uint32_t nfree;               /* Number of free erase blocks */
+  uint32_t npending;            /* Number of pending erase blocks */
+  uint32_t nbad;                /* Number of bad erase blocks */
+  uint32_t seq;                 /* Sequence number of the next block */
+  uint32_t open;                /* The open erase block */
+  uint16_t next;                /* Next page of the open erase block */
+  uint8_t  erasestate;          /* Value of an erased byte */
+  bool     retiring;            /* Retiring the open erase block */
+  FAR uint32_t *l2p;            /* Physical page of each logical page */
+
+  /* State of each erase block, and the summary of the open one */
+
+  FAR struct ftl_log_block_s *blocks;
+  FAR struct ftl_log_summary_s *summary;
+
+  FAR uint8_t *buffer;          /* A summary and a page for the GC */
+  FAR uint32_t *retired;        /* Logical pages of the retired block */
+  struct ftl_stats_s stats;     /* Statistics */
+#ifdef FTL_LOG_GCWORK
+  bool     erased;              /* An erase block was erased */
+  uint32_t gcfree;              /* Free erase blocks kept by the GC */
+  struct work_s work;           /* Background garbage collection */
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void ftl_log_markbad(FAR struct ftl_log_s *log, uint32_t blk);
+static int  ftl_log_erase(FAR struct ftl_log_s *log, uint32_t blk);
+static int  ftl_log_alloc(FAR struct ftl_log_s *log);
+static void ftl_log_release(FAR struct ftl_log_s *log);
+static int  ftl_log_close(FAR struct ftl_log_s *log);
+static int  ftl_log_room(FAR struct ftl_log_s *log);
+static int  ftl_log_program(FAR struct ftl_log_s *log, uint32_t lpn,
+              size_t count, FAR const uint8_t *buffer);
+static int  ftl_log_collect(FAR struct ftl_log_s *log, uint32_t blk,
+              FAR const uint32_t *lpns);
+static int  ftl_log_retire(FAR struct ftl_log_s *log);
+static uint32_t ftl_log_victim(FAR struct ftl_log_s *log);
+static int  ftl_log_gc(FAR struct ftl_log_s *log, uint32_t victim);
+static int  ftl_log_reserve(FAR struct ftl_log_s *log);
+#ifdef FTL_LOG_GCWORK
+static uint32_t ftl_log_coldest(FAR struct ftl_log_s *log);
+static void ftl_log_worker(FAR void *arg);
+#endif
+static bool ftl_log_readsummary(FAR struct ftl_log_s *log, uint32_t blk,
+              FAR struct ftl_log_summary_s *summary);
+static int  ftl_log_compare(FAR const void *a, FAR const void *b);
+static int  ftl_log_scan(FAR struct ftl_log_s *log);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_log_markbad
+ ****************************************************************************/
+
+static void ftl_log_markbad(FAR struct ftl_log_s *log, uint32_t blk)
+{
+  MTD_MARKBAD(log->mtd, blk);
+  log->blocks[blk].state = FTL_LOG_BAD;
+  log->nbad++;
+}
+
+/****************************************************************************
+ * Name: ftl_log_erase
+ ****************************************************************************/
+
+static int ftl_log_erase(FAR struct ftl_log_s *log, uint32_t blk)
+{
+  int ret;
+
+  ret = MTD_ERASE(log->mtd, blk, 1);
+  if (ret != 1)
+    {
+      ferr("ERROR: Erase block %" PRIu32 " failed: %d\n", blk, ret);
+      ftl_log_markbad(log, blk);
+      return ret < 0 ? ret : -EIO;
+    }
+
+  log->blocks[blk].erases++;
+  log->stats.erases++;
+#ifdef FTL_LOG_GCWORK
+  log->erased = true;
+#endif
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_alloc
+ *
+ * Description:
+ *   Erase the least worn free erase block and make it the open one.
+ *
+ ****************************************************************************/
+
+static int ftl_log_alloc(FAR struct ftl_log_s *log)
+{
+  FAR struct ftl_log_summary_s *summary = log->summary;
+  uint32_t best;
+  uint32_t blk;
+
+  DEBUGASSERT(log->open == FTL_LOG_NONE);
+
+  do
+    {
+      best = FTL_LOG_NONE;
+      for (blk = 0; blk < log->neblocks; blk++)
+        {
+          if (log->blocks[blk].state == FTL_LOG_FREE &&
+              (best == FTL_LOG_NONE ||
+               log->blocks[blk].erases < log->blocks[best].erases))
+            {
+              best = blk;
+            }
+        }
+
+      if (best == FTL_LOG_NONE)
+        {
+          return -ENOSPC;
+        }
+
+      log->nfree--;
+    }
+  while (ftl_log_erase(log, best) < 0);
+
+  log->blocks[best].state = FTL_LOG_OPEN;
+  log->blocks[best].valid = 0;
+  log->open = best;
+  log->next = 0;
+
+  /* Start its summary, the unused logical pages read as FTL_LOG_NONE */
+
+  memset(summary, 0xff, log->blocksize);
+  summary->magic  = FTL_LOG_MAGIC;
+  summary->seq    = log->seq++;
+  summary->erases = log->blocks[best].erases;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_release
+ *
+ * Description:
+ *   Free the pending erase blocks, once no page moved out of them is left
+ *   in the open erase block.
+ *
+ ****************************************************************************/
+
+static void ftl_log_release(FAR struct ftl_log_s *log)
+{
+  uint32_t blk;
+
+  if (log->npending > 0)
+    {
+      for (blk = 0; blk < log->neblocks; blk++)
+        {
+          if (log->blocks[blk].state == FTL_LOG_PENDING)
+            {
+              log->blocks[blk].state = FTL_LOG_FREE;
+            }
+        }
+
+      log->nfree   += log->npending;
+      log->npending = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: ftl_log_close
+ *
+ * Description:
+ *   Write the summary of the open erase block.  The pages it covers are
+ *   safe from then on, and so are the erase blocks whose pages were moved
+ *   to it.
+ *
+ ****************************************************************************/
+
+static int ftl_log_close(FAR struct ftl_log_s *log)
+{
+  FAR struct ftl_log_summary_s *summary = log->summary;
+  uint32_t blk = log->open;
+  ssize_t nxfrd;
+
+  summary->crc = crc32((FAR const uint8_t *)summary + FTL_LOG_CRC_OFFSET,
+                       FTL_LOG_SUMMARY_SIZE(log->pagesper) -
+                       FTL_LOG_CRC_OFFSET);
+
+  nxfrd = MTD_BWRITE(log->mtd, (off_t)blk * log->blkper + log->pagesper,
+                     1, (FAR const uint8_t *)summary);
+  if (nxfrd != 1)
+    {
+      ferr("ERROR: Write summary of block %" PRIu32 " failed: %zd\n",
+           blk, nxfrd);
+      return nxfrd < 0 ? nxfrd : -EIO;
+    }
+
+  log->stats.flashwrites++;
+  log->blocks[blk].state = FTL_LOG_CLOSED;
+  log->open = FTL_LOG_NONE;
+
+  ftl_log_release(log);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_room
+ *
+ * Description:
+ *   Make sure that the open erase block has a free page, closing it and
+ *   allocating another one if it is full.  An erase block that fails to
+ *   close is retired, unless it is the one being retired.
+ *
+ ****************************************************************************/
+
+static int ftl_log_room(FAR struct ftl_log_s *log)
+{
+  int ret;
+
+  while (log->open != FTL_LOG_NONE && log->next == log->pagesper)
+    {
+      ret = ftl_log_close(log);
+      if (ret < 0)
+        {
+          if (log->retiring)
+            {
+              return ret;
+            }
+
+          ret = ftl_log_retire(log);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return log->open != FTL_LOG_NONE ? OK : ftl_log_alloc(log);
+}
+
+/****************************************************************************
+ * Name: ftl_log_program
+ *
+ * Description:
+ *   Write count consecutive logical pages from lpn to the next pages of
+ *   the open erase block, and map them there.
+ *
+ ****************************************************************************/
+
+static int ftl_log_program(FAR struct ftl_log_s *log, uint32_t lpn,
+                           size_t count, FAR const uint8_t *buffer)
+{
+  uint32_t phys;
+  uint32_t old;
+  ssize_t nxfrd;
+  size_t i;
+
+  DEBUGASSERT(log->open != FTL_LOG_NONE &&
+              log->next + count <= log->pagesper);
+
+  phys  = log->open * log->blkper + log->next;
+  nxfrd = MTD_BWRITE(log->mtd, phys, count, buffer);
+  if (nxfrd != count)
+    {
+      ferr("ERROR: Write %zu pages at %" PRIu32 " failed: %zd\n",
+           count, phys, nxfrd);
+      return nxfrd < 0 ? nxfrd : -EIO;
+    }
+
+  for (i = 0; i < count; i++, lpn++, phys++)
+    {
+      old = log->l2p[lpn];
+      if (old != FTL_LOG_NONE)
+        {
+          log->blocks[old / log->blkper].valid--;
+        }
+
+      log->l2p[lpn] = phys;
+      log->summary->lpn[log->next++] = lpn;
+    }
+
+  log->blocks[log->open].valid += count;
+  log->stats.flashwrites += count;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_collect
+ *
+ * Description:
+ *   Move the live pages of an erase block to the open one.  lpns gives the
+ *   logical page held by each of its data pages.
+ *
+ ****************************************************************************/
+
+static int ftl_log_collect(FAR struct ftl_log_s *log, uint32_t blk,
+                           FAR const uint32_t *lpns)
+{
+  FAR uint8_t *page = log->buffer + log->blocksize;
+  uint32_t phys;
+  ssize_t nxfrd;
+  uint16_t i = 0;
+  int ret;
+
+  while (i < log->pagesper && log->blocks[blk].valid > 0)
+    {
+      /* Skip the garbage */
+
+      phys = blk * log->blkper + i;
+      if (lpns[i] >= log->nlpages || log->l2p[lpns[i]] != phys)
+        {
+          i++;
+          continue;
+        }
+
+      nxfrd = MTD_BREAD(log->mtd, phys, 1, page);
+      if (nxfrd != 1 && nxfrd != -EUCLEAN)
+        {
+          ferr("ERROR: Read page %" PRIu32 " failed: %zd\n", phys, nxfrd);
+          return -EIO;
+        }
+
+      ret = ftl_log_room(log);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = ftl_log_program(log, lpns[i], 1, page);
+      if (ret < 0)
+        {
+          /* Retire the open erase block and move the page again, it was
+           * overwritten meanwhile.
+           */
+
+          if (log->retiring)
+            {
+              return ret;
+            }
+
+          ret = ftl_log_retire(log);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          continue;
+        }
+
+      log->stats.gcmoves++;
+      i++;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_retire
+ *
+ * Description:
+ *   Mark the open erase block bad after a write to it failed, and move its
+ *   live pages to another one.
+ *
+ ****************************************************************************/
+
+static int ftl_log_retire(FAR struct ftl_log_s *log)
+{
+  uint32_t blk = log->open;
+  int ret;
+
+  DEBUGASSERT(!log->retiring);
+
+  memcpy(log->retired, log->summary->lpn,
+         log->pagesper * sizeof(uint32_t));
+  log->open = FTL_LOG_NONE;
+  ftl_log_markbad(log, blk);
+
+  log->retiring = true;
+  ret = ftl_log_collect(log, blk, log->retired);
+  log->retiring = false;
+
+  /* Nothing was left to move, so nothing is unsummarized either */
+
+  if (ret >= 0 && log->open == FTL_LOG_NONE)
+    {
+      ftl_log_release(log);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_victim
+ *
+ * Description:
+ *   Return the closed erase block with the fewest live pages, the least
+ *   worn one among equals, or FTL_LOG_NONE if every one is full.
+ *
+ ****************************************************************************/
+
+static uint32_t ftl_log_victim(FAR struct ftl_log_s *log)
+{
+  FAR struct ftl_log_block_s *block;
+  FAR struct ftl_log_block_s *best = NULL;
+  uint32_t victim = FTL_LOG_NONE;
+  uint32_t blk;
+
+  for (blk = 0; blk < log->neblocks; blk++)
+    {
+      block = &log->blocks[blk];
+      if (block->state == FTL_LOG_CLOSED && block->valid < log->pagesper &&
+          (best == NULL || block->valid < best->valid ||
+           (block->valid == best->valid && block->erases < best->erases)))
+        {
+          best   = block;
+          victim = blk;
+        }
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Name: ftl_log_gc
+ *
+ * Description:
+ *   Move the live pages out of the victim erase block.  The victim is
+ *   reused after the open erase block is closed, or at once if there is
+ *   none.
+ *
+ ****************************************************************************/
+
+static int ftl_log_gc(FAR struct ftl_log_s *log, uint32_t victim)
+{
+  FAR struct ftl_log_summary_s *summary =
+    (FAR struct ftl_log_summary_s *)log->buffer;
+  int ret;
+
+  DEBUGASSERT(log->blocks[victim].state == FTL_LOG_CLOSED);
+
+  if (log->blocks[victim].valid > 0)
+    {
+      if (!ftl_log_readsummary(log, victim, summary))
+        {
+          return -EIO;
+        }
+
+      ret = ftl_log_collect(log, victim, summary->lpn);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (log->open == FTL_LOG_NONE)
+    {
+      log->blocks[victim].state = FTL_LOG_FREE;
+      log->nfree++;
+    }
+  else
+    {
+      log->blocks[victim].state = FTL_LOG_PENDING;
+      log->npending++;
+    }
+
+  log->stats.gcblocks++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftl_log_reserve
+ *
+ * Description:
+ *   Make sure that the open erase block has a free page for the writer.
+ *   The garbage is collected first while no more than FTL_LOG_RESERVE
+ *   erase blocks are free or about to be, those are kept for the garbage
+ *   collection itself.
+ *
+ ****************************************************************************/
+
+static int ftl_log_reserve(FAR struct ftl_log_s *log)
+{
+  uint32_t victim;
+  int ret;
+
+  for (; ; )
+    {
+      if (log->open != FTL_LOG_NONE && log->next == log->pagesper)
+        {
+          ret = ftl_log_close(log);
+          if (ret < 0)
+            {
+              ret = ftl_log_retire(log);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+
+          continue;
+        }
+
+      if (log->nfree + log->npending <= FTL_LOG_RESERVE)
+        {
+          victim = ftl_log_victim(log);
+          if (victim != FTL_LOG_NONE)
+            {
+              ret = ftl_log_gc(log, victim);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              continue;
+            }
+        }
+
+      return log->open != FTL_LOG_NONE ? OK : ftl_log_alloc(log);
+    }
+}
+
+/****************************************************************************
+ * Name: ftl_log_coldest
+ *
+ * Description:
+ *   Return the least worn closed erase block if it lags behind the most
+ *   worn erase block by more than CONFIG_FTL_LOG_WEAR_DELTA erases.  Its
+ *   data is rarely written, moving it lets the erase block take its share
+ *   of the writes.
+ *
+ ****************************************************************************/
+
+#ifdef FTL_LOG_GCWORK
+static uint32_t ftl_log_coldest(FAR struct ftl_log_s *log)
+{
+  FAR struct ftl_log_block_s *block;
+  uint32_t coldest = FTL_LOG_NONE;
+  uint32_t maxerases = 0;
+  uint32_t blk;
+
+  for (blk = 0; blk < log->neblocks; blk++)
+    {
+      block = &log->blocks[blk];
+      if (block->state == FTL_LOG_BAD)
+        {
+          continue;
+        }
+
+      maxerases = MAX(maxerases, block->erases);
+      if (block->state == FTL_LOG_CLOSED &&
+          (coldest == FTL_LOG_NONE ||
+           block->erases < log->blocks[coldest].erases))
+        {
+          coldest = blk;
+        }
+    }
+
+  if (coldest != FTL_LOG_NONE &&
+      maxerases - log->blocks[coldest].erases > CONFIG_FTL_LOG_WEAR_DELTA)
+    {
+      return coldest;
+    }
+
+  return FTL_LOG_NONE;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_worker
+ *
+ * Description:
+ *   Collect the garbage until gcfree erase blocks beyond the reserve are
+ *   free or about to be, then level the wear.
+ *
+ ****************************************************************************/
+
+#ifdef FTL_LOG_GCWORK
+static void ftl_log_worker(FAR void *arg)
+{
+  FAR struct ftl_log_s *log = arg;
+  uint32_t victim;
+
+  if (nxmutex_lock(&log->lock) < 0)
+    {
+      return;
+    }
+
+  while (log->nfree + log->npending < FTL_LOG_RESERVE + log->gcfree)
+    {
+      victim = ftl_log_victim(log);
+      if (victim == FTL_LOG_NONE || ftl_log_gc(log, victim) < 0)
+        {
+          break;
+        }
+    }
+
+  if (log->erased && log->nfree >= FTL_LOG_RESERVE)
+    {
+      log->erased = false;
+      victim = ftl_log_coldest(log);
+      if (victim != FTL_LOG_NONE)
+        {
+          ftl_log_gc(log, victim);
+        }
+    }
+
+  nxmutex_unlock(&log->lock);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_readsummary
+ *
+ * Description:
+ *   Read the summary of an erase block and return true if it is valid.
+ *
+ ****************************************************************************/
+
+static bool ftl_log_readsummary(FAR struct ftl_log_s *log, uint32_t blk,
+                                FAR struct ftl_log_summary_s *summary)
+{
+  ssize_t nxfrd;
+
+  nxfrd = MTD_BREAD(log->mtd, (off_t)blk * log->blkper + log->pagesper, 1,
+                    (FAR uint8_t *)summary);
+  if (nxfrd != 1 && nxfrd != -EUCLEAN)
+    {
+      return false;
+    }
+
+  return summary->magic == FTL_LOG_MAGIC &&
+         summary->crc == crc32((FAR const uint8_t *)summary +
+                               FTL_LOG_CRC_OFFSET,
+                               FTL_LOG_SUMMARY_SIZE(log->pagesper) -
+                               FTL_LOG_CRC_OFFSET);
+}
+
+/****************************************************************************
+ * Name: ftl_log_compare
+ ****************************************************************************/
+
+static int ftl_log_compare(FAR const void *a, FAR const void *b)
+{
+  uint32_t seqa = ((FAR const struct ftl_log_order_s *)a)->seq;
+  uint32_t seqb = ((FAR const struct ftl_log_order_s *)b)->seq;
+
+  return seqa < seqb ? -1 : seqa > seqb;
+}
+
+/****************************************************************************
+ * Name: ftl_log_scan
+ *
+ * Description:
+ *   Rebuild the map from the summaries of the erase blocks.  An erase
+ *   block without a valid summary was free, or open when the power was
+ *   lost, and is free now.  Replaying the summaries in sequence order lets
+ *   the latest copy of each logical page win.
+ *
+ ****************************************************************************/
+
+static int ftl_log_scan(FAR struct ftl_log_s *log)
+{
+  FAR struct ftl_log_summary_s *summary =
+    (FAR struct ftl_log_summary_s *)log->buffer;
+  FAR struct ftl_log_order_s *order;
+  FAR struct ftl_log_block_s *block;
+  uint32_t minerases = UINT32_MAX;
+  uint32_t nclosed = 0;
+  uint32_t lpn;
+  uint32_t blk;
+  uint32_t i;
+  uint16_t j;
+
+  order = kmm_malloc(log->neblocks * sizeof(struct ftl_log_order_s));
+  if (order == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (blk = 0; blk < log->neblocks; blk++)
+    {
+      block = &log->blocks[blk];
+      if (MTD_ISBAD(log->mtd, blk) > 0)
+        {
+          block->state = FTL_LOG_BAD;
+          log->nbad++;
+        }
+      else if (ftl_log_readsummary(log, blk, summary))
+        {
+          block->state  = FTL_LOG_CLOSED;
+          block->erases = summary->erases;
+          minerases     = MIN(minerases, summary->erases);
+
+          order[nclosed].seq   = summary->seq;
+          order[nclosed++].blk = blk;
+
+          if (summary->seq >= log->seq)
+            {
+              log->seq = summary->seq + 1;
+            }
+        }
+      else
+        {
+          block->state = FTL_LOG_FREE;
+        }
+    }
+
+  /* The erase count of a free erase block is lost, assume the lowest */
+
+  for (blk = 0; blk < log->neblocks; blk++)
+    {
+      if (log->blocks[blk].state == FTL_LOG_FREE)
+        {
+          log->blocks[blk].erases = minerases != UINT32_MAX ? minerases : 0;
+        }
+    }
+
+  qsort(order, nclosed, sizeof(struct ftl_log_order_s), ftl_log_compare);
+
+  for (i = 0; i < nclosed; i++)
+    {
+      blk = order[i].blk;
+      if (!ftl_log_readsummary(log, blk, summary))
+        {
+          kmm_free(order);
+          return -EIO;
+        }
+
+      for (j = 0; j < log->pagesper; j++)
+        {
+          lpn = summary->lpn[j];
+          if (lpn < log->nlpages)
+            {
+              log->l2p[lpn] = blk * log->blkper + j;
+            }
+        }
+    }
+
+  kmm_free(order);
+
+  /* Count the live pages, the erase blocks left without any are free */
+
+  for (lpn = 0; lpn < log->nlpages; lpn++)
+    {
+      if (log->l2p[lpn] != FTL_LOG_NONE)
+        {
+          log->blocks[log->l2p[lpn] / log->blkper].valid++;
+        }
+    }
+
+  for (blk = 0; blk < log->neblocks; blk++)
+    {
+      block = &log->blocks[blk];
+      if (block->state == FTL_LOG_CLOSED && block->valid == 0)
+        {
+          block->state = FTL_LOG_FREE;
+        }
+
+      if (block->state == FTL_LOG_FREE)
+        {
+          log->nfree++;
+        }
+    }
+
+  finfo("%" PRIu32 " closed, %" PRIu32 " free, %" PRIu32 " bad blocks\n",
+        nclosed, log->nfree, log->nbad);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftl_log_initialize
+ *
+ * Description:
+ *   Scan the MTD device and rebuild the logical to physical page map from
+ *   the summaries of its erase blocks.
+ *
+ ****************************************************************************/
+
+int ftl_log_initialize(FAR struct mtd_dev_s *mtd,
+                       FAR const struct mtd_geometry_s *geo,
+                       FAR struct ftl_log_s **log)
+{
+  FAR struct ftl_log_s *priv;
+  uint32_t blkper;
+  uint32_t nspare;
+  int ret = -ENOMEM;
+
+  /* The summary of the data pages must fit in the last page */
+
+  blkper = geo->erasesize / geo->blocksize;
+  if (blkper < 2 || blkper > UINT16_MAX ||
+      FTL_LOG_SUMMARY_SIZE(blkper - 1) > geo->blocksize)
+    {
+      ferr("ERROR: Unsupported geometry %" PRIu32 "/%" PRIu32 "\n",
+           geo->blocksize, geo->erasesize);
+      return -EINVAL;
+    }
+
+  /* Keep some erase blocks spare for the garbage collection and the bad
+   * blocks.
+   */
+
+  nspare = MAX(geo->neraseblocks * CONFIG_FTL_LOG_SPARE / 100, 3);
+  if (geo->neraseblocks <= nspare)
+    {
+      ferr("ERROR: Too few erase blocks: %" PRIu32 "\n", geo->neraseblocks);
+      return -EINVAL;
+    }
+
+  priv = kmm_zalloc(sizeof(struct ftl_log_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  priv->mtd       = mtd;
+  priv->blocksize = geo->blocksize;
+  priv->blkper    = blkper;
+  priv->pagesper  = blkper - 1;
+  priv->neblocks  = geo->neraseblocks;
+  priv->nlpages   = (geo->neraseblocks - nspare) * (blkper - 1);
+  priv->open      = FTL_LOG_NONE;
+#ifdef FTL_LOG_GCWORK
+  priv->gcfree    = MIN(CONFIG_FTL_LOG_GC_BLOCKS,
+                        (nspare - FTL_LOG_RESERVE) / 2);
+#endif
+
+  if (MTD_IOCTL(mtd, MTDIOC_ERASESTATE,
+                (unsigned long)((uintptr_t)&priv->erasestate)) < 0)
+    {
+      priv->erasestate = 0xff;
+    }
+
+  priv->l2p     = kmm_malloc(priv->nlpages * sizeof(uint32_t));
+  priv->blocks  = kmm_zalloc(priv->neblocks *
+                             sizeof(struct ftl_log_block_s));
+  priv->summary = kmm_malloc(priv->blocksize);
+  priv->buffer  = kmm_malloc(2 * priv->blocksize);
+  priv->retired = kmm_malloc(priv->pagesper * sizeof(uint32_t));
+  if (priv->l2p == NULL || priv->blocks == NULL ||
+      priv->summary == NULL || priv->buffer == NULL ||
+      priv->retired == NULL)
+    {
+      goto errout;
+    }
+
+  memset(priv->l2p, 0xff, priv->nlpages * sizeof(uint32_t));
+  nxmutex_init(&priv->lock);
+
+  ret = ftl_log_scan(priv);
+  if (ret < 0)
+    {
+      nxmutex_destroy(&priv->lock);
+      goto errout;
+    }
+
+  *log = priv;
+  return OK;
+
+errout:
+  kmm_free(priv->l2p);
+  kmm_free(priv->blocks);
+  kmm_free(priv->summary);
+  kmm_free(priv->buffer);
+  kmm_free(priv->retired);
+  kmm_free(priv);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_uninitialize
+ ****************************************************************************/
+
+void ftl_log_uninitialize(FAR struct ftl_log_s *log)
+{
+#ifdef FTL_LOG_GCWORK
+  work_cancel_sync(FTL_LOG_WORK, &log->work);
+#endif
+
+  nxmutex_destroy(&log->lock);
+  kmm_free(log->l2p);
+  kmm_free(log->blocks);
+  kmm_free(log->summary);
+  kmm_free(log->buffer);
+  kmm_free(log->retired);
+  kmm_free(log);
+}
+
+/****************************************************************************
+ * Name: ftl_log_nsectors
+ ****************************************************************************/
+
+blkcnt_t ftl_log_nsectors(FAR struct ftl_log_s *log)
+{
+  return log->nlpages;
+}
+
+/****************************************************************************
+ * Name: ftl_log_read
+ *
+ * Description:
+ *   Read logical pages, a run of them written together in one MTD read.
+ *   The logical pages never written read as erased.
+ *
+ ****************************************************************************/
+
+ssize_t ftl_log_read(FAR struct ftl_log_s *log, off_t startblock,
+                     size_t nblocks, FAR uint8_t *buffer)
+{
+  size_t remaining;
+  uint32_t phys;
+  size_t count;
+  ssize_t nxfrd;
+  int ret;
+
+  if (startblock < 0 || startblock >= log->nlpages)
+    {
+      return -EINVAL;
+    }
+
+  nblocks   = MIN(nblocks, log->nlpages - startblock);
+  remaining = nblocks;
+
+  ret = nxmutex_lock(&log->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (remaining > 0)
+    {
+      phys = log->l2p[startblock];
+      if (phys == FTL_LOG_NONE)
+        {
+          count = 1;
+          memset(buffer, log->erasestate, log->blocksize);
+        }
+      else
+        {
+          count = 1;
+          while (count < remaining &&
+                 log->l2p[startblock + count] == phys + count)
+            {
+              count++;
+            }
+
+          nxfrd = MTD_BREAD(log->mtd, phys, count, buffer);
+          if (nxfrd != count && nxfrd != -EUCLEAN)
+            {
+              ferr("ERROR: Read %zu pages at %" PRIu32 " failed: %zd\n",
+                   count, phys, nxfrd);
+              ret = nxfrd < 0 ? nxfrd : -EIO;
+              break;
+            }
+        }
+
+      startblock += count;
+      remaining  -= count;
+      buffer     += count * log->blocksize;
+    }
+
+  nxmutex_unlock(&log->lock);
+  return remaining < nblocks ? nblocks - remaining : ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_write
+ *
+ * Description:
+ *   Write logical pages to the open erase block, a run of them in one MTD
+ *   write.
+ *
+ ****************************************************************************/
+
+ssize_t ftl_log_write(FAR struct ftl_log_s *log, off_t startblock,
+                      size_t nblocks, FAR const uint8_t *buffer)
+{
+  size_t remaining = nblocks;
+  size_t count;
+  int ret;
+
+  if (startblock < 0 || startblock + nblocks > log->nlpages)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&log->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (remaining > 0)
+    {
+      ret = ftl_log_reserve(log);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      count = MIN(remaining, log->pagesper - log->next);
+      ret   = ftl_log_program(log, startblock, count, buffer);
+      if (ret < 0)
+        {
+          /* Give up on the erase block and retry in another one */
+
+          ret = ftl_log_retire(log);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      log->stats.hostwrites += count;
+      startblock += count;
+      remaining  -= count;
+      buffer     += count * log->blocksize;
+    }
+
+#ifdef FTL_LOG_GCWORK
+  if ((log->nfree + log->npending < FTL_LOG_RESERVE + log->gcfree ||
+       log->erased) && work_available(&log->work))
+    {
+      work_queue(FTL_LOG_WORK, &log->work, ftl_log_worker, log, 0);
+    }
+#endif
+
+  nxmutex_unlock(&log->lock);
+  return remaining < nblocks ? nblocks - remaining : ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_sync
+ *
+ * Description:
+ *   Close the open erase block if it holds any page, its free pages are
+ *   lost until it is collected.  Fails if a retired erase block still
+ *   holds live pages.
+ *
+ ****************************************************************************/
+
+int ftl_log_sync(FAR struct ftl_log_s *log)
+{
+  uint32_t blk;
+  int ret;
+
+  ret = nxmutex_lock(&log->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (ret >= 0 && log->open != FTL_LOG_NONE && log->next > 0)
+    {
+      ret = ftl_log_close(log);
+      if (ret < 0)
+        {
+          ret = ftl_log_retire(log);
+        }
+    }
+
+  /* Live pages left in a retired erase block won't be found again */
+
+  for (blk = 0; ret >= 0 && blk < log->neblocks; blk++)
+    {
+      if (log->blocks[blk].state == FTL_LOG_BAD &&
+          log->blocks[blk].valid > 0)
+        {
+          ret = -EIO;
+        }
+    }
+
+  nxmutex_unlock(&log->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftl_log_stats
+ ****************************************************************************/
+
+int ftl_log_stats(FAR struct ftl_log_s *log, FAR struct ftl_stats_s *stats)
+{
+  FAR struct ftl_log_block_s *block;
+  uint64_t total = 0;
+  uint32_t ngood = 0;
+  uint32_t blk;
+  int ret;
+
+  ret = nxmutex_lock(&log->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *stats = log->stats;
+  stats->minerases = UINT32_MAX;
+  stats->maxerases = 0;
+
+  for (blk = 0; blk < log->neblocks; blk++)
+    {
+      block = &log->blocks[blk];
+      if (block->state != FTL_LOG_BAD)
+        {
+          stats->minerases = MIN(stats->minerases, block->erases);
+          stats->maxerases = MAX(stats->maxerases, block->erases);
+          total += block->erases;
+          ngood++;
+        }
+    }
+
+  stats->avgerases  = ngood > 0 ? total / ngood : 0;
+  stats->freeblocks = log->nfree + log->npending;
+  stats->badblocks  = log->nbad;
+
+  nxmutex_unlock(&log->lock);
+  return OK;
+}
+
+#endif /* CONFIG_FTL_LOG */
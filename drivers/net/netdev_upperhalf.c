@@ -30,14 +30,19 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/ethtool.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/can.h>
+#include <nuttx/net/ioctl.h>
+#include <nuttx/net/ip.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/signal.h>
 #include <nuttx/spinlock.h>
 
 /****************************************************************************
@@ -60,6 +65,29 @@
 #  define NETDEV_THREAD_COUNT 1
 #endif
 
+#ifndef CONFIG_NETDEV_RX_BUDGET
+#  define CONFIG_NETDEV_RX_BUDGET 0
+#endif
+
+#ifndef CONFIG_NETDEV_RX_COALESCE_USECS
+#  define CONFIG_NETDEV_RX_COALESCE_USECS 0
+#endif
+
+/* The minimum bytes needed in the first buffer to get the flow of IPv4 and
+ * IPv6 packets (fixed IP header plus the TCP/UDP ports).
+ */
+
+#define NETDEV_FLOW_IPv4LEN  24
+#define NETDEV_FLOW_IPv6LEN  44
+
+/* The queue (thread) woken up by the notifications from the lower half */
+
+#ifdef CONFIG_NETDEV_RSS
+#  define NETDEV_THIS_QUEUE this_cpu()
+#else
+#  define NETDEV_THIS_QUEUE 0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -76,17 +104,55 @@ struct netdev_upperhalf_s
   pid_t tid[NETDEV_THREAD_COUNT];
   sem_t sem[NETDEV_THREAD_COUNT];
   sem_t sem_exit[NETDEV_THREAD_COUNT];
+
+  /* Set by the RX notification to delay the next poll by 'coalesce' */
+
+  bool rxdelay[NETDEV_THREAD_COUNT];
 #else
   struct work_s work;
 #endif
 
+  /* Interrupt mitigation: at most 'budget' packets are received in one
+   * poll (0 for no limit), the device is polled again later if there are
+   * more.  The poll after an RX interrupt is delayed by 'coalesce'
+   * microseconds to receive more packets in one batch.
+   */
+
+  uint32_t budget;
+  uint32_t coalesce;
+
   /* TX queue for re-queueing replies */
 
 #if CONFIG_IOB_NCHAINS > 0
   struct iob_queue_s txq;
 #endif
+
+#ifdef CONFIG_NETDEV_RSS
+  /* The queue (CPU) served by the poll in progress, the TX packets go to
+   * the hardware queue of the same index.
+   */
+
+  int queue;
+#endif
+
+#ifdef CONFIG_NETDEV_RPS
+  /* Packets steered to each CPU, and the CPU + 1 of the flows reported
+   * by SIOCNOTIFYRECVCPU, indexed by the flow hash.
+   */
+
+  struct iob_queue_s backlog[NETDEV_THREAD_COUNT];
+  uint8_t rfs[CONFIG_NETDEV_RFS_ENTRIES];
+#endif
 };
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifndef CONFIG_NETDEV_WORK_THREAD
+static void netdev_upper_work(FAR void *arg);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -215,12 +281,66 @@ netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev)
       return NULL;
     }
 
-  upper->lower = dev;
+  upper->lower    = dev;
+  upper->budget   = CONFIG_NETDEV_RX_BUDGET;
+  upper->coalesce = CONFIG_NETDEV_RX_COALESCE_USECS;
   dev->netdev.d_private = upper;
 
   return upper;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_wakeup
+ *
+ * Description:
+ *   Wake up the work thread of the specified CPU.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_WORK_THREAD
+static void netdev_upper_wakeup(FAR struct netdev_upperhalf_s *upper,
+                                int cpu)
+{
+  int semcount;
+
+  if (nxsem_get_value(&upper->sem[cpu], &semcount) == OK &&
+      semcount <= 0)
+    {
+      nxsem_post(&upper->sem[cpu]);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_schedule
+ *
+ * Description:
+ *   Schedule a poll of the device on the work thread of the specified CPU
+ *   (or the work queue), after the specified delay in microseconds.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_schedule(FAR struct netdev_upperhalf_s *upper,
+                                  int cpu, uint32_t delay)
+{
+#ifdef CONFIG_NETDEV_WORK_THREAD
+  if (delay > 0)
+    {
+      upper->rxdelay[cpu] = true;
+    }
+
+  netdev_upper_wakeup(upper, cpu);
+#else
+  if (work_available(&upper->work))
+    {
+      /* Schedule to serialize the poll on the worker thread. */
+
+      work_queue(NETDEV_WORK, &upper->work, netdev_upper_work, upper,
+                 USEC2TICK(delay));
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: netdev_upper_can_tx
  *
@@ -295,6 +415,13 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
     }
+#ifdef CONFIG_NETDEV_RSS
+  else if (lower->txqueues > 1)
+    {
+      ret = lower->ops->transmit_queue(lower, pkt,
+                                       upper->queue % lower->txqueues);
+    }
+#endif
   else
     {
       ret = lower->ops->transmit(lower, pkt);
@@ -311,6 +438,7 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
       return ret;
     }
 
+  NETDEV_QUEUE_TXPACKETS(dev, upper->queue);
   return NETDEV_TX_CONTINUE;
 }
 
@@ -582,105 +710,357 @@ static void ip_input(FAR struct net_driver_s *dev)
 #endif
 
 /****************************************************************************
- * Function: netdev_upper_rxpoll_work
+ * Function: netdev_upper_input
  *
  * Description:
- *   Try to receive packets from device and pass packets into IP
- *   stack and send packets which is from IP stack if necessary.
+ *   Pass one received packet into the network stack.
  *
  * Input Parameters:
  *   upper - Reference to the upper half driver structure
+ *   pkt   - The received packet
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static void netdev_upper_input(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt)
 {
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR struct net_driver_s       *dev   = &lower->netdev;
-  FAR netpkt_t                  *pkt;
-
-  /* Loop while receive() successfully retrieves valid Ethernet frames. */
 
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  if (!IFF_IS_UP(dev->d_flags))
     {
-      if (!IFF_IS_UP(dev->d_flags))
-        {
-          /* Interface down, drop frame */
+      /* Interface down, drop frame */
 
-          NETDEV_RXDROPPED(dev);
-          netpkt_free(lower, pkt, NETPKT_RX);
-          continue;
-        }
+      NETDEV_RXDROPPED(dev);
+      netpkt_free(lower, pkt, NETPKT_RX);
+      return;
+    }
 
-      netpkt_put(dev, pkt, NETPKT_RX);
-      NETDEV_RXPACKETS(dev);
+  netpkt_put(dev, pkt, NETPKT_RX);
+  NETDEV_RXPACKETS(dev);
 
 #ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
+  /* When packet sockets are enabled, feed the frame into the tap */
 
-      pkt_input(dev);
+  pkt_input(dev);
 #endif
 
-      switch (dev->d_lltype)
-        {
+  switch (dev->d_lltype)
+    {
 #ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
+    case NET_LL_LOOPBACK:
 #endif
 #ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
+    case NET_LL_ETHERNET:
 #endif
 #ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
+    case NET_LL_IEEE80211:
 #endif
 #if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
     defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
+      eth_input(dev);
+      break;
 #endif
 #ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
+    case NET_LL_MBIM:
+      ip_input(dev);
+      break;
 #endif
 #ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
-#endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
+#endif
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
+    }
+}
+
+/****************************************************************************
+ * Function: netdev_upper_receive
+ *
+ * Description:
+ *   Receive a packet from the hardware queue served by the current poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static FAR netpkt_t *
+netdev_upper_receive(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+
+#ifdef CONFIG_NETDEV_RSS
+  if (lower->rxqueues > 1)
+    {
+      if (upper->queue >= lower->rxqueues)
+        {
+          return NULL;
         }
+
+      return lower->ops->receive_queue(lower, upper->queue);
     }
+#endif
+
+  return lower->ops->receive(lower);
 }
 
 /****************************************************************************
- * Name: netdev_upper_work
+ * Function: netdev_upper_steer
  *
  * Description:
- *   Perform an out-of-cycle poll on a dedicated thread or the worker thread.
+ *   Receive Packet Steering (RPS) for the single queue devices: compute the
+ *   flow hash of the packet and move it to the backlog of the CPU that
+ *   consumes the flow (as reported by SIOCNOTIFYRECVCPU), or of a CPU
+ *   selected by the hash.
  *
  * Input Parameters:
- *   arg - Reference to the upper half driver structure (cast to void *)
+ *   upper - Reference to the upper half driver structure
+ *   pkt   - The received packet
+ *
+ * Returned Value:
+ *   true if the packet was steered to another CPU, false if it should be
+ *   processed by the current poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_work(FAR void *arg)
+#ifdef CONFIG_NETDEV_RPS
+static bool netdev_upper_steer(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt)
 {
-  FAR struct netdev_upperhalf_s *upper = arg;
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s       *dev   = &lower->netdev;
+  FAR const uint8_t             *data;
+  uint32_t                       src[4];
+  uint32_t                       dst[4];
+  uint16_t                       sport = 0;
+  uint16_t                       dport = 0;
+  uint32_t                       hash;
+  unsigned int                   len;
+  unsigned int                   hl;
+  uint8_t                        domain;
+  uint8_t                        proto;
+  int                            cpu;
+
+  data = netpkt_getdata(lower, pkt);
+  len  = pkt->io_len;
+
+  switch (dev->d_lltype)
+    {
+#ifdef CONFIG_NET_ETHERNET
+      case NET_LL_ETHERNET:
+        if (len < ETH_HDRLEN)
+          {
+            return false;
+          }
 
-  /* RX may release quota and driver buffer, so do RX first. */
+        data += ETH_HDRLEN;
+        len  -= ETH_HDRLEN;
+        break;
+#endif
+#ifdef CONFIG_NET_MBIM
+      case NET_LL_MBIM:
+        break;
+#endif
+      default:
+        return false;
+    }
+
+  if (len >= NETDEV_FLOW_IPv4LEN && (data[0] >> 4) == 4)
+    {
+      domain = PF_INET;
+      hl     = (data[0] & 0x0f) << 2;
+      proto  = data[9];
+      memcpy(src, &data[12], 4);
+      memcpy(dst, &data[16], 4);
+
+      /* The fragments carry no ports, hash them by address only */
+
+      if ((data[6] & 0x3f) != 0 || data[7] != 0)
+        {
+          proto = 0;
+        }
+    }
+  else if (len >= NETDEV_FLOW_IPv6LEN && (data[0] >> 4) == 6)
+    {
+      domain = PF_INET6;
+      hl     = IPv6_HDRLEN;
+      proto  = data[6];
+      memcpy(src, &data[8], 16);
+      memcpy(dst, &data[24], 16);
+    }
+  else
+    {
+      return false;
+    }
+
+  if ((proto == IP_PROTO_TCP || proto == IP_PROTO_UDP) && len >= hl + 4)
+    {
+      memcpy(&sport, &data[hl], 2);
+      memcpy(&dport, &data[hl + 2], 2);
+    }
+
+  /* The local address and port come first, the same as the hash reported
+   * by netdev_notify_recvcpu().
+   */
+
+  hash = netdev_flowhash(domain, dst, dport, src, sport);
+  cpu  = upper->rfs[hash % CONFIG_NETDEV_RFS_ENTRIES];
+  cpu  = cpu > 0 ? cpu - 1 : hash % NETDEV_THREAD_COUNT;
+
+  if (cpu == upper->queue ||
+      iob_tryadd_queue(pkt, &upper->backlog[cpu]) < 0)
+    {
+      return false;
+    }
+
+  NETDEV_QUEUE_RXSTEERED(dev, upper->queue);
+  netdev_upper_wakeup(upper, cpu);
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Function: netdev_upper_rxpoll_work
+ *
+ * Description:
+ *   Try to receive packets from device and pass packets into IP
+ *   stack and send packets which is from IP stack if necessary.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *
+ * Returned Value:
+ *   true if the RX budget is exhausted and the device should be polled
+ *   again, false if there are no more packets.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR netpkt_t *pkt;
+  uint32_t budget = upper->budget;
+
+#ifdef CONFIG_NETDEV_RPS
+  /* Process the packets steered to this CPU first */
+
+  while ((pkt = iob_remove_queue(&upper->backlog[upper->queue])) != NULL)
+    {
+      NETDEV_QUEUE_RXPACKETS(&upper->lower->netdev, upper->queue);
+      netdev_upper_input(upper, pkt);
+
+      if (budget > 0 && --budget == 0)
+        {
+          return true;
+        }
+    }
+#endif
+
+  /* Loop while receive() successfully retrieves valid Ethernet frames. */
+
+  while ((pkt = netdev_upper_receive(upper)) != NULL)
+    {
+#ifdef CONFIG_NETDEV_RPS
+      if (upper->lower->rxqueues <= 1 && netdev_upper_steer(upper, pkt))
+        {
+          pkt = NULL;
+        }
+#endif
+
+      if (pkt != NULL)
+        {
+          NETDEV_QUEUE_RXPACKETS(&upper->lower->netdev, upper->queue);
+          netdev_upper_input(upper, pkt);
+        }
+
+      /* Leave the remaining packets to the next poll when the budget is
+       * used up, the lower half keeps its RX interrupt disabled until
+       * receive() has drained the device.
+       */
+
+      if (budget > 0 && --budget == 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_work_queue
+ *
+ * Description:
+ *   Poll the device on behalf of the specified queue (CPU): reap the TX
+ *   completions in bulk, receive a batch of packets and then send.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   queue - The queue served by the caller
+ *
+ ****************************************************************************/
+
+static void netdev_upper_work_queue(FAR struct netdev_upperhalf_s *upper,
+                                    int queue)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  bool more;
 
   net_lock();
-  netdev_upper_rxpoll_work(upper);
+#ifdef CONFIG_NETDEV_RSS
+  upper->queue = queue;
+#endif
+
+  if (lower->ops->reclaim)
+    {
+      lower->ops->reclaim(lower);
+    }
+
+  /* RX may release quota and driver buffer, so do RX first. */
+
+  more = netdev_upper_rxpoll_work(upper);
   netdev_upper_txavail_work(upper);
   net_unlock();
+
+  /* Poll again after others had a chance to run if the budget is used up */
+
+  if (more)
+    {
+      netdev_upper_schedule(upper, queue, 0);
+    }
 }
 
+/****************************************************************************
+ * Name: netdev_upper_work
+ *
+ * Description:
+ *   Perform an out-of-cycle poll on the worker thread.
+ *
+ * Input Parameters:
+ *   arg - Reference to the upper half driver structure (cast to void *)
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NETDEV_WORK_THREAD
+static void netdev_upper_work(FAR void *arg)
+{
+  netdev_upper_work_queue(arg, 0);
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_upper_wait
  *
@@ -727,7 +1107,15 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
   while (netdev_upper_wait(&upper->sem[cpu]) == OK &&
          upper->tid[cpu] != INVALID_PROCESS_ID)
     {
-      netdev_upper_work(upper);
+      if (upper->rxdelay[cpu])
+        {
+          /* Let more packets arrive to be received in one batch */
+
+          upper->rxdelay[cpu] = false;
+          nxsig_usleep(upper->coalesce);
+        }
+
+      netdev_upper_work_queue(upper, cpu);
     }
 
   nwarn("WARNING: Netdev work thread quitting.");
@@ -749,29 +1137,7 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
 
 static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
 {
-  FAR struct netdev_upperhalf_s *upper = dev->d_private;
-
-#ifdef CONFIG_NETDEV_WORK_THREAD
-#  ifdef CONFIG_NETDEV_RSS
-  int cpu = this_cpu();
-#  else
-  const int cpu = 0;
-#  endif
-  int semcount;
-
-  if (nxsem_get_value(&upper->sem[cpu], &semcount) == OK &&
-      semcount <= 0)
-    {
-      nxsem_post(&upper->sem[cpu]);
-    }
-#else
-  if (work_available(&upper->work))
-    {
-      /* Schedule to serialize the poll on the worker thread. */
-
-      work_queue(NETDEV_WORK, &upper->work, netdev_upper_work, upper, 0);
-    }
-#endif
+  netdev_upper_schedule(dev->d_private, NETDEV_THIS_QUEUE, 0);
 }
 
 /****************************************************************************
@@ -1034,6 +1400,68 @@ int netdev_upper_wireless_ioctl(FAR struct netdev_lowerhalf_s *lower,
 }
 #endif  /* CONFIG_NETDEV_WIRELESS_HANDLER */
 
+/****************************************************************************
+ * Name: netdev_upper_ethtool_ioctl
+ *
+ * Description:
+ *   Handle ETHTOOL_GCOALESCE/ETHTOOL_SCOALESCE, the RX budget and the RX
+ *   interrupt delay are managed by the upper half.
+ *
+ * Returned Value:
+ *   -ENOTTY for the other ethtool commands.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_IOCTL
+static int netdev_upper_ethtool_ioctl(FAR struct netdev_upperhalf_s *upper,
+                                      int cmd, unsigned long arg)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct ethtool_coalesce *coal =
+    (FAR struct ethtool_coalesce *)((uintptr_t)arg);
+  int ret = OK;
+
+  if (coal == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (coal->cmd != ETHTOOL_GCOALESCE && coal->cmd != ETHTOOL_SCOALESCE)
+    {
+      return -ENOTTY;
+    }
+
+  /* Let the lower half handle the hardware coalescing fields first */
+
+  if (lower->ops->ioctl)
+    {
+      ret = lower->ops->ioctl(lower, cmd, arg);
+      if (ret == -ENOTTY)
+        {
+          ret = OK;
+        }
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (coal->cmd == ETHTOOL_GCOALESCE)
+    {
+      coal->rx_coalesce_usecs       = upper->coalesce;
+      coal->rx_max_coalesced_frames = upper->budget;
+    }
+  else
+    {
+      upper->coalesce = coal->rx_coalesce_usecs;
+      upper->budget   = coal->rx_max_coalesced_frames;
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_upper_ifup/ifdown/addmac/rmmac/ioctl
  *
@@ -1154,6 +1582,40 @@ static int netdev_upper_ioctl(FAR struct net_driver_s *dev, int cmd,
     }
 #endif
 
+  if (cmd == SIOCETHTOOL)
+    {
+      int ret = netdev_upper_ethtool_ioctl(upper, cmd, arg);
+      if (ret != -ENOTTY)
+        {
+          return ret;
+        }
+    }
+
+#ifdef CONFIG_NETDEV_RPS
+  if (cmd == SIOCNOTIFYRECVCPU)
+    {
+      FAR struct netdev_rss_s *rss =
+        (FAR struct netdev_rss_s *)((uintptr_t)arg);
+      int ret = OK;
+
+      /* Remember the consumer CPU for the software steering, and still
+       * let the hardware program its own flow table if it has one.
+       */
+
+      if (rss->cpu >= 0 && rss->cpu < NETDEV_THREAD_COUNT)
+        {
+          upper->rfs[rss->hash % CONFIG_NETDEV_RFS_ENTRIES] = rss->cpu + 1;
+        }
+
+      if (lower->ops->ioctl)
+        {
+          ret = lower->ops->ioctl(lower, cmd, arg);
+        }
+
+      return ret == -ENOTTY ? OK : ret;
+    }
+#endif
+
   if (lower->ops->ioctl)
     {
       return lower->ops->ioctl(lower, cmd, arg);
@@ -1199,6 +1661,16 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
       return -EINVAL;
     }
 
+#ifdef CONFIG_NETDEV_RSS
+  if (dev->rxqueues > NETDEV_THREAD_COUNT ||
+      dev->txqueues > NETDEV_THREAD_COUNT ||
+      (dev->rxqueues > 1 && dev->ops->receive_queue == NULL) ||
+      (dev->txqueues > 1 && dev->ops->transmit_queue == NULL))
+    {
+      return -EINVAL;
+    }
+#endif
+
   if ((upper = netdev_upper_alloc(dev)) == NULL)
     {
       return -ENOMEM;
@@ -1290,6 +1762,13 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
   iob_free_queue(&upper->txq);
 #endif
 
+#ifdef CONFIG_NETDEV_RPS
+  for (i = 0; i < NETDEV_THREAD_COUNT; i++)
+    {
+      iob_free_queue(&upper->backlog[i]);
+    }
+#endif
+
   kmm_free(upper);
   dev->netdev.d_private = NULL;
 
@@ -1344,7 +1823,9 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev)
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 {
 #if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
-  netdev_upper_queue_work(&dev->netdev);
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  netdev_upper_schedule(upper, NETDEV_THIS_QUEUE, upper->coalesce);
 #endif
 }
 
@@ -1367,6 +1848,55 @@ void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
 #endif
 }
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   the specified hardware queue, only the work thread bound to the queue
+ *   is woken up.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The index of the RX queue
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RSS
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue)
+{
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  netdev_upper_schedule(upper, queue % NETDEV_THREAD_COUNT,
+                        upper->coalesce);
+#endif
+}
+
+/****************************************************************************
+ * Name: netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about a TX packet is sent on the
+ *   specified hardware queue.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The index of the TX queue
+ *
+ ****************************************************************************/
+
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               int queue)
+{
+  NETDEV_TXDONE(&dev->netdev);
+#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+  netdev_upper_wakeup(dev->netdev.d_private, queue % NETDEV_THREAD_COUNT);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -26,6 +26,7 @@
 
 #include <nuttx/instrument.h>
 #include <nuttx/note/note_driver.h>
+#include <nuttx/note/notectf_driver.h>
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/note/notectl_driver.h>
 #include <nuttx/note/notesnap_driver.h>
@@ -165,6 +166,15 @@ int note_initialize(void)
     }
 #endif
 
+#ifdef CONFIG_DRIVERS_NOTECTF
+  ret = notectf_register(CONFIG_DRIVERS_NOTECTF_PATH);
+  if (ret < 0)
+    {
+      serr("notectf_register failed %d\n", ret);
+      return ret;
+    }
+#endif
+
 #ifdef CONFIG_NOTE_RTT
   ret = notertt_register();
   if (ret < 0)
@@ -0,0 +1,1109 @@
+/****************************************************************************
+ * drivers/note/notectf_driver.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/sched.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/signal.h>
+#include <nuttx/streams.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/note/note_driver.h>
+#include <nuttx/note/notectf_driver.h>
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SYSCALL
+#  ifdef CONFIG_LIB_SYSCALL
+#    include <syscall.h>
+#  else
+#    define CONFIG_LIB_SYSCALL
+#    include <syscall.h>
+#    undef CONFIG_LIB_SYSCALL
+#  endif
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NCPUS CONFIG_SMP_NCPUS
+
+#define NOTECTF_BUFSIZE    CONFIG_DRIVERS_NOTECTF_BUFSIZE
+#define NOTECTF_PACKETSIZE CONFIG_DRIVERS_NOTECTF_PACKETSIZE
+
+#if (NOTECTF_BUFSIZE & (NOTECTF_BUFSIZE - 1)) != 0
+#  error CONFIG_DRIVERS_NOTECTF_BUFSIZE must be a power of two
+#endif
+
+/* The packet header and context, see the metadata below */
+
+#define NOTECTF_MAGIC       0xc1fc1fc1
+#define NOTECTF_HEADER_SIZE 52
+
+/* The largest event, string fields are truncated to fit */
+
+#define NOTECTF_STRING_MAX  128
+#define NOTECTF_EVENT_MAX   256
+
+#if NOTECTF_PACKETSIZE < NOTECTF_HEADER_SIZE + NOTECTF_EVENT_MAX
+#  error CONFIG_DRIVERS_NOTECTF_PACKETSIZE is too small
+#endif
+
+/* The length of the comm fields, the same as Linux */
+
+#define NOTECTF_COMM_SIZE   16
+
+/* Renumber idle task PIDs
+ *  In NuttX, PID number less than NCPUS are idle tasks.
+ *  In Linux, there is only one idle task of PID 0.
+ */
+
+#define get_pid(pid) ((pid) < NCPUS ? 0 : (pid))
+
+/* Map the task state to the Linux prev_state values understood by the
+ * viewers: 0 running, 1 sleeping and 64 dead.
+ */
+
+#define get_task_state(s) \
+  ((s) == 0 ? 64 : ((s) <= LAST_READY_TO_RUN_STATE ? 0 : 1))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The CTF event IDs, the order must match g_notectf_events.  The system
+ * call events follow, syscall_entry_<name> and syscall_exit_<name> of each
+ * system call in turn.
+ */
+
+enum notectf_event_e
+{
+  NOTECTF_SCHED_SWITCH = 0,
+  NOTECTF_SCHED_WAKING,
+  NOTECTF_SCHED_WAKEUP_NEW,
+  NOTECTF_SCHED_PROCESS_EXIT,
+  NOTECTF_IRQ_HANDLER_ENTRY,
+  NOTECTF_IRQ_HANDLER_EXIT,
+  NOTECTF_HEAP,
+  NOTECTF_MARK_BEGIN,
+  NOTECTF_MARK_END,
+  NOTECTF_MARK,
+  NOTECTF_COUNTER,
+  NOTECTF_PRINTF,
+  NOTECTF_SYSCALL
+};
+
+struct notectf_event_s
+{
+  FAR const char *name;
+  FAR const char *fields;
+};
+
+/* One stream per CPU.  The CPU adds the raw notes to the ring and the
+ * writer thread converts them to CTF events, head is only written by the
+ * CPU and tail only by the writer, so no lock is needed.
+ */
+
+struct notectf_stream_s
+{
+  atomic_uint     head;           /* Written by the CPU */
+  atomic_uint     tail;           /* Written by the writer thread */
+  uint32_t        ndiscarded;     /* Notes dropped because ring was full */
+  FAR uint8_t    *ring;           /* Raw notes of NOTECTF_BUFSIZE */
+  FAR uint8_t    *packet;         /* CTF packet of NOTECTF_PACKETSIZE */
+  size_t          plen;           /* Bytes in the packet */
+  uint64_t        tsbegin;        /* Timestamp of the first event */
+  uint64_t        tsend;          /* Timestamp of the last event */
+  uint64_t        tslast;         /* Last timestamp, keeps them monotonic */
+  struct file     file;           /* The stream file */
+  int             cpu;
+
+  /* Task switch state, see noteram_dump_context_s */
+
+  int             intr_nest;
+  bool            pendingswitch;
+  uint8_t         current_state;
+  uint8_t         current_priority;
+  uint8_t         next_priority;
+  pid_t           current_pid;
+  pid_t           next_pid;
+};
+
+struct notectf_driver_s
+{
+  struct note_driver_s    driver;
+  FAR const char         *path;     /* The output directory */
+  bool                    opened;   /* The trace files are created */
+  struct notectf_stream_s stream[NCPUS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void notectf_add(FAR struct note_driver_s *driver,
+                        FAR const void *note, size_t notelen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct note_driver_ops_s g_notectf_ops =
+{
+  notectf_add
+};
+
+static struct notectf_driver_s g_notectf_driver =
+{
+  {
+#ifdef CONFIG_SCHED_INSTRUMENTATION_FILTER
+    "ctf",
+    {
+      {
+        CONFIG_SCHED_INSTRUMENTATION_FILTER_DEFAULT_MODE,
+#  ifdef CONFIG_SMP
+        CONFIG_SCHED_INSTRUMENTATION_CPUSET
+#  endif
+      },
+    },
+#endif
+    &g_notectf_ops
+  }
+};
+
+/* The event names and fields follow LTTng where there is an equivalent,
+ * so the kernel analyses of Trace Compass work on the trace.
+ */
+
+static const struct notectf_event_s g_notectf_events[] =
+{
+  {
+    "sched_switch",
+    "char_t _prev_comm[16]; int32_t _prev_tid; int32_t _prev_prio; "
+    "int64_t _prev_state; char_t _next_comm[16]; int32_t _next_tid; "
+    "int32_t _next_prio;"
+  },
+  {
+    "sched_waking",
+    "char_t _comm[16]; int32_t _tid; int32_t _prio; int32_t _target_cpu;"
+  },
+  {
+    "sched_wakeup_new",
+    "char_t _comm[16]; int32_t _tid; int32_t _prio; int32_t _target_cpu;"
+  },
+  {
+    "sched_process_exit",
+    "char_t _comm[16]; int32_t _tid; int32_t _prio;"
+  },
+  {
+    "irq_handler_entry",
+    "int32_t _irq; string _name;"
+  },
+  {
+    "irq_handler_exit",
+    "int32_t _irq; int32_t _ret;"
+  },
+  {
+    "nuttx_heap",
+    "enum : uint8_t { add, remove, malloc, free } _op; xint64_t _heap; "
+    "xint64_t _mem; uint64_t _size; uint64_t _used;"
+  },
+  {
+    "nuttx_mark_begin",
+    "string _name;"
+  },
+  {
+    "nuttx_mark_end",
+    "string _name;"
+  },
+  {
+    "nuttx_mark",
+    "string _name;"
+  },
+  {
+    "nuttx_counter",
+    "string _name; int64_t _value;"
+  },
+  {
+    "nuttx_printf",
+    "string _msg;"
+  },
+};
+
+static const char g_notectf_metadata[] =
+  "/* CTF 1.8 */\n"
+  "\n"
+  "typealias integer { size = 8; align = 8; signed = false; } := uint8_t;\n"
+  "typealias integer { size = 16; align = 8; signed = false; } "
+  ":= uint16_t;\n"
+  "typealias integer { size = 32; align = 8; signed = false; } "
+  ":= uint32_t;\n"
+  "typealias integer { size = 64; align = 8; signed = false; } "
+  ":= uint64_t;\n"
+  "typealias integer { size = 32; align = 8; signed = true; } := int32_t;\n"
+  "typealias integer { size = 64; align = 8; signed = true; } := int64_t;\n"
+  "typealias integer { size = 64; align = 8; signed = false; base = 16; } "
+  ":= xint64_t;\n"
+  "typealias integer { size = 8; align = 8; signed = false; "
+  "encoding = UTF8; } := char_t;\n"
+  "\n"
+  "trace {\n"
+  "\tmajor = 1;\n"
+  "\tminor = 8;\n"
+#ifdef CONFIG_ENDIAN_BIG
+  "\tbyte_order = be;\n"
+#else
+  "\tbyte_order = le;\n"
+#endif
+  "\tpacket.header := struct {\n"
+  "\t\tuint32_t magic;\n"
+  "\t\tuint32_t stream_id;\n"
+  "\t};\n"
+  "};\n"
+  "\n"
+  "env {\n"
+  "\tdomain = \"kernel\";\n"
+  "\tsysname = \"NuttX\";\n"
+  "\ttracer_name = \"lttng-modules\";\n"
+  "\ttracer_major = 2;\n"
+  "\ttracer_minor = 12;\n"
+  "};\n"
+  "\n";
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notectf_add
+ *
+ * Description:
+ *   Queue the raw note in the ring of this CPU, the note is discarded if
+ *   the ring is full.  Nothing else is done here, so the instrumented path
+ *   never waits for the writer.
+ *
+ ****************************************************************************/
+
+static void notectf_add(FAR struct note_driver_s *driver,
+                        FAR const void *note, size_t notelen)
+{
+  FAR struct notectf_driver_s *drv = (FAR struct notectf_driver_s *)driver;
+  FAR const uint8_t *buf = note;
+  FAR struct notectf_stream_s *stream;
+  unsigned int head;
+  unsigned int tail;
+  unsigned int index;
+  irqstate_t flags;
+  size_t space;
+
+  flags  = up_irq_save();
+  stream = &drv->stream[this_cpu()];
+
+  head = atomic_load_explicit(&stream->head, memory_order_relaxed);
+  tail = atomic_load_explicit(&stream->tail, memory_order_acquire);
+
+  if (NOTECTF_BUFSIZE - (head - tail) < NOTE_ALIGN(notelen))
+    {
+      stream->ndiscarded++;
+      up_irq_restore(flags);
+      return;
+    }
+
+  index = head & (NOTECTF_BUFSIZE - 1);
+  space = NOTECTF_BUFSIZE - index;
+  space = space < notelen ? space : notelen;
+  memcpy(stream->ring + index, buf, space);
+  memcpy(stream->ring, buf + space, notelen - space);
+
+  atomic_store_explicit(&stream->head, head + NOTE_ALIGN(notelen),
+                        memory_order_release);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: get_taskname
+ ****************************************************************************/
+
+static FAR const char *get_taskname(pid_t pid)
+{
+#if CONFIG_DRIVERS_NOTE_TASKNAME_BUFSIZE > 0
+  FAR const char *taskname;
+
+  taskname = note_get_taskname(pid);
+  if (taskname != NULL)
+    {
+      return taskname;
+    }
+#endif
+
+  return "<noname>";
+}
+
+/****************************************************************************
+ * Name: notectf_timestamp
+ *
+ * Description:
+ *   Extend the note time to 64 bits and keep it monotonic in the stream,
+ *   a note may be timestamped before an interrupt which adds its notes
+ *   first.
+ *
+ ****************************************************************************/
+
+static uint64_t notectf_timestamp(FAR struct notectf_stream_s *stream,
+                                  clock_t systime)
+{
+  uint64_t ts;
+
+#if CLOCK_MAX == UINT32_MAX
+  ts = (stream->tslast & ~(uint64_t)UINT32_MAX) | (uint32_t)systime;
+  if (ts < stream->tslast && stream->tslast - ts > INT32_MAX)
+    {
+      ts += (uint64_t)UINT32_MAX + 1;
+    }
+#else
+  ts = systime;
+#endif
+
+  if (ts < stream->tslast)
+    {
+      ts = stream->tslast;
+    }
+
+  stream->tslast = ts;
+  return ts;
+}
+
+/****************************************************************************
+ * Name: notectf_put*
+ *
+ * Description:
+ *   Append a field to the packet, in the native byte order as declared in
+ *   the metadata.
+ *
+ ****************************************************************************/
+
+static void notectf_put(FAR struct notectf_stream_s *stream,
+                        FAR const void *data, size_t len)
+{
+  memcpy(stream->packet + stream->plen, data, len);
+  stream->plen += len;
+}
+
+static void notectf_put8(FAR struct notectf_stream_s *stream,
+                         uint8_t value)
+{
+  stream->packet[stream->plen++] = value;
+}
+
+static void notectf_put16(FAR struct notectf_stream_s *stream,
+                          uint16_t value)
+{
+  notectf_put(stream, &value, sizeof(value));
+}
+
+static void notectf_put32(FAR struct notectf_stream_s *stream,
+                          uint32_t value)
+{
+  notectf_put(stream, &value, sizeof(value));
+}
+
+static void notectf_put64(FAR struct notectf_stream_s *stream,
+                          uint64_t value)
+{
+  notectf_put(stream, &value, sizeof(value));
+}
+
+static void notectf_putstr(FAR struct notectf_stream_s *stream,
+                           FAR const char *str, size_t len)
+{
+  len = strnlen(str, len < NOTECTF_STRING_MAX ?
+                     len : NOTECTF_STRING_MAX - 1);
+  notectf_put(stream, str, len);
+  notectf_put8(stream, '\0');
+}
+
+static void notectf_putsym(FAR struct notectf_stream_s *stream,
+                           uintptr_t ip)
+{
+  char name[NOTECTF_STRING_MAX];
+
+  snprintf(name, sizeof(name), "%pS", (FAR void *)ip);
+  notectf_putstr(stream, name, sizeof(name));
+}
+
+static void notectf_puttask(FAR struct notectf_stream_s *stream,
+                            pid_t pid, uint8_t priority)
+{
+  char comm[NOTECTF_COMM_SIZE];
+
+  memset(comm, 0, sizeof(comm));
+  strlcpy(comm, get_taskname(pid), sizeof(comm));
+  notectf_put(stream, comm, sizeof(comm));
+  notectf_put32(stream, get_pid(pid));
+  notectf_put32(stream, priority);
+}
+
+/****************************************************************************
+ * Name: notectf_flush
+ *
+ * Description:
+ *   Fill in the packet header and context, and write the packet to the
+ *   stream file.  The packet is written even if it is not full, so the
+ *   file is up to date after each interval.
+ *
+ ****************************************************************************/
+
+static void notectf_flush(FAR struct notectf_stream_s *stream)
+{
+  size_t len = stream->plen;
+
+  if (len == NOTECTF_HEADER_SIZE)
+    {
+      return;
+    }
+
+  stream->plen = 0;
+  notectf_put32(stream, NOTECTF_MAGIC);
+  notectf_put32(stream, 0);
+  notectf_put64(stream, stream->tsbegin);
+  notectf_put64(stream, stream->tsend);
+  notectf_put64(stream, len * 8);
+  notectf_put64(stream, len * 8);
+  notectf_put64(stream, stream->ndiscarded);
+  notectf_put32(stream, stream->cpu);
+  DEBUGASSERT(stream->plen == NOTECTF_HEADER_SIZE);
+
+  file_write(&stream->file, stream->packet, len);
+}
+
+/****************************************************************************
+ * Name: notectf_event
+ *
+ * Description:
+ *   Start a new event in the packet, the packet is flushed first if the
+ *   largest event may not fit.
+ *
+ ****************************************************************************/
+
+static void notectf_event(FAR struct notectf_stream_s *stream,
+                          uint16_t id, uint64_t ts)
+{
+  if (stream->plen + NOTECTF_EVENT_MAX > NOTECTF_PACKETSIZE)
+    {
+      notectf_flush(stream);
+    }
+
+  if (stream->plen == NOTECTF_HEADER_SIZE)
+    {
+      stream->tsbegin = ts;
+    }
+
+  stream->tsend = ts;
+  notectf_put16(stream, id);
+  notectf_put64(stream, ts);
+}
+
+#if defined(CONFIG_SCHED_INSTRUMENTATION_SWITCH) || \
+    defined(CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER)
+/****************************************************************************
+ * Name: notectf_sched_switch
+ ****************************************************************************/
+
+static void notectf_sched_switch(FAR struct notectf_stream_s *stream,
+                                 uint64_t ts)
+{
+  notectf_event(stream, NOTECTF_SCHED_SWITCH, ts);
+  notectf_puttask(stream, stream->current_pid, stream->current_priority);
+  notectf_put64(stream, get_task_state(stream->current_state));
+  notectf_puttask(stream, stream->next_pid, stream->next_priority);
+
+  stream->current_pid = stream->next_pid;
+  stream->current_priority = stream->next_priority;
+  stream->pendingswitch = false;
+}
+#endif
+
+/****************************************************************************
+ * Name: notectf_printf
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+static void notectf_printf(FAR struct notectf_stream_s *stream,
+                           FAR struct note_printf_s *note)
+{
+  struct lib_memoutstream_s s;
+  char msg[NOTECTF_STRING_MAX];
+
+  lib_memoutstream(&s, msg, sizeof(msg));
+  if (note->npt_type == 0)
+    {
+      lib_bsprintf(&s.common, note->npt_fmt, note->npt_data);
+    }
+  else
+    {
+      size_t count = NOTE_PRINTF_GET_COUNT(note->npt_type);
+      char fmt[128];
+      size_t i;
+
+      fmt[0] = '\0';
+      lib_sprintf(&s.common, "%p", note->npt_fmt);
+      for (i = 0; i < count; i++)
+        {
+          switch (NOTE_PRINTF_GET_TYPE(note->npt_type, i))
+            {
+              case NOTE_PRINTF_UINT32:
+                strlcat(fmt, " %u", sizeof(fmt));
+                break;
+
+              case NOTE_PRINTF_UINT64:
+                strlcat(fmt, " %llu", sizeof(fmt));
+                break;
+
+              case NOTE_PRINTF_STRING:
+                strlcat(fmt, " %s", sizeof(fmt));
+                break;
+
+              case NOTE_PRINTF_DOUBLE:
+                strlcat(fmt, " %f", sizeof(fmt));
+                break;
+            }
+        }
+
+      lib_bsprintf(&s.common, fmt, note->npt_data);
+    }
+
+  notectf_putstr(stream, msg, s.common.nput);
+}
+#endif
+
+/****************************************************************************
+ * Name: notectf_convert
+ *
+ * Description:
+ *   Convert one note to CTF events.  The task switch is derived from the
+ *   NOTE_SUSPEND and NOTE_RESUME pair the same way as the noteram dump.
+ *
+ ****************************************************************************/
+
+static void notectf_convert(FAR struct notectf_stream_s *stream,
+                            FAR struct note_common_s *note)
+{
+  uint64_t ts = notectf_timestamp(stream, note->nc_systime);
+
+  switch (note->nc_type)
+    {
+      case NOTE_START:
+        notectf_event(stream, NOTECTF_SCHED_WAKEUP_NEW, ts);
+        notectf_puttask(stream, note->nc_pid, note->nc_priority);
+        notectf_put32(stream, stream->cpu);
+        break;
+
+      case NOTE_STOP:
+        notectf_event(stream, NOTECTF_SCHED_PROCESS_EXIT, ts);
+        notectf_puttask(stream, note->nc_pid, note->nc_priority);
+        stream->current_state = 0;
+        break;
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SWITCH
+      case NOTE_SUSPEND:
+        {
+          FAR struct note_suspend_s *nsu = (FAR struct note_suspend_s *)note;
+
+          /* Preserve the information for the succeeding NOTE_RESUME */
+
+          stream->current_pid = note->nc_pid;
+          stream->current_priority = note->nc_priority;
+          stream->current_state = nsu->nsu_state;
+        }
+        break;
+
+      case NOTE_RESUME:
+        stream->next_pid = note->nc_pid;
+        stream->next_priority = note->nc_priority;
+
+        if (stream->intr_nest == 0)
+          {
+            notectf_sched_switch(stream, ts);
+          }
+        else
+          {
+            /* The task switch is postponed until leaving the interrupt
+             * handler.
+             */
+
+            notectf_event(stream, NOTECTF_SCHED_WAKING, ts);
+            notectf_puttask(stream, note->nc_pid, note->nc_priority);
+            notectf_put32(stream, stream->cpu);
+            stream->pendingswitch = true;
+          }
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+      case NOTE_IRQ_ENTER:
+        {
+          FAR struct note_irqhandler_s *nih;
+
+          nih = (FAR struct note_irqhandler_s *)note;
+          notectf_event(stream, NOTECTF_IRQ_HANDLER_ENTRY, ts);
+          notectf_put32(stream, nih->nih_irq);
+          notectf_putsym(stream, nih->nih_handler);
+          stream->intr_nest++;
+        }
+        break;
+
+      case NOTE_IRQ_LEAVE:
+        {
+          FAR struct note_irqhandler_s *nih;
+
+          nih = (FAR struct note_irqhandler_s *)note;
+          notectf_event(stream, NOTECTF_IRQ_HANDLER_EXIT, ts);
+          notectf_put32(stream, nih->nih_irq);
+          notectf_put32(stream, 1);
+
+          if (--stream->intr_nest <= 0)
+            {
+              stream->intr_nest = 0;
+              if (stream->pendingswitch)
+                {
+                  notectf_sched_switch(stream, ts);
+                }
+            }
+        }
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SYSCALL
+      case NOTE_SYSCALL_ENTER:
+        {
+          FAR struct note_syscall_enter_s *nsc;
+          int i;
+
+          nsc = (FAR struct note_syscall_enter_s *)note;
+          if (nsc->nsc_nr < CONFIG_SYS_RESERVED ||
+              nsc->nsc_nr >= SYS_maxsyscall)
+            {
+              break;
+            }
+
+          notectf_event(stream, NOTECTF_SYSCALL +
+                        2 * (nsc->nsc_nr - CONFIG_SYS_RESERVED), ts);
+          notectf_put8(stream, nsc->nsc_argc);
+          for (i = 0; i < nsc->nsc_argc; i++)
+            {
+              notectf_put64(stream, nsc->nsc_args[i]);
+            }
+        }
+        break;
+
+      case NOTE_SYSCALL_LEAVE:
+        {
+          FAR struct note_syscall_leave_s *nsc;
+
+          nsc = (FAR struct note_syscall_leave_s *)note;
+          if (nsc->nsc_nr < CONFIG_SYS_RESERVED ||
+              nsc->nsc_nr >= SYS_maxsyscall)
+            {
+              break;
+            }
+
+          notectf_event(stream, NOTECTF_SYSCALL + 1 +
+                        2 * (nsc->nsc_nr - CONFIG_SYS_RESERVED), ts);
+          notectf_put64(stream, (intptr_t)nsc->nsc_result);
+        }
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_HEAP
+      case NOTE_HEAP_ADD:
+      case NOTE_HEAP_REMOVE:
+      case NOTE_HEAP_ALLOC:
+      case NOTE_HEAP_FREE:
+        {
+          FAR struct note_heap_s *nmm = (FAR struct note_heap_s *)note;
+
+          notectf_event(stream, NOTECTF_HEAP, ts);
+          notectf_put8(stream, note->nc_type - NOTE_HEAP_ADD);
+          notectf_put64(stream, (uintptr_t)nmm->heap);
+          notectf_put64(stream, (uintptr_t)nmm->mem);
+          notectf_put64(stream, nmm->size);
+          notectf_put64(stream, nmm->used);
+        }
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+      case NOTE_DUMP_PRINTF:
+        notectf_event(stream, NOTECTF_PRINTF, ts);
+        notectf_printf(stream, (FAR struct note_printf_s *)note);
+        break;
+
+      case NOTE_DUMP_BEGIN:
+      case NOTE_DUMP_END:
+        {
+          FAR struct note_event_s *nev = (FAR struct note_event_s *)note;
+          size_t len = note->nc_length - SIZEOF_NOTE_EVENT(0);
+
+          notectf_event(stream, note->nc_type == NOTE_DUMP_BEGIN ?
+                        NOTECTF_MARK_BEGIN : NOTECTF_MARK_END, ts);
+          if (len > 0)
+            {
+              notectf_putstr(stream, (FAR const char *)nev->nev_data, len);
+            }
+          else
+            {
+              notectf_putsym(stream, nev->nev_ip);
+            }
+        }
+        break;
+
+      case NOTE_DUMP_MARK:
+        {
+          FAR struct note_event_s *nev = (FAR struct note_event_s *)note;
+
+          notectf_event(stream, NOTECTF_MARK, ts);
+          notectf_putstr(stream, (FAR const char *)nev->nev_data,
+                         note->nc_length - SIZEOF_NOTE_EVENT(0));
+        }
+        break;
+
+      case NOTE_DUMP_COUNTER:
+        {
+          FAR struct note_event_s *nev = (FAR struct note_event_s *)note;
+          FAR struct note_counter_s *counter;
+
+          counter = (FAR struct note_counter_s *)nev->nev_data;
+          notectf_event(stream, NOTECTF_COUNTER, ts);
+          notectf_putstr(stream, counter->name, sizeof(counter->name));
+          notectf_put64(stream, counter->value);
+        }
+        break;
+#endif
+
+      default:
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: notectf_drain
+ *
+ * Description:
+ *   Convert all the notes queued in the ring of one CPU.
+ *
+ ****************************************************************************/
+
+static void notectf_drain(FAR struct notectf_stream_s *stream)
+{
+  uintptr_t buf[(UINT8_MAX + sizeof(uintptr_t)) / sizeof(uintptr_t)];
+  unsigned int head;
+  unsigned int tail;
+  unsigned int index;
+  size_t notelen;
+  size_t space;
+
+  tail = atomic_load_explicit(&stream->tail, memory_order_relaxed);
+  for (; ; )
+    {
+      head = atomic_load_explicit(&stream->head, memory_order_acquire);
+      if (head == tail)
+        {
+          break;
+        }
+
+      /* Copy the note out and release its space before converting it */
+
+      index   = tail & (NOTECTF_BUFSIZE - 1);
+      notelen = stream->ring[index];
+      space   = NOTECTF_BUFSIZE - index;
+      space   = space < notelen ? space : notelen;
+      memcpy(buf, stream->ring + index, space);
+      memcpy((FAR uint8_t *)buf + space, stream->ring, notelen - space);
+
+      tail += NOTE_ALIGN(notelen);
+      atomic_store_explicit(&stream->tail, tail, memory_order_release);
+
+      notectf_convert(stream, (FAR struct note_common_s *)buf);
+    }
+}
+
+/****************************************************************************
+ * Name: notectf_metadata
+ *
+ * Description:
+ *   Write the TSDL metadata describing the packets and the events.
+ *
+ ****************************************************************************/
+
+static int notectf_metadata(FAR const char *path)
+{
+  struct lib_fileoutstream_s s;
+  char name[PATH_MAX];
+  struct file file;
+  int ret;
+  int i;
+
+  snprintf(name, sizeof(name), "%s/metadata", path);
+  ret = file_open(&file, name, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  lib_fileoutstream(&s, &file);
+  lib_stream_puts(&s.common, g_notectf_metadata,
+                  sizeof(g_notectf_metadata) - 1);
+
+  lib_sprintf(&s.common,
+              "clock {\n"
+              "\tname = \"monotonic\";\n"
+              "\tfreq = %lu;\n"
+              "\toffset = 0;\n"
+              "};\n"
+              "\n"
+              "typealias integer { size = 64; align = 8; signed = false; "
+              "map = clock.monotonic.value; } := uint64_clock_t;\n"
+              "\n"
+              "stream {\n"
+              "\tid = 0;\n"
+              "\tpacket.context := struct {\n"
+              "\t\tuint64_clock_t timestamp_begin;\n"
+              "\t\tuint64_clock_t timestamp_end;\n"
+              "\t\tuint64_t content_size;\n"
+              "\t\tuint64_t packet_size;\n"
+              "\t\tuint64_t events_discarded;\n"
+              "\t\tuint32_t cpu_id;\n"
+              "\t};\n"
+              "\tevent.header := struct {\n"
+              "\t\tuint16_t id;\n"
+              "\t\tuint64_clock_t timestamp;\n"
+              "\t};\n"
+              "};\n",
+              perf_getfreq());
+
+  for (i = 0; i < nitems(g_notectf_events); i++)
+    {
+      lib_sprintf(&s.common,
+                  "\nevent {\n"
+                  "\tname = \"%s\";\n"
+                  "\tid = %d;\n"
+                  "\tstream_id = 0;\n"
+                  "\tfields := struct { %s };\n"
+                  "};\n",
+                  g_notectf_events[i].name, i, g_notectf_events[i].fields);
+    }
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SYSCALL
+  for (i = 0; i < SYS_nsyscalls; i++)
+    {
+      lib_sprintf(&s.common,
+                  "\nevent {\n"
+                  "\tname = \"syscall_entry_%s\";\n"
+                  "\tid = %d;\n"
+                  "\tstream_id = 0;\n"
+                  "\tfields := struct { uint8_t _argc; "
+                  "xint64_t _args[_argc]; };\n"
+                  "};\n"
+                  "\nevent {\n"
+                  "\tname = \"syscall_exit_%s\";\n"
+                  "\tid = %d;\n"
+                  "\tstream_id = 0;\n"
+                  "\tfields := struct { int64_t _ret; };\n"
+                  "};\n",
+                  g_funcnames[i], NOTECTF_SYSCALL + 2 * i,
+                  g_funcnames[i], NOTECTF_SYSCALL + 2 * i + 1);
+    }
+#endif
+
+  lib_stream_flush(&s.common);
+  file_close(&file);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: notectf_open
+ *
+ * Description:
+ *   Create the trace files.  The output directory is usually not mounted
+ *   yet when the driver is registered, so the writer thread retries every
+ *   interval and the notes wait in the rings meanwhile.
+ *
+ ****************************************************************************/
+
+static int notectf_open(FAR struct notectf_driver_s *drv)
+{
+  struct statfs buf;
+  char name[PATH_MAX];
+  int ret;
+  int cpu;
+
+  /* Wait until a real file system is mounted on the path, the directory
+   * must not be created in the pseudo file system.
+   */
+
+  ret = statfs(drv->path, &buf);
+  if (ret < 0 || buf.f_type == PROC_SUPER_MAGIC)
+    {
+      return -ENOENT;
+    }
+
+  mkdir(drv->path, 0777);
+
+  ret = notectf_metadata(drv->path);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      snprintf(name, sizeof(name), "%s/stream_%d", drv->path, cpu);
+      ret = file_open(&drv->stream[cpu].file, name,
+                      O_WRONLY | O_CREAT | O_TRUNC, 0666);
+      if (ret < 0)
+        {
+          while (cpu-- > 0)
+            {
+              file_close(&drv->stream[cpu].file);
+            }
+
+          return ret;
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: notectf_thread
+ *
+ * Description:
+ *   The writer thread, drain the rings and write the packets to the stream
+ *   files every interval.
+ *
+ ****************************************************************************/
+
+static int notectf_thread(int argc, FAR char *argv[])
+{
+  FAR struct notectf_driver_s *drv = &g_notectf_driver;
+  int cpu;
+
+  for (; ; )
+    {
+      nxsig_usleep(CONFIG_DRIVERS_NOTECTF_INTERVAL * 1000);
+
+      if (!drv->opened)
+        {
+          if (notectf_open(drv) < 0)
+            {
+              continue;
+            }
+
+          drv->opened = true;
+        }
+
+      for (cpu = 0; cpu < NCPUS; cpu++)
+        {
+          notectf_drain(&drv->stream[cpu]);
+          notectf_flush(&drv->stream[cpu]);
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notectf_register
+ *
+ * Description:
+ *   Register the CTF exporter as a note driver, the trace is created in the
+ *   directory once it is available.
+ *
+ * Input Parameters:
+ *   path - The output directory, created if it does not exist.  The string
+ *          must stay valid.
+ *
+ * Returned Value:
+ *   Zero on success. A negative errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int notectf_register(FAR const char *path)
+{
+  FAR struct notectf_driver_s *drv = &g_notectf_driver;
+  FAR struct notectf_stream_s *stream;
+  FAR uint8_t *buffer;
+  int ret;
+  int cpu;
+
+  buffer = kmm_malloc(NCPUS * (NOTECTF_BUFSIZE + NOTECTF_PACKETSIZE));
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  drv->path = path;
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      stream         = &drv->stream[cpu];
+      stream->ring   = buffer;
+      stream->packet = buffer + NOTECTF_BUFSIZE;
+      stream->plen   = NOTECTF_HEADER_SIZE;
+      stream->cpu    = cpu;
+      buffer        += NOTECTF_BUFSIZE + NOTECTF_PACKETSIZE;
+    }
+
+  ret = kthread_create("notectf", CONFIG_DRIVERS_NOTECTF_PRIORITY,
+                       CONFIG_DRIVERS_NOTECTF_STACKSIZE, notectf_thread,
+                       NULL);
+  if (ret < 0)
+    {
+      kmm_free(drv->stream[0].ring);
+      memset(drv->stream, 0, sizeof(drv->stream));
+      return ret;
+    }
+
+  return note_driver_register(&drv->driver);
+}
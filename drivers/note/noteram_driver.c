@@ -34,10 +34,12 @@
 #include <inttypes.h>
 #include <poll.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched.h>
 #include <nuttx/sched_note.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/lib/math32.h>
 #include <nuttx/note/note_driver.h>
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/panic_notifier.h>
@@ -70,20 +72,50 @@
 #define get_task_state(s)                                                    \
   ((s) == 0 ? 'X' : ((s) <= LAST_READY_TO_RUN_STATE ? 'R' : 'S'))
 
+/* The buffer is split evenly into one ring per CPU.  The size of a ring
+ * is a power of two, so that the buffer index of a free running position
+ * stays right when the position wraps around.
+ */
+
+#define NOTERAM_RINGSIZE(s) ((size_t)1 << LOG2_FLOOR((s) / NCPUS))
+
+#define noteram_index(drv, pos) ((pos) & ((drv)->ni_ringsize - 1))
+
+#define noteram_ringbuf(drv, cpu)                                            \
+  ((drv)->ni_buffer + (cpu) * (drv)->ni_ringsize)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* The notes of each CPU go to a ring of its own, which only that CPU
+ * writes with its interrupts disabled, so adding a note takes no lock.
+ * The head and the tail are free running byte positions, which lets the
+ * reader detect that a note was overwritten while it was copying it.
+ */
+
+struct noteram_ring_s
+{
+  atomic_uint nr_head;        /* Position after the newest note */
+  atomic_uint nr_tail;        /* Position of the oldest note */
+  unsigned int nr_read;       /* Position of the next note to read */
+  unsigned int nr_start;      /* Position of the first note after clear */
+#ifdef CONFIG_DRIVERS_NOTERAM_STATS
+  uint32_t nr_nnotes;         /* Number of notes added */
+  uint32_t nr_nlost;          /* Notes dropped or overwritten unread */
+  uint64_t nr_ncycles;        /* Perf counter ticks spent adding notes */
+#endif
+};
+
 struct noteram_driver_s
 {
   struct note_driver_s driver;
   FAR uint8_t *ni_buffer;
   size_t ni_bufsize;
+  size_t ni_ringsize;
   unsigned int ni_overwrite;
-  volatile unsigned int ni_head;
-  volatile unsigned int ni_tail;
-  volatile unsigned int ni_read;
-  spinlock_t lock;
+  struct noteram_ring_s ni_ring[NCPUS];
+  spinlock_t lock;            /* Serializes the readers only */
   FAR struct pollfd *pfd;
 };
 
@@ -174,6 +206,7 @@ struct noteram_driver_s g_noteram_driver =
   },
   g_ramnote_buffer,
   CONFIG_DRIVERS_NOTERAM_BUFSIZE,
+  NOTERAM_RINGSIZE(CONFIG_DRIVERS_NOTERAM_BUFSIZE),
 #ifdef CONFIG_DRIVERS_NOTERAM_DEFAULT_NOOVERWRITE
   NOTERAM_MODE_OVERWRITE_DISABLE
 #else
@@ -201,8 +234,17 @@ struct noteram_driver_s g_noteram_driver =
 
 static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 {
-  drv->ni_tail = drv->ni_head;
-  drv->ni_read = drv->ni_head;
+  FAR struct noteram_ring_s *ring;
+  int cpu;
+
+  /* The producers own the head and the tail, just move the readers */
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      ring = &drv->ni_ring[cpu];
+      ring->nr_start = atomic_load(&ring->nr_head);
+      ring->nr_read  = ring->nr_start;
+    }
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
@@ -211,58 +253,31 @@ static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 }
 
 /****************************************************************************
- * Name: noteram_next
+ * Name: noteram_readpos
  *
  * Description:
- *   Return the circular buffer index at offset from the specified index
- *   value, handling wraparound
- *
- * Input Parameters:
- *   ndx - Old circular buffer index
- *
- * Returned Value:
- *   New circular buffer index
+ *   Return the position of the next unread note of a ring, skipping the
+ *   notes that were overwritten or cleared since the last read.
  *
  ****************************************************************************/
 
-static inline unsigned int noteram_next(FAR struct noteram_driver_s *drv,
-                                        unsigned int ndx,
-                                        unsigned int offset)
+static unsigned int noteram_readpos(FAR struct noteram_ring_s *ring)
 {
-  ndx += offset;
-  if (ndx >= drv->ni_bufsize)
+  unsigned int tail = atomic_load_explicit(&ring->nr_tail,
+                                           memory_order_acquire);
+  unsigned int read = ring->nr_read;
+
+  if ((int)(tail - read) > 0)
     {
-      ndx -= drv->ni_bufsize;
+      read = tail;
     }
 
-  return ndx;
-}
-
-/****************************************************************************
- * Name: noteram_length
- *
- * Description:
- *   Length of data currently in circular buffer.
- *
- * Input Parameters:
- *   None
- *
- * Returned Value:
- *   Length of data currently in circular buffer.
- *
- ****************************************************************************/
-
-static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
-{
-  unsigned int head = drv->ni_head;
-  unsigned int tail = drv->ni_tail;
-
-  if (tail > head)
+  if ((int)(ring->nr_start - read) > 0)
     {
-      head += drv->ni_bufsize;
+      read = ring->nr_start;
     }
 
-  return head - tail;
+  return read;
 }
 
 /****************************************************************************
@@ -281,61 +296,38 @@ static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
 
 static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int read = drv->ni_read;
+  FAR struct noteram_ring_s *ring;
+  unsigned int length = 0;
+  int cpu;
 
-  if (read > head)
+  for (cpu = 0; cpu < NCPUS; cpu++)
     {
-      head += drv->ni_bufsize;
+      ring    = &drv->ni_ring[cpu];
+      length += atomic_load(&ring->nr_head) - noteram_readpos(ring);
     }
 
-  return head - read;
+  return length;
 }
 
 /****************************************************************************
- * Name: noteram_remove
+ * Name: noteram_copy
  *
  * Description:
- *   Remove the variable length note from the tail of the circular buffer
- *
- * Input Parameters:
- *   None
- *
- * Returned Value:
- *   None
- *
- * Assumptions:
- *   We are within a critical section.
+ *   Copy len bytes at the position pos out of the ring of a CPU, handling
+ *   wraparound.
  *
  ****************************************************************************/
 
-static void noteram_remove(FAR struct noteram_driver_s *drv)
+static void noteram_copy(FAR struct noteram_driver_s *drv, int cpu,
+                         unsigned int pos, FAR void *dest, size_t len)
 {
-  unsigned int tail;
-  unsigned int length;
+  FAR uint8_t *buffer = noteram_ringbuf(drv, cpu);
+  unsigned int ndx = noteram_index(drv, pos);
+  size_t space = drv->ni_ringsize - ndx;
 
-  /* Get the tail index of the circular buffer */
-
-  tail = drv->ni_tail;
-  DEBUGASSERT(tail < drv->ni_bufsize);
-
-  /* Get the length of the note at the tail index */
-
-  length = NOTE_ALIGN(drv->ni_buffer[tail]);
-  DEBUGASSERT(length <= noteram_length(drv));
-
-  /* Increment the tail index to remove the entire note from the circular
-   * buffer.
-   */
-
-  if (drv->ni_read == drv->ni_tail)
-    {
-      /* The read index also needs increment. */
-
-      drv->ni_read = noteram_next(drv, tail, length);
-    }
-
-  drv->ni_tail = noteram_next(drv, tail, length);
+  space = space < len ? space : len;
+  memcpy(dest, buffer + ndx, space);
+  memcpy((FAR uint8_t *)dest + space, buffer, len - space);
 }
 
 /****************************************************************************
@@ -344,6 +336,11 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
  * Description:
  *   Get the next note from the read index of the circular buffer.
  *
+ *   The rings of all CPUs are merged here by taking the oldest of their
+ *   first unread notes.  The producers never wait for the reader, so a
+ *   note is only good if the tail didn't move past it while it was being
+ *   copied; otherwise the copy is thrown away and the merge restarted.
+ *
  * Input Parameters:
  *   buffer - Location to return the next note
  *   buflen - The length of the user provided buffer.
@@ -358,63 +355,72 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
 static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
                            FAR uint8_t *buffer, size_t buflen)
 {
-  FAR struct note_common_s *note;
-  unsigned int remaining;
-  unsigned int read;
-  ssize_t notelen;
-  size_t circlen;
+  FAR struct noteram_ring_s *ring;
+  struct note_common_s note;
+  unsigned int read = 0;
+  unsigned int head;
+  unsigned int pos;
+  clock_t systime = 0;
+  size_t notelen;
+  int select;
+  int cpu;
 
   DEBUGASSERT(buffer != NULL);
 
-  /* Verify that the circular buffer is not empty */
-
-  circlen = noteram_unread_length(drv);
-  if (circlen <= 0)
+  do
     {
-      return 0;
-    }
-
-  /* Get the read index of the circular buffer */
+      /* Find the CPU with the oldest unread note */
 
-  read = drv->ni_read;
-  DEBUGASSERT(read < drv->ni_bufsize);
-
-  /* Get the length of the note at the read index */
+      select = -1;
+      for (cpu = 0; cpu < NCPUS; cpu++)
+        {
+          ring = &drv->ni_ring[cpu];
+          head = atomic_load_explicit(&ring->nr_head, memory_order_acquire);
+          pos  = noteram_readpos(ring);
+          if (pos == head)
+            {
+              continue;
+            }
 
-  note = (FAR struct note_common_s *)&drv->ni_buffer[read];
-  notelen = note->nc_length;
-  DEBUGASSERT(notelen <= circlen);
+          noteram_copy(drv, cpu, pos, &note, sizeof(note));
+          if (select < 0 || note.nc_systime < systime)
+            {
+              select  = cpu;
+              systime = note.nc_systime;
+              read    = pos;
+            }
+        }
 
-  /* Is the user buffer large enough to hold the note? */
+      /* Verify that the circular buffer is not empty */
 
-  if (buflen < notelen)
-    {
-      /* Skip the large note so that we do not get constipated. */
+      if (select < 0)
+        {
+          return 0;
+        }
 
-      drv->ni_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
+      /* Copy the note if the user buffer is large enough to hold it */
 
-      /* and return an error */
+      ring = &drv->ni_ring[select];
+      noteram_copy(drv, select, read, &note, sizeof(note));
+      notelen = note.nc_length;
+      if (buflen >= notelen)
+        {
+          noteram_copy(drv, select, read, buffer, notelen);
+        }
 
-      return -EFBIG;
+      atomic_thread_fence(memory_order_acquire);
+      ring->nr_read = read;
     }
+  while (noteram_readpos(ring) != read);
 
-  /* Loop until the note has been transferred to the user buffer */
-
-  remaining = (unsigned int)notelen;
-  while (remaining > 0)
+  ring->nr_read = read + NOTE_ALIGN(notelen);
+  if (buflen < notelen)
     {
-      /* Copy the next byte at the read index */
-
-      *buffer++ = drv->ni_buffer[read];
-
-      /* Adjust indices and counts */
+      /* Skip the large note so that we do not get constipated. */
 
-      read = noteram_next(drv, read, 1);
-      remaining--;
+      return -EFBIG;
     }
 
-  drv->ni_read = noteram_next(drv, drv->ni_read, NOTE_ALIGN(notelen));
-
   return notelen;
 }
 
@@ -427,10 +433,15 @@ static int noteram_open(FAR struct file *filep)
   FAR struct noteram_dump_context_s *ctx;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)
                                      filep->f_inode->i_private;
+  int cpu;
 
   /* Reset the read index of the circular buffer */
 
-  drv->ni_read = drv->ni_tail;
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      drv->ni_ring[cpu].nr_read = drv->ni_ring[cpu].nr_start;
+    }
+
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -594,6 +605,36 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           }
         break;
 
+#ifdef CONFIG_DRIVERS_NOTERAM_STATS
+      /* NOTERAM_GETSTATS
+       *      - Get the statistics summed over all CPUs
+       *        Argument: A writable pointer to struct noteram_stats_s
+       */
+
+      case NOTERAM_GETSTATS:
+        if (arg == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            FAR struct noteram_stats_s *stats =
+              (FAR struct noteram_stats_s *)arg;
+            int cpu;
+
+            memset(stats, 0, sizeof(*stats));
+            for (cpu = 0; cpu < NCPUS; cpu++)
+              {
+                stats->nnotes  += drv->ni_ring[cpu].nr_nnotes;
+                stats->nlost   += drv->ni_ring[cpu].nr_nlost;
+                stats->ncycles += drv->ni_ring[cpu].nr_ncycles;
+              }
+
+            ret = OK;
+          }
+        break;
+#endif
+
       default:
           break;
     }
@@ -672,7 +713,9 @@ errout:
  * Name: noteram_add
  *
  * Description:
- *   Add the variable length note to the transport layer
+ *   Add the variable length note to the ring of this CPU.  Only the local
+ *   interrupts are disabled, the other CPUs and the reader are never
+ *   waited for.
  *
  * Input Parameters:
  *   note    - The note buffer
@@ -681,9 +724,6 @@ errout:
  * Returned Value:
  *   None
  *
- * Assumptions:
- *   We are within a critical section.
- *
  ****************************************************************************/
 
 static void noteram_add(FAR struct note_driver_s *driver,
@@ -691,51 +731,86 @@ static void noteram_add(FAR struct note_driver_s *driver,
 {
   FAR const char *buf = note;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+  FAR struct noteram_ring_s *ring;
+  FAR uint8_t *buffer;
   unsigned int head;
-  unsigned int remain;
+  unsigned int tail;
   unsigned int space;
   irqstate_t flags;
+  int cpu;
+#ifdef CONFIG_DRIVERS_NOTERAM_STATS
+  clock_t start = perf_gettime();
+#endif
 
-  flags = spin_lock_irqsave_wo_note(&drv->lock);
+  flags  = up_irq_save();
+  cpu    = this_cpu();
+  ring   = &drv->ni_ring[cpu];
+  buffer = noteram_ringbuf(drv, cpu);
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
-      spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+#ifdef CONFIG_DRIVERS_NOTERAM_STATS
+      ring->nr_nlost++;
+#endif
+      up_irq_restore(flags);
       return;
     }
 
-  DEBUGASSERT(note != NULL && notelen < drv->ni_bufsize);
-  remain = drv->ni_bufsize - noteram_length(drv);
+  DEBUGASSERT(note != NULL && notelen < drv->ni_ringsize);
+  head = atomic_load(&ring->nr_head);
+  tail = atomic_load(&ring->nr_tail);
 
-  if (remain <= NOTE_ALIGN(notelen))
+  if (drv->ni_ringsize - (head - tail) <= NOTE_ALIGN(notelen))
     {
       if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
         {
           /* Stop recording if not in overwrite mode */
 
           drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
-          spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+#ifdef CONFIG_DRIVERS_NOTERAM_STATS
+          ring->nr_nlost++;
+#endif
+          up_irq_restore(flags);
           return;
         }
 
-      /* Remove the note at the tail index , make sure there is enough space
+      /* Remove the notes at the tail index, make sure there is enough
+       * space
        */
 
       do
         {
-          noteram_remove(drv);
-          remain = drv->ni_bufsize - noteram_length(drv);
+          space = NOTE_ALIGN(buffer[noteram_index(drv, tail)]);
+#ifdef CONFIG_DRIVERS_NOTERAM_STATS
+          if ((int)(ring->nr_read - tail) <= 0)
+            {
+              ring->nr_nlost++;
+            }
+#endif
+
+          tail += space;
         }
-      while (remain <= NOTE_ALIGN(notelen));
+      while (drv->ni_ringsize - (head - tail) <= NOTE_ALIGN(notelen));
+
+      /* Publish the new tail before its space is overwritten */
+
+      atomic_store(&ring->nr_tail, tail);
+      atomic_thread_fence(memory_order_release);
     }
 
-  head = drv->ni_head;
-  space = drv->ni_bufsize - head;
+  space = drv->ni_ringsize - noteram_index(drv, head);
   space = space < notelen ? space : notelen;
-  memcpy(drv->ni_buffer + head, note, space);
-  memcpy(drv->ni_buffer, buf + space, notelen - space);
-  drv->ni_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
-  spin_unlock_irqrestore_wo_note(&drv->lock, flags);
+  memcpy(buffer + noteram_index(drv, head), note, space);
+  memcpy(buffer, buf + space, notelen - space);
+  atomic_store_explicit(&ring->nr_head, head + NOTE_ALIGN(notelen),
+                        memory_order_release);
+
+#ifdef CONFIG_DRIVERS_NOTERAM_STATS
+  ring->nr_nnotes++;
+  ring->nr_ncycles += perf_gettime() - start;
+#endif
+
+  up_irq_restore(flags);
   poll_notify(&drv->pfd, 1, POLLIN);
 }
 
@@ -1366,11 +1441,10 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
 
   drv->driver.ops = &g_noteram_ops;
   drv->ni_bufsize = bufsize;
+  drv->ni_ringsize = NOTERAM_RINGSIZE(bufsize);
   drv->ni_buffer = (FAR uint8_t *)(drv + 1) + len;
   drv->ni_overwrite = overwrite;
-  drv->ni_head = 0;
-  drv->ni_tail = 0;
-  drv->ni_read = 0;
+  memset(drv->ni_ring, 0, sizeof(drv->ni_ring));
   drv->pfd = NULL;
 
   ret = note_driver_register(&drv->driver);
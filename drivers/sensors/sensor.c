@@ -34,12 +34,14 @@
 
 #include <poll.h>
 #include <fcntl.h>
+#include <nuttx/atomic.h>
 #include <nuttx/list.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/circbuf.h>
 #include <nuttx/mutex.h>
 #include <nuttx/sensors/sensor.h>
 #include <nuttx/lib/lib.h>
+#include <nuttx/lib/math32.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -101,6 +103,9 @@ struct sensor_user_s
   bool             flushing;   /* The is used to indicate user is flushing */
   sem_t            buffersem;  /* Wakeup user waiting for data in circular buffer */
   size_t           bufferpos;  /* The index of user generation in buffer */
+#ifdef CONFIG_SENSORS_MMAP
+  bool             mapped;     /* The user takes the events from the mapped buffer */
+#endif
 
   /* The subscriber info
    * Support multi advertisers to subscribe their own data when they
@@ -120,6 +125,11 @@ struct sensor_upperhalf_s
   struct circbuf_s   buffer;             /* The circular buffer of data */
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_ring_s *ring;        /* The mappable buffer, holds buffer data */
+  sem_t              ringsem;            /* Wakeup users waiting in SNIOC_WAIT_UPDATE */
+  uint32_t           nringwaiters;       /* The number of users waiting on ringsem */
+#endif
 };
 
 /****************************************************************************
@@ -136,6 +146,10 @@ static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
                             size_t buflen);
 static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
+#ifdef CONFIG_SENSORS_MMAP
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
@@ -222,7 +236,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_MMAP
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -563,6 +581,65 @@ static ssize_t sensor_do_samples(FAR struct sensor_upperhalf_s *upper,
   return ret;
 }
 
+static int sensor_buffer_init(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR void *base = NULL;
+  size_t size;
+  int ret;
+
+#ifdef CONFIG_SENSORS_MMAP
+  /* A mapped user takes event n at n & (nbuffer - 1), which stays right
+   * when the free running event count wraps around.
+   */
+
+  if (!IS_POWER_OF_2(lower->nbuffer))
+    {
+      lower->nbuffer = 1 << LOG2_CEIL(lower->nbuffer);
+      upper->state.nbuffer = lower->nbuffer;
+    }
+#endif
+
+  size = lower->nbuffer * upper->state.esize;
+
+#ifdef CONFIG_SENSORS_MMAP
+  /* Keep the data behind the ring header, so both can be mapped at once */
+
+  upper->ring = kumm_zalloc(sizeof(struct sensor_ring_s) + size);
+  if (upper->ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->ring->esize   = upper->state.esize;
+  upper->ring->nbuffer = lower->nbuffer;
+  base = upper->ring + 1;
+#endif
+
+  ret = circbuf_init(&upper->buffer, base, size);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+#ifdef CONFIG_SENSORS_MMAP
+  kumm_free(upper->ring);
+  upper->ring = NULL;
+#endif
+  return ret;
+}
+
 static void sensor_pollnotify_one(FAR struct sensor_user_s *user,
                                   pollevent_t eventset,
                                   sensor_role_t role)
@@ -997,6 +1074,46 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_SENSORS_MMAP
+     case SNIOC_WAIT_UPDATE:
+        {
+          nxrmutex_lock(&upper->lock);
+          while (upper->ring == NULL || upper->ring->head == arg1)
+            {
+              if (filep->f_oflags & O_NONBLOCK)
+                {
+                  ret = -EAGAIN;
+                  break;
+                }
+
+              upper->nringwaiters++;
+              nxrmutex_unlock(&upper->lock);
+              ret = nxsem_wait(&upper->ringsem);
+              nxrmutex_lock(&upper->lock);
+              if (ret < 0)
+                {
+                  /* Stop waiting, or take back the count posted for this
+                   * user by a publish in between.
+                   */
+
+                  if (upper->nringwaiters > 0)
+                    {
+                      upper->nringwaiters--;
+                    }
+                  else
+                    {
+                      nxsem_trywait(&upper->ringsem);
+                    }
+
+                  break;
+                }
+            }
+
+          nxrmutex_unlock(&upper->lock);
+        }
+        break;
+#endif
+
       default:
 
         /* Lowerhalf driver process other cmd. */
@@ -1016,6 +1133,51 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR struct sensor_user_s *user = filep->f_priv;
+  size_t size;
+  int ret = 0;
+
+  /* The sensors fetched directly don't have a circular buffer */
+
+  if (lower->ops->fetch)
+    {
+      return -ENOTSUP;
+    }
+
+  nxrmutex_lock(&upper->lock);
+  if (!circbuf_is_init(&upper->buffer))
+    {
+      ret = sensor_buffer_init(upper);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  size = sizeof(struct sensor_ring_s) + upper->buffer.size;
+  if (map->offset < 0 || map->offset >= size ||
+      map->length == 0 || map->offset + map->length > size)
+    {
+      ret = -EINVAL;
+      goto out;
+    }
+
+  map->vaddr = (FAR char *)upper->ring + map->offset;
+  user->mapped = true;
+
+out:
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static int sensor_poll(FAR struct file *filep,
                        FAR struct pollfd *fds, bool setup)
 {
@@ -1057,6 +1219,12 @@ static int sensor_poll(FAR struct file *filep,
                 }
             }
         }
+#ifdef CONFIG_SENSORS_MMAP
+      else if (user->mapped)
+        {
+          /* The mapped users wait with SNIOC_WAIT_UPDATE */
+        }
+#endif
       else if (sensor_is_updated(upper, user))
         {
           eventset |= POLLIN;
@@ -1119,28 +1287,46 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
     {
       /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
-      if (ret < 0)
-        {
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
-
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
+      ret = sensor_buffer_init(upper);
       if (ret < 0)
         {
-          circbuf_uninit(&upper->buffer);
           nxrmutex_unlock(&upper->lock);
           return ret;
         }
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  /* Tell the mapped users which events are being overwritten */
+
+  upper->ring->begin = upper->ring->head + envcount;
+  atomic_thread_fence(memory_order_release);
+#endif
+
   circbuf_overwrite(&upper->buffer, data, bytes);
   sensor_generate_timing(upper, envcount);
+
+#ifdef CONFIG_SENSORS_MMAP
+  atomic_thread_fence(memory_order_release);
+  upper->ring->head += envcount;
+
+  /* Wake up all the mapped users at once */
+
+  while (upper->nringwaiters > 0)
+    {
+      upper->nringwaiters--;
+      nxsem_post(&upper->ringsem);
+    }
+#endif
+
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
+#ifdef CONFIG_SENSORS_MMAP
+      if (user->mapped)
+        {
+          continue;
+        }
+#endif
+
       if (sensor_is_updated(upper, user))
         {
           nxsem_get_value(&user->buffersem, &semcount);
@@ -1318,6 +1504,9 @@ int sensor_custom_register(FAR struct sensor_lowerhalf_s *lower,
     }
 
   nxrmutex_init(&upper->lock);
+#ifdef CONFIG_SENSORS_MMAP
+  nxsem_init(&upper->ringsem, 0, 0);
+#endif
 
   /* Bind the lower half data structure member */
 
@@ -1367,6 +1556,9 @@ rpmsg_err:
 #endif
 
   nxrmutex_destroy(&upper->lock);
+#ifdef CONFIG_SENSORS_MMAP
+  nxsem_destroy(&upper->ringsem);
+#endif
 
   kmm_free(upper);
 
@@ -1443,5 +1635,10 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
       circbuf_uninit(&upper->timing);
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  nxsem_destroy(&upper->ringsem);
+  kumm_free(upper->ring);
+#endif
+
   kmm_free(upper);
 }
@@ -31,6 +31,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/net/wifi_sim.h>
 
@@ -43,6 +44,15 @@
 /* Virtio net feature bits */
 
 #define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CTRL_VQ  17
+#define VIRTIO_NET_F_MQ       22
+
+/* Virtio net control commands */
+
+#define VIRTIO_NET_CTRL_MQ    4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+
+#define VIRTIO_NET_OK         0
 
 /* Virtio net header size and packet buffer size */
 
@@ -50,12 +60,29 @@
 #define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
 
-/* Virtio net virtqueue index and number */
+/* Virtio net virtqueue index and number.  The queue pair n uses the
+ * virtqueues 2n and 2n + 1, the control virtqueue follows the last pair
+ * supported by the device.  With CONFIG_NETDEV_RSS a pair is used for
+ * each CPU, as the upper half serves the queue n on the CPU n.
+ */
 
 #define VIRTIO_NET_RX         0
 #define VIRTIO_NET_TX         1
 #define VIRTIO_NET_NUM        2
 
+#define VIRTIO_NET_RXQ(n)     (2 * (n) + VIRTIO_NET_RX)
+#define VIRTIO_NET_TXQ(n)     (2 * (n) + VIRTIO_NET_TX)
+
+#ifdef CONFIG_NETDEV_RSS
+#  define VIRTIO_NET_MAXPAIRS CONFIG_SMP_NCPUS
+#else
+#  define VIRTIO_NET_MAXPAIRS 1
+#endif
+
+/* Refill the RX virtqueue once this number of buffers are consumed */
+
+#define VIRTIO_NET_RXBATCH(priv) (((priv)->bufnum + 1) / 2)
+
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
@@ -97,6 +124,18 @@ begin_packed_struct struct virtio_net_config_s
   uint32_t supported_hash_types;
 } end_packed_struct;
 
+/* Virtio net control command, the class and command are read by the
+ * device, the ack is written back.
+ */
+
+begin_packed_struct struct virtio_net_ctrl_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t pairs;                            /* VIRTIO_NET_CTRL_MQ */
+  uint8_t  ack;
+} end_packed_struct;
+
 struct virtio_net_priv_s
 {
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -110,12 +149,20 @@ struct virtio_net_priv_s
   struct netdev_lowerhalf_s lower;     /* The netdev lowerhalf */
 #endif
 
-  spinlock_t                lock[VIRTIO_NET_NUM];
+  spinlock_t                lock[VIRTIO_NET_NUM * VIRTIO_NET_MAXPAIRS];
 
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
-  int                       bufnum;    /* TX and RX Buffer number */
+  int                       bufnum;    /* TX and RX Buffer number of a pair */
+  int                       npairs;    /* Number of queue pairs in use */
+
+  /* Number of buffers in each RX virtqueue */
+
+  uint16_t                  rxposted[VIRTIO_NET_MAXPAIRS];
+#ifdef CONFIG_NETDEV_RSS
+  sem_t                     ctrlsem;   /* Control command completion */
+#endif
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -163,6 +210,10 @@ static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev,
                             int cmd, unsigned long arg);
 #endif
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev);
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt, int pair);
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int pair);
 
 static int  virtio_net_probe(FAR struct virtio_device *vdev);
 static void virtio_net_remove(FAR struct virtio_device *vdev);
@@ -192,7 +243,11 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+#ifdef CONFIG_NETDEV_RSS
+  virtio_net_send_queue,
+  virtio_net_recv_queue
+#endif
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -264,7 +319,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     }
 
   vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+  if (vq_id % VIRTIO_NET_NUM == VIRTIO_NET_RX)
     {
       return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
                                        &priv->lock[vq_id]);
@@ -280,14 +335,16 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
  * Name: virtio_net_rxfill
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev,
+                              int pair)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  unsigned int qid = VIRTIO_NET_RXQ(pair);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[qid].vq;
   FAR netpkt_t *pkt;
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  for (i = 0; priv->rxposted[pair] < priv->bufnum; i++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
@@ -310,31 +367,38 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Add buffer to RX virtqueue */
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      if (virtio_net_addbuffer(dev, vq, pkt, qid) < 0)
+        {
+          netpkt_free(dev, pkt, NETPKT_RX);
+          break;
+        }
+
+      priv->rxposted[pair]++;
     }
 
   if (i > 0)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      virtqueue_kick_lock(vq, &priv->lock[qid]);
     }
 }
 
 /****************************************************************************
- * Name: virtio_net_txfree
+ * Name: virtio_net_txfree_queue
  ****************************************************************************/
 
-static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_txfree_queue(FAR struct netdev_lowerhalf_s *dev,
+                                    int pair)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  unsigned int qid = VIRTIO_NET_TXQ(pair);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[qid].vq;
   FAR struct virtio_net_llhdr_s *hdr;
 
   while (1)
     {
       /* Get buffer from tx virtqueue */
 
-      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
+      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock[qid]);
       if (hdr == NULL)
         {
           break;
@@ -345,6 +409,21 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
     }
 }
 
+/****************************************************************************
+ * Name: virtio_net_txfree
+ ****************************************************************************/
+
+static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtio_net_txfree_queue(dev, i);
+    }
+}
+
 /****************************************************************************
  * Name: virtio_net_ifup
  ****************************************************************************/
@@ -352,6 +431,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -368,9 +448,13 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
-  virtio_net_rxfill(dev);
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtqueue_enable_cb_lock(
+        priv->vdev->vrings_info[VIRTIO_NET_RXQ(i)].vq,
+        &priv->lock[VIRTIO_NET_RXQ(i)]);
+      virtio_net_rxfill(dev, i);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -393,7 +477,7 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < VIRTIO_NET_NUM * priv->npairs; i++)
     {
       virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
                                 &priv->lock[i]);
@@ -413,14 +497,17 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 }
 
 /****************************************************************************
- * Name: virtio_net_send
+ * Name: virtio_net_send_queue
  ****************************************************************************/
 
-static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
-                           FAR netpkt_t *pkt)
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt, int pair)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  unsigned int qid = VIRTIO_NET_TXQ(pair);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[qid].vq;
+  int ret;
+  int i;
 
   /* Check the send length */
 
@@ -432,58 +519,99 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* Add buffer to vq and notify the other side */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
-
-  /* Try return Netpkt TX buffer to upper-half. */
+  ret = virtio_net_addbuffer(dev, vq, pkt, qid);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
-  virtio_net_txfree(dev);
+  virtqueue_kick_lock(vq, &priv->lock[qid]);
 
-  /* If we have no buffer left, enable TX done callback. */
+  /* The sent buffers are reaped in bulk by the reclaim of each poll, only
+   * try to return them here when we run out of the TX buffer.
+   */
 
   if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      virtio_net_txfree(dev);
+
+      /* If we have no buffer left, enable TX done callback.  The buffers
+       * may be in flight on any of the queues.
+       */
+
+      if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
+        {
+          for (i = 0; i < priv->npairs; i++)
+            {
+              virtqueue_enable_cb_lock(
+                priv->vdev->vrings_info[VIRTIO_NET_TXQ(i)].vq,
+                &priv->lock[VIRTIO_NET_TXQ(i)]);
+            }
+        }
     }
 
   return OK;
 }
 
 /****************************************************************************
- * Name: virtio_net_recv
+ * Name: virtio_net_send
  ****************************************************************************/
 
-static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  return virtio_net_send_queue(dev, pkt, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_net_recv_queue
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int pair)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  unsigned int qid = VIRTIO_NET_RXQ(pair);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[qid].vq;
   FAR struct virtio_net_llhdr_s *hdr;
   irqstate_t flags;
   uint32_t len;
 
-  /* Fill the free Netpkt RX buffer to the RX virtqueue */
+  /* Fill the free Netpkt RX buffer to the RX virtqueue in batch, once
+   * half of the buffers are consumed, to save the kick for each packet.
+   */
 
-  virtio_net_rxfill(dev);
+  if (priv->bufnum - priv->rxposted[pair] >= VIRTIO_NET_RXBATCH(priv) &&
+      netdev_lower_quota_load(dev, NETPKT_RX) >= VIRTIO_NET_RXBATCH(priv))
+    {
+      virtio_net_rxfill(dev, pair);
+    }
 
   /* Get received buffer form RX virtqueue */
 
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
+  flags = spin_lock_irqsave(&priv->lock[qid]);
   hdr = virtqueue_get_buffer(vq, &len, NULL);
   if (hdr == NULL)
     {
       /* If we have no buffer left, enable RX callback. */
 
       virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[qid], flags);
+
+      /* Drained, give all the free buffers back to the device */
+
+      virtio_net_rxfill(dev, pair);
 
       vrtinfo("get NULL buffer\n");
       return NULL;
     }
   else
     {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[qid], flags);
     }
 
+  priv->rxposted[pair]--;
+
   /* Set the received pkt length */
 
   netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
@@ -491,6 +619,15 @@ static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
   return hdr->pkt;
 }
 
+/****************************************************************************
+ * Name: virtio_net_recv
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  return virtio_net_recv_queue(dev, 0);
+}
+
 #ifdef CONFIG_NET_MCASTGROUP
 /****************************************************************************
  * Name: virtio_net_addmac
@@ -533,7 +670,17 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+
+#ifdef CONFIG_NETDEV_RSS
+  if (priv->npairs > 1)
+    {
+      netdev_lower_rxready_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                 vq->vq_queue_index / VIRTIO_NET_NUM);
+      return;
+    }
+#endif
+
   netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
 }
 
@@ -545,10 +692,84 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+
+#ifdef CONFIG_NETDEV_RSS
+  if (priv->npairs > 1)
+    {
+      netdev_lower_txdone_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                vq->vq_queue_index / VIRTIO_NET_NUM);
+      return;
+    }
+#endif
+
   netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
 }
 
+#ifdef CONFIG_NETDEV_RSS
+/****************************************************************************
+ * Name: virtio_net_ctrldone
+ ****************************************************************************/
+
+static void virtio_net_ctrldone(FAR struct virtqueue *vq)
+{
+  FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
+
+  if (virtqueue_get_buffer(vq, NULL, NULL) != NULL)
+    {
+      nxsem_post(&priv->ctrlsem);
+    }
+}
+
+/****************************************************************************
+ * Name: virtio_net_setpairs
+ *
+ * Description:
+ *   Tell the device the number of queue pairs to use.  It then steers the
+ *   packets of a flow to the RX queue of the pair that last sent on it.
+ *
+ ****************************************************************************/
+
+static int virtio_net_setpairs(FAR struct virtio_net_priv_s *priv)
+{
+  FAR struct virtio_device *vdev = priv->vdev;
+  FAR struct virtqueue *vq =
+    vdev->vrings_info[VIRTIO_NET_NUM * priv->npairs].vq;
+  FAR struct virtio_net_ctrl_s *ctrl;
+  struct virtqueue_buf vb[3];
+  int ret;
+
+  ctrl = virtio_zalloc_buf(vdev, sizeof(*ctrl), 16);
+  if (ctrl == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ctrl->class = VIRTIO_NET_CTRL_MQ;
+  ctrl->cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  ctrl->pairs = priv->npairs;
+  ctrl->ack   = 0xff;
+
+  vb[0].buf = &ctrl->class;
+  vb[0].len = 2;
+  vb[1].buf = &ctrl->pairs;
+  vb[1].len = sizeof(ctrl->pairs);
+  vb[2].buf = &ctrl->ack;
+  vb[2].len = sizeof(ctrl->ack);
+
+  ret = virtqueue_add_buffer(vq, vb, 2, 1, ctrl);
+  if (ret >= 0)
+    {
+      virtqueue_kick(vq);
+      nxsem_wait_uninterruptible(&priv->ctrlsem);
+      ret = ctrl->ack == VIRTIO_NET_OK ? OK : -EIO;
+    }
+
+  virtio_free_buf(vdev, ctrl);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -556,49 +777,126 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char *vqnames[VIRTIO_NET_NUM * VIRTIO_NET_MAXPAIRS + 1];
+  vq_callback callbacks[VIRTIO_NET_NUM * VIRTIO_NET_MAXPAIRS + 1];
+  uint32_t features;
+  int bufnum;
+  int nvqs;
   int ret;
+  int i;
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
-  priv->vdev = vdev;
-  vdev->priv = priv;
+  priv->vdev   = vdev;
+  priv->npairs = 1;
+  vdev->priv   = priv;
 
   /* Initialize the virtio device */
 
+  features = (1UL << VIRTIO_NET_F_MAC) | (1UL << VIRTIO_F_ANY_LAYOUT);
+#ifdef CONFIG_NETDEV_RSS
+  features |= (1UL << VIRTIO_NET_F_CTRL_VQ) | (1UL << VIRTIO_NET_F_MQ);
+#endif
+
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
-                                  (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
+  virtio_negotiate_features(vdev, features, NULL);
+
+#ifdef CONFIG_NETDEV_RSS
+  /* Use a queue pair for each CPU.  The control virtqueue follows all the
+   * pairs of the device, so fall back to a single pair without it if the
+   * device has more pairs than CPUs.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_MQ))
+    {
+      uint16_t maxpairs;
+
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &maxpairs);
+      if (maxpairs > 1 && maxpairs <= VIRTIO_NET_MAXPAIRS)
+        {
+          priv->npairs = maxpairs;
+        }
+    }
+
+  if (priv->npairs == 1)
+    {
+      features &= ~((1UL << VIRTIO_NET_F_CTRL_VQ) |
+                    (1UL << VIRTIO_NET_F_MQ));
+      virtio_negotiate_features(vdev, features, NULL);
+    }
+
+  nxsem_init(&priv->ctrlsem, 0, 0);
+#endif
+
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks, NULL);
+  for (i = 0; i < priv->npairs; i++)
+    {
+      spin_lock_init(&priv->lock[VIRTIO_NET_RXQ(i)]);
+      spin_lock_init(&priv->lock[VIRTIO_NET_TXQ(i)]);
+      vqnames[VIRTIO_NET_RXQ(i)]   = "virtio_net_rx";
+      vqnames[VIRTIO_NET_TXQ(i)]   = "virtio_net_tx";
+      callbacks[VIRTIO_NET_RXQ(i)] = virtio_net_rxready;
+      callbacks[VIRTIO_NET_TXQ(i)] = virtio_net_txdone;
+    }
+
+  nvqs = VIRTIO_NET_NUM * priv->npairs;
+#ifdef CONFIG_NETDEV_RSS
+  if (priv->npairs > 1)
+    {
+      vqnames[nvqs]   = "virtio_net_ctrl";
+      callbacks[nvqs] = virtio_net_ctrldone;
+      nvqs++;
+    }
+#endif
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks, NULL);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
+#ifdef CONFIG_NETDEV_RSS
+      nxsem_destroy(&priv->ctrlsem);
+#endif
       return ret;
     }
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+#ifdef CONFIG_NETDEV_RSS
+  if (priv->npairs > 1)
+    {
+      ret = virtio_net_setpairs(priv);
+      if (ret < 0)
+        {
+          /* The device keeps using the first pair only */
+
+          vrtwarn("Set %d queue pairs failed, ret=%d\n", priv->npairs, ret);
+          priv->npairs = 1;
+        }
+    }
+#endif
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
-  priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
+  bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
   /* Calculate the virtio network buffer number:
    * 1/4 for the TX netpkts, 1/4 for the RX netpkts.
    */
 
-  priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
+  bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
 #endif
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+
+  /* The buffers are shared by the pairs, but a single TX virtqueue could
+   * hold all of them.
+   */
+
+  for (i = 0; i < VIRTIO_NET_NUM * priv->npairs; i++)
+    {
+      bufnum = MIN(vdev->vrings_info[i].info.num_descs /
+                   (VIRTIO_NET_MAX_NIOB + 1), bufnum);
+    }
+
+  priv->bufnum = MAX(bufnum / priv->npairs, 1);
   return OK;
 }
 
@@ -666,9 +964,13 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   /* Initialize the netdev lower half */
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
-  netdev->quota[NETPKT_RX] = priv->bufnum;
-  netdev->quota[NETPKT_TX] = priv->bufnum;
+  netdev->quota[NETPKT_RX] = priv->bufnum * priv->npairs;
+  netdev->quota[NETPKT_TX] = priv->bufnum * priv->npairs;
   netdev->ops = &g_virtio_net_ops;
+#ifdef CONFIG_NETDEV_RSS
+  netdev->rxqueues = priv->npairs;
+  netdev->txqueues = priv->npairs;
+#endif
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
@@ -713,6 +1015,9 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
 err_with_virtqueues:
   virtio_reset_device(vdev);
   virtio_delete_virtqueues(vdev);
+#ifdef CONFIG_NETDEV_RSS
+  nxsem_destroy(&priv->ctrlsem);
+#endif
 err_with_priv:
   kmm_free(priv);
   return ret;
@@ -729,6 +1034,9 @@ static void virtio_net_remove(FAR struct virtio_device *vdev)
   netdev_lower_unregister((FAR struct netdev_lowerhalf_s *)priv);
   virtio_reset_device(vdev);
   virtio_delete_virtqueues(vdev);
+#ifdef CONFIG_NETDEV_RSS
+  nxsem_destroy(&priv->ctrlsem);
+#endif
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   g_netdev_num--;
   wifi_sim_remove(&priv->lower);
@@ -48,6 +48,22 @@
 #  define CONFIG_FS_NAIOC 8
 #endif
 
+/* Number of threads of the AIO worker pool, zero to use the low priority
+ * work queue.
+ */
+
+#ifndef CONFIG_FS_AIO_NWORKERS
+#  define CONFIG_FS_AIO_NWORKERS 0
+#endif
+
+/* Only the low priority work queue is boosted to the priority of the task
+ * waiting for the I/O, the AIO worker pool runs at a fixed priority.
+ */
+
+#if defined(CONFIG_PRIORITY_INHERITANCE) && CONFIG_FS_AIO_NWORKERS == 0
+#  define AIO_PRIORITY_INHERITANCE 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -58,16 +74,31 @@
  */
 
 struct file;
+struct aio_stream_s;
+struct aio_ring_s;
 struct aio_container_s
 {
   dq_entry_t aioc_link;            /* Supports a doubly linked list */
   FAR struct aiocb *aioc_aiocbp;   /* The contained AIO control block */
   FAR struct file *aioc_filep;     /* File structure to use with the I/O */
+#if CONFIG_FS_AIO_NWORKERS > 0
+  dq_entry_t aioc_qlink;           /* Links the requests on the same file */
+
+  /* The queue of the file, NULL once the request has been started */
+
+  FAR struct aio_stream_s *aioc_stream;
+  worker_t aioc_worker;            /* Performs the request */
+  uint8_t aioc_op;                 /* LIO_READ, LIO_WRITE or LIO_NOP */
+#else
   struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+#endif
   pid_t aioc_pid;                  /* ID of the waiting task */
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
 #endif
+#ifdef CONFIG_FS_AIO_RING
+  FAR struct aio_ring_s *aioc_ring; /* Completes to this ring, if not NULL */
+#endif
 };
 
 /****************************************************************************
@@ -202,15 +233,37 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp);
 
 FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
+/****************************************************************************
+ * Name: aioc_complete
+ *
+ * Description:
+ *   Free the container of a request done or canceled, then post the result
+ *   to the client: by signal, or to the completion queue of its ring.
+ *
+ * Input Parameters:
+ *   aioc   - Pointer to the AIO control block container
+ *   result - The result of the request
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aioc_complete(FAR struct aio_container_s *aioc, ssize_t result);
+
 /****************************************************************************
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the AIO worker pool, behind the
+ *   requests already queued on the same file, or on the low priority work
+ *   queue if there is no worker pool.
  *
  * Input Parameters:
- *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ *   aioc   - The AIO control block container
+ *   op     - LIO_READ or LIO_WRITE if the request is a positioned transfer
+ *            that may be coalesced with its neighbours, LIO_NOP otherwise
+ *   worker - The function performing the request, receiving the container
  *
  * Returned Value:
  *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
@@ -218,7 +271,25 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  *
  ****************************************************************************/
 
-int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
+int aio_queue(FAR struct aio_container_s *aioc, int op, worker_t worker);
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove a request not yet started from its queue.  The caller must hold
+ *   the lock from aio_lock().
+ *
+ * Input Parameters:
+ *   aioc - The AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the request will not run, a negated errno value if it
+ *   has already been started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc);
 
 /****************************************************************************
  * Name: aio_signal
@@ -239,6 +310,42 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
 int aio_signal(pid_t pid, FAR struct aiocb *aiocbp);
 
+#ifdef CONFIG_FS_AIO_RING
+/****************************************************************************
+ * Name: aio_ring_register
+ *
+ * Description:
+ *   Register the AIO ring driver at /dev/aio.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int aio_ring_register(void);
+
+/****************************************************************************
+ * Name: aio_ring_complete
+ *
+ * Description:
+ *   Post the completion of a request submitted from a ring.
+ *
+ * Input Parameters:
+ *   ring   - The ring the request was submitted from
+ *   aiocbp - The AIO control block of the request, holding the result
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_ring_complete(FAR struct aio_ring_s *ring,
+                       FAR struct aiocb *aiocbp);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -89,7 +89,6 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
 
   FAR struct aio_container_s *aioc;
   FAR struct aio_container_s *next;
-  pid_t pid;
   int status;
   int ret;
 
@@ -124,27 +123,20 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
               /* Yes... attempt to cancel the I/O.  There are two
                * possibilities:* (1) the work has already been started and
                * is no longer queued, or (2) the work has not been started
-               * and is still in the work queue.  Only the second case can
-               * be canceled.  work_cancel() will return -ENOENT in the
-               * first case.
+               * and is still queued.  Only the second case can be
+               * canceled.  aio_dequeue() will return -ENOENT in the first
+               * case.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
+              status = aio_dequeue(aioc);
               if (status >= 0)
                 {
                   /* Remove the container from the list of pending
-                   * transfers
+                   * transfers and notify the client
                    */
 
-                  pid = aioc->aioc_pid;
-                  aioc_decant(aioc);
-
-                  aiocbp->aio_result = -ECANCELED;
+                  aioc_complete(aioc, -ECANCELED);
                   ret = AIO_CANCELED;
-
-                  /* Signal the client */
-
-                  aio_signal(pid, aiocbp);
                 }
               else
                 {
@@ -181,33 +173,25 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
               /* Yes... attempt to cancel the I/O.  There are two
                * possibilities:* (1) the work has already been started and
                * is no longer queued, or (2) the work has not been started
-               * and is still in the work queue.  Only the second case can
-               * be canceled.  work_cancel() will return -ENOENT in the
-               * first case.
+               * and is still queued.  Only the second case can be
+               * canceled.  aio_dequeue() will return -ENOENT in the first
+               * case.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
+              status = aio_dequeue(aioc);
               if (status >= 0)
                 {
                   /* Remove the container from the list of pending
-                   * transfers
+                   * transfers and notify the client
                    */
 
-                  next   =
+                  next =
                     (FAR struct aio_container_s *)aioc->aioc_link.flink;
-                  pid    = aioc->aioc_pid;
-                  aiocbp = aioc_decant(aioc);
-                  DEBUGASSERT(aiocbp);
-
-                  aiocbp->aio_result = -ECANCELED;
+                  aioc_complete(aioc, -ECANCELED);
                   if (ret != AIO_NOTCANCELED)
                     {
                       ret = AIO_CANCELED;
                     }
-
-                  /* Signal the client */
-
-                  aio_signal(pid, aiocbp);
                 }
               else
                 {
@@ -62,26 +62,29 @@ static void aio_fsync_worker(FAR void *arg)
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
   pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   uint8_t prio;
 #endif
   int ret;
 
-  /* Get the information from the container, decant the AIO control block,
-   * and free the container before starting any I/O.  That will minimize
-   * the delays by any other threads waiting for a pre-allocated container.
+  /* Get the information from the container.  The container holds the
+   * reference on the file, it is freed once the I/O is done.
    */
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   prio   = aioc->aioc_prio;
 #endif
-  aiocbp = aioc_decant(aioc);
+  aiocbp = aioc->aioc_aiocbp;
 
   /* Perform the fsync using aioc_filep */
 
   ret = file_fsync(aioc->aioc_filep);
+
+  /* Free the container and the reference on the file */
+
+  aioc_decant(aioc);
   if (ret < 0)
     {
       ferr("ERROR: file_fsync failed: %d\n", ret);
@@ -96,7 +99,7 @@ static void aio_fsync_worker(FAR void *arg)
 
   aio_signal(pid, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   /* Restore the low priority worker thread default priority */
 
   lpwork_restorepriority(prio);
@@ -220,7 +223,7 @@ int aio_fsync(int op, FAR struct aiocb *aiocbp)
 
   /* Defer the work to the worker thread */
 
-  ret = aio_queue(aioc, aio_fsync_worker);
+  ret = aio_queue(aioc, LIO_NOP, aio_fsync_worker);
   if (ret < 0)
     {
       /* The result and the errno have already been set */
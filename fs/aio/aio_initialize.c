@@ -98,6 +98,12 @@ void aio_initialize(void)
 
       dq_addlast(&g_aioc_alloc[i].aioc_link, &g_aioc_free);
     }
+
+#ifdef CONFIG_FS_AIO_RING
+  /* Register the driver of the submission and completion rings */
+
+  DEBUGVERIFY(aio_ring_register());
+#endif
 }
 
 /****************************************************************************
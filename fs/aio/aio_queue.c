@@ -24,31 +24,322 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
 #include <sched.h>
 #include <aio.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/nuttx.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/wqueue.h>
 
 #include "aio/aio.h"
 
 #ifdef CONFIG_FS_AIO
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_FS_AIO_NWORKERS > 0
+#  define AIO_NSTREAMS (CONFIG_FS_NAIOC + CONFIG_FS_AIO_NWORKERS)
+#  define aio_container(e) \
+     container_of(e, struct aio_container_s, aioc_qlink)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if CONFIG_FS_AIO_NWORKERS > 0
+/* A stream holds the requests queued on one open file, in the order they
+ * were submitted.  The stream is run by one worker at a time, so that the
+ * requests on a file are performed in order.
+ */
+
+struct aio_stream_s
+{
+  dq_queue_t as_queue;             /* The requests not yet started */
+  struct work_s as_work;           /* Runs the stream on the worker pool */
+  FAR struct file *as_filep;       /* The file, NULL if the stream is free */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_FS_AIO_NWORKERS > 0
+/* The AIO worker pool, created at the first request */
+
+static FAR struct kwork_wqueue_s *g_aio_wqueue;
+
+/* A stream in use either holds a queued container or is run by a worker,
+ * which frees the last container of the stream before it releases it.  A
+ * stream emptied by aio_cancel() is released at once.  Protected by
+ * aio_lock().
+ */
+
+static struct aio_stream_s g_aio_streams[AIO_NSTREAMS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#if CONFIG_FS_AIO_NWORKERS > 0
+/****************************************************************************
+ * Name: aio_adjacent
+ *
+ * Description:
+ *   Return true if the request next continues the transfer of the request
+ *   prev, so that both can be performed with a single transfer.
+ *
+ ****************************************************************************/
+
+static bool aio_adjacent(FAR struct aio_container_s *prev,
+                         FAR struct aio_container_s *next)
+{
+  FAR struct aiocb *aiocbp = prev->aioc_aiocbp;
+
+  return next->aioc_op == prev->aioc_op &&
+         next->aioc_aiocbp->aio_offset ==
+         aiocbp->aio_offset + (off_t)aiocbp->aio_nbytes;
+}
+
+/****************************************************************************
+ * Name: aio_transfer
+ *
+ * Description:
+ *   Perform a run of adjacent reads, or writes, with a single transfer of
+ *   nbytes and complete each of the requests.
+ *
+ ****************************************************************************/
+
+static void aio_transfer(FAR dq_queue_t *run, size_t nbytes)
+{
+  FAR struct aio_container_s *aioc;
+  FAR struct aiocb *aiocbp;
+  FAR struct file *filep;
+  FAR dq_entry_t *entry;
+  FAR uint8_t *buffer;
+  FAR uint8_t *next;
+  bool bounce = false;
+  ssize_t result;
+  ssize_t ret;
+  size_t pos;
+  off_t offset;
+  int op;
+
+  aioc   = aio_container(dq_peek(run));
+  aiocbp = aioc->aioc_aiocbp;
+  filep  = aioc->aioc_filep;
+  offset = aiocbp->aio_offset;
+  op     = aioc->aioc_op;
+
+  /* Transfer straight to the buffers of the requests if they follow each
+   * other in memory, as the parts of a larger buffer do.  Otherwise go
+   * through a temporary buffer.
+   */
+
+  buffer = (FAR uint8_t *)aiocbp->aio_buf;
+  next   = buffer;
+
+  for (entry = dq_peek(run); entry != NULL; entry = dq_next(entry))
+    {
+      aiocbp = aio_container(entry)->aioc_aiocbp;
+      if ((FAR uint8_t *)aiocbp->aio_buf != next)
+        {
+          bounce = true;
+          break;
+        }
+
+      next += aiocbp->aio_nbytes;
+    }
+
+  if (bounce)
+    {
+      buffer = kmm_malloc(nbytes);
+      if (buffer == NULL)
+        {
+          /* Perform the requests one at a time */
+
+          while ((entry = dq_remfirst(run)) != NULL)
+            {
+              aioc = aio_container(entry);
+              aioc->aioc_worker(aioc);
+            }
+
+          return;
+        }
+
+      if (op == LIO_WRITE)
+        {
+          pos = 0;
+          for (entry = dq_peek(run); entry != NULL; entry = dq_next(entry))
+            {
+              aiocbp = aio_container(entry)->aioc_aiocbp;
+              memcpy(buffer + pos, (FAR const void *)aiocbp->aio_buf,
+                     aiocbp->aio_nbytes);
+              pos += aiocbp->aio_nbytes;
+            }
+        }
+    }
+
+  if (op == LIO_READ)
+    {
+      ret = file_pread(filep, buffer, nbytes, offset);
+    }
+  else
+    {
+      ret = file_pwrite(filep, buffer, nbytes, offset);
+    }
+
+  if (ret < 0)
+    {
+      ferr("ERROR: transfer of %zu bytes failed: %zd\n", nbytes, ret);
+    }
+
+  /* Complete the requests in order.  A short transfer completes the first
+   * requests, and leaves the others short or empty.
+   */
+
+  pos = 0;
+  while ((entry = dq_remfirst(run)) != NULL)
+    {
+      aioc   = aio_container(entry);
+      aiocbp = aioc->aioc_aiocbp;
+      result = ret;
+
+      if (ret >= 0)
+        {
+          result = MIN((size_t)ret - pos, aiocbp->aio_nbytes);
+          if (bounce && op == LIO_READ)
+            {
+              memcpy((FAR void *)aiocbp->aio_buf, buffer + pos, result);
+            }
+
+          pos += result;
+        }
+
+      aioc_complete(aioc, result);
+    }
+
+  if (bounce)
+    {
+      kmm_free(buffer);
+    }
+}
+
+/****************************************************************************
+ * Name: aio_stream_worker
+ *
+ * Description:
+ *   Runs on the AIO worker pool.  Perform the oldest request of a stream,
+ *   together with the requests queued behind it that continue the same
+ *   transfer, then leave the worker to the other streams.
+ *
+ ****************************************************************************/
+
+static void aio_stream_worker(FAR void *arg)
+{
+  FAR struct aio_stream_s *stream = arg;
+  FAR struct aio_container_s *aioc = NULL;
+  FAR struct aio_container_s *last;
+  FAR struct aio_container_s *next;
+  FAR dq_entry_t *entry;
+  dq_queue_t run;
+  size_t nbytes = 0;
+
+  dq_init(&run);
+  aio_lock();
+
+  entry = dq_remfirst(&stream->as_queue);
+  if (entry != NULL)
+    {
+      aioc = aio_container(entry);
+      aioc->aioc_stream = NULL;
+      nbytes = aioc->aioc_aiocbp->aio_nbytes;
+      dq_addlast(&aioc->aioc_qlink, &run);
+
+      last = aioc;
+      while (aioc->aioc_op != LIO_NOP &&
+             (entry = dq_peek(&stream->as_queue)) != NULL)
+        {
+          next = aio_container(entry);
+          if (!aio_adjacent(last, next) ||
+              nbytes + next->aioc_aiocbp->aio_nbytes >
+              CONFIG_FS_AIO_COALESCE)
+            {
+              break;
+            }
+
+          dq_remfirst(&stream->as_queue);
+          next->aioc_stream = NULL;
+          nbytes += next->aioc_aiocbp->aio_nbytes;
+          dq_addlast(&next->aioc_qlink, &run);
+          last = next;
+        }
+    }
+
+  aio_unlock();
+
+  if (aioc != NULL)
+    {
+      if (dq_peek(&run) == dq_tail(&run))
+        {
+          aioc->aioc_worker(aioc);
+        }
+      else
+        {
+          aio_transfer(&run, nbytes);
+        }
+    }
+
+  /* Queue the stream again behind the other streams if it has more
+   * requests, or release it.
+   */
+
+  aio_lock();
+
+  if (dq_empty(&stream->as_queue))
+    {
+      stream->as_filep = NULL;
+    }
+  else
+    {
+      work_queue_wq(g_aio_wqueue, &stream->as_work, aio_stream_worker,
+                    stream, 0);
+    }
+
+  aio_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the AIO worker pool, behind the
+ *   requests already queued on the same file, or on the low priority work
+ *   queue if there is no worker pool.
  *
  * Input Parameters:
- *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ *   aioc   - The AIO control block container
+ *   op     - LIO_READ or LIO_WRITE if the request is a positioned transfer
+ *            that may be coalesced with its neighbours, LIO_NOP otherwise
+ *   worker - The function performing the request, receiving the container
  *
  * Returned Value:
  *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
@@ -56,11 +347,101 @@
  *
  ****************************************************************************/
 
-int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
+#if CONFIG_FS_AIO_NWORKERS > 0
+int aio_queue(FAR struct aio_container_s *aioc, int op, worker_t worker)
 {
+  FAR struct aio_stream_s *stream = NULL;
   int ret;
+  int i;
+
+  /* Writes to a file opened for append are not positioned */
+
+  if (op == LIO_WRITE && (aioc->aioc_filep->f_oflags & O_APPEND) != 0)
+    {
+      op = LIO_NOP;
+    }
+
+  aioc->aioc_op     = op;
+  aioc->aioc_worker = worker;
+
+  ret = aio_lock();
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (g_aio_wqueue == NULL)
+    {
+      g_aio_wqueue = work_queue_create("aio", CONFIG_FS_AIO_PRIORITY, NULL,
+                                       CONFIG_FS_AIO_STACKSIZE,
+                                       CONFIG_FS_AIO_NWORKERS);
+      if (g_aio_wqueue == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+    }
+
+  /* Find the stream of the file, or else a free stream */
+
+  for (i = 0; i < AIO_NSTREAMS; i++)
+    {
+      if (g_aio_streams[i].as_filep == aioc->aioc_filep)
+        {
+          stream = &g_aio_streams[i];
+          break;
+        }
+
+      if (stream == NULL && g_aio_streams[i].as_filep == NULL)
+        {
+          stream = &g_aio_streams[i];
+        }
+    }
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+  if (stream == NULL)
+    {
+      ret = -EAGAIN;
+      goto errout_with_lock;
+    }
+
+  aioc->aioc_stream = stream;
+  dq_addlast(&aioc->aioc_qlink, &stream->as_queue);
+
+  /* A free stream has no worker yet */
+
+  if (stream->as_filep == NULL)
+    {
+      stream->as_filep = aioc->aioc_filep;
+      ret = work_queue_wq(g_aio_wqueue, &stream->as_work, aio_stream_worker,
+                          stream, 0);
+      if (ret < 0)
+        {
+          dq_rem(&aioc->aioc_qlink, &stream->as_queue);
+          aioc->aioc_stream = NULL;
+          stream->as_filep  = NULL;
+          goto errout_with_lock;
+        }
+    }
+
+  aio_unlock();
+  return OK;
+
+errout_with_lock:
+  aio_unlock();
+
+errout:
+  aioc->aioc_aiocbp->aio_result = ret;
+  set_errno(-ret);
+  return ERROR;
+}
+#else
+int aio_queue(FAR struct aio_container_s *aioc, int op, worker_t worker)
+{
+  int ret;
+
+  UNUSED(op);
+
+#ifdef AIO_PRIORITY_INHERITANCE
   /* Prohibit context switches until we complete the queuing */
 
   sched_lock();
@@ -80,7 +461,7 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
       FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
       DEBUGASSERT(aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
       lpwork_restorepriority(aioc->aioc_prio);
 #endif
       aiocbp->aio_result = ret;
@@ -88,12 +469,58 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
       ret = ERROR;
     }
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   /* Now the low-priority work queue might run at its new priority */
 
   sched_unlock();
 #endif
   return ret;
 }
+#endif
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove a request not yet started from its queue.  The caller must hold
+ *   the lock from aio_lock().
+ *
+ * Input Parameters:
+ *   aioc - The AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the request will not run, a negated errno value if it
+ *   has already been started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+#if CONFIG_FS_AIO_NWORKERS > 0
+  FAR struct aio_stream_s *stream = aioc->aioc_stream;
+
+  if (stream == NULL)
+    {
+      return -ENOENT;
+    }
+
+  dq_rem(&aioc->aioc_qlink, &stream->as_queue);
+  aioc->aioc_stream = NULL;
+
+  /* Release a stream left empty unless a worker is running it, that
+   * worker releases it when done.
+   */
+
+  if (dq_empty(&stream->as_queue) &&
+      work_cancel_wq(g_aio_wqueue, &stream->as_work) >= 0)
+    {
+      stream->as_filep = NULL;
+    }
+
+  return OK;
+#else
+  return work_cancel(LPWORK, &aioc->aioc_work);
+#endif
+}
 
 #endif /* CONFIG_FS_AIO */
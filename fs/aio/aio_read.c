@@ -62,22 +62,21 @@ static void aio_read_worker(FAR void *arg)
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
   pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   uint8_t prio;
 #endif
   ssize_t nread = 0;
 
-  /* Get the information from the container, decant the AIO control block,
-   * and free the container before starting any I/O.  That will minimize
-   * the delays by any other threads waiting for a pre-allocated container.
+  /* Get the information from the container.  The container holds the
+   * reference on the file, it is freed once the I/O is done.
    */
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   prio   = aioc->aioc_prio;
 #endif
-  aiocbp = aioc_decant(aioc);
+  aiocbp = aioc->aioc_aiocbp;
 
   /* Perform the file read using:
    *
@@ -90,6 +89,10 @@ static void aio_read_worker(FAR void *arg)
   nread = file_pread(aioc->aioc_filep, (FAR void *)aiocbp->aio_buf,
                      aiocbp->aio_nbytes, aiocbp->aio_offset);
 
+  /* Free the container and the reference on the file */
+
+  aioc_decant(aioc);
+
   /* Set the result of the read operation. */
 
 #ifdef CONFIG_DEBUG_FS_ERROR
@@ -105,7 +108,7 @@ static void aio_read_worker(FAR void *arg)
 
   aio_signal(pid, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   /* Restore the low priority worker thread default priority */
 
   lpwork_restorepriority(prio);
@@ -268,7 +271,7 @@ int aio_read(FAR struct aiocb *aiocbp)
 
   /* Defer the work to the worker thread */
 
-  ret = aio_queue(aioc, aio_read_worker);
+  ret = aio_queue(aioc, LIO_READ, aio_read_worker);
   if (ret < 0)
     {
       /* The result and the errno have already been set */
@@ -0,0 +1,766 @@
+/****************************************************************************
+ * fs/aio/aio_ring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <aio.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/atomic.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/aioring.h>
+
+#include "aio/aio.h"
+
+#if defined(CONFIG_FS_AIO) && defined(CONFIG_FS_AIO_RING)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define AIO_RING_NPOLLWAITERS 2
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A request submitted from the ring, held until its completion is posted */
+
+struct aio_ring_slot_s
+{
+  sq_entry_t rs_link;              /* Links the free slots */
+  struct aiocb rs_aiocb;           /* The request */
+  uintptr_t rs_user_data;          /* Returned in the completion */
+};
+
+/* The rings of one open of /dev/aio */
+
+struct aio_ring_s
+{
+  mutex_t ar_lock;                 /* Protects the ring */
+  sem_t ar_waitsem;                /* Posted on each completion */
+  uint16_t ar_nwaiters;            /* Threads waiting on ar_waitsem */
+  uint16_t ar_crefs;               /* The open and the mappings */
+
+  /* The memory mapped by the user, NULL until AIORIOC_SETUP */
+
+  FAR struct aioring_s *ar_shared;
+  FAR struct aioring_sqe_s *ar_sq; /* The submission queue */
+  FAR struct aioring_cqe_s *ar_cq; /* The completion queue */
+  FAR struct aio_ring_slot_s *ar_slots;
+  sq_queue_t ar_free;              /* The free slots */
+  size_t ar_size;                  /* The size of the mapped memory */
+  uint32_t ar_nentries;            /* The number of entries of each queue */
+
+  /* The private copies of the indexes owned by the OS, the user may
+   * overwrite the shared ones.
+   */
+
+  uint32_t ar_sqhead;
+  uint32_t ar_cqtail;
+  uint32_t ar_inflight;            /* The requests submitted not completed */
+
+  FAR struct pollfd *ar_fds[AIO_RING_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int aio_ring_open(FAR struct file *filep);
+static int aio_ring_close(FAR struct file *filep);
+static int aio_ring_ioctl(FAR struct file *filep, int cmd,
+                          unsigned long arg);
+static int aio_ring_mmap(FAR struct file *filep,
+                         FAR struct mm_map_entry_s *map);
+static int aio_ring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                         bool setup);
+static int aio_ring_munmap(FAR struct task_group_s *group,
+                           FAR struct mm_map_entry_s *entry,
+                           FAR void *start, size_t length);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_aio_ring_fops =
+{
+  aio_ring_open,   /* open */
+  aio_ring_close,  /* close */
+  NULL,            /* read */
+  NULL,            /* write */
+  NULL,            /* seek */
+  aio_ring_ioctl,  /* ioctl */
+  aio_ring_mmap,   /* mmap */
+  NULL,            /* truncate */
+  aio_ring_poll    /* poll */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_ring_pending
+ *
+ * Description:
+ *   Return the number of completions not yet consumed by the user.  The
+ *   caller must hold the lock of the ring.
+ *
+ ****************************************************************************/
+
+static uint32_t aio_ring_pending(FAR struct aio_ring_s *ring)
+{
+  uint32_t pending = ring->ar_cqtail - ring->ar_shared->cq_head;
+
+  return MIN(pending, ring->ar_nentries);
+}
+
+/****************************************************************************
+ * Name: aio_ring_release
+ *
+ * Description:
+ *   Drop a reference to the ring, taken by the open and by each mapping.
+ *   The ring and the memory mapped by the user are freed with the last
+ *   one.  Called with the lock of the ring held, released on return.
+ *
+ ****************************************************************************/
+
+static void aio_ring_release(FAR struct aio_ring_s *ring)
+{
+  DEBUGASSERT(ring->ar_crefs > 0);
+
+  if (--ring->ar_crefs > 0)
+    {
+      nxmutex_unlock(&ring->ar_lock);
+      return;
+    }
+
+  nxmutex_unlock(&ring->ar_lock);
+
+  if (ring->ar_shared != NULL)
+    {
+      kumm_free(ring->ar_shared);
+      kmm_free(ring->ar_slots);
+    }
+
+  nxsem_destroy(&ring->ar_waitsem);
+  nxmutex_destroy(&ring->ar_lock);
+  kmm_free(ring);
+}
+
+/****************************************************************************
+ * Name: aio_ring_worker
+ *
+ * Description:
+ *   Runs on the AIO worker and performs a request submitted from a ring.
+ *
+ ****************************************************************************/
+
+static void aio_ring_worker(FAR void *arg)
+{
+  FAR struct aio_container_s *aioc = arg;
+  FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+  FAR struct file *filep = aioc->aioc_filep;
+#ifdef AIO_PRIORITY_INHERITANCE
+  uint8_t prio = aioc->aioc_prio;
+#endif
+  ssize_t result;
+
+  switch (aiocbp->aio_lio_opcode)
+    {
+      case LIO_READ:
+        result = file_pread(filep, (FAR void *)aiocbp->aio_buf,
+                            aiocbp->aio_nbytes, aiocbp->aio_offset);
+        break;
+
+      case LIO_WRITE:
+        if ((filep->f_oflags & O_APPEND) != 0)
+          {
+            result = file_write(filep, (FAR const void *)aiocbp->aio_buf,
+                                aiocbp->aio_nbytes);
+          }
+        else
+          {
+            result = file_pwrite(filep, (FAR const void *)aiocbp->aio_buf,
+                                 aiocbp->aio_nbytes, aiocbp->aio_offset);
+          }
+        break;
+
+      default:
+        result = file_fsync(filep);
+        break;
+    }
+
+  aioc_complete(aioc, result);
+
+#ifdef AIO_PRIORITY_INHERITANCE
+  /* Restore the low priority worker thread default priority */
+
+  lpwork_restorepriority(prio);
+#endif
+}
+
+/****************************************************************************
+ * Name: aio_ring_submit
+ *
+ * Description:
+ *   Queue a request taken from the submission queue, or post its failure.
+ *   Called without the lock of the ring, aio_cancel() completes requests
+ *   with the AIO lock held.
+ *
+ ****************************************************************************/
+
+static void aio_ring_submit(FAR struct aio_ring_s *ring,
+                            FAR struct aio_ring_slot_s *slot)
+{
+  FAR struct aiocb *aiocbp = &slot->rs_aiocb;
+  FAR struct aio_container_s *aioc;
+  int op;
+
+  op = aiocbp->aio_lio_opcode;
+  if (op != LIO_READ && op != LIO_WRITE && op != LIO_NOP)
+    {
+      aiocbp->aio_result = -EINVAL;
+      aio_ring_complete(ring, aiocbp);
+      return;
+    }
+
+  aioc = aio_contain(aiocbp);
+  if (aioc == NULL)
+    {
+      aiocbp->aio_result = -get_errno();
+      aio_ring_complete(ring, aiocbp);
+      return;
+    }
+
+  /* The request cannot be canceled before it is queued */
+
+  aioc->aioc_ring = ring;
+  if (aio_queue(aioc, op, aio_ring_worker) < 0)
+    {
+      aioc_complete(aioc, aiocbp->aio_result);
+    }
+}
+
+/****************************************************************************
+ * Name: aio_ring_setup
+ ****************************************************************************/
+
+static int aio_ring_setup(FAR struct aio_ring_s *ring,
+                          FAR struct aioring_params_s *params)
+{
+  FAR struct aioring_s *shared;
+  uint32_t nentries = 1;
+  size_t sqoffset;
+  size_t cqoffset;
+  size_t size;
+  uint32_t i;
+
+  if (params == NULL || params->nentries == 0 ||
+      params->nentries > AIORING_MAXENTRIES)
+    {
+      return -EINVAL;
+    }
+
+  if (ring->ar_shared != NULL)
+    {
+      return -EBUSY;
+    }
+
+  while (nentries < params->nentries)
+    {
+      nentries <<= 1;
+    }
+
+  sqoffset = ALIGN_UP(sizeof(struct aioring_s), sizeof(uint64_t));
+  cqoffset = sqoffset + nentries * sizeof(struct aioring_sqe_s);
+  size     = cqoffset + nentries * sizeof(struct aioring_cqe_s);
+
+  /* The rings are read and written by the user in place */
+
+  shared = kumm_zalloc(size);
+  if (shared == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ring->ar_slots = kmm_zalloc(nentries * sizeof(struct aio_ring_slot_s));
+  if (ring->ar_slots == NULL)
+    {
+      kumm_free(shared);
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < nentries; i++)
+    {
+      sq_addlast(&ring->ar_slots[i].rs_link, &ring->ar_free);
+    }
+
+  shared->nentries  = nentries;
+  shared->sq_offset = sqoffset;
+  shared->cq_offset = cqoffset;
+
+  ring->ar_sq       = (FAR void *)((FAR char *)shared + sqoffset);
+  ring->ar_cq       = (FAR void *)((FAR char *)shared + cqoffset);
+  ring->ar_size     = size;
+  ring->ar_nentries = nentries;
+  ring->ar_shared   = shared;
+
+  params->nentries  = nentries;
+  params->size      = size;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_ring_enter
+ *
+ * Description:
+ *   Submit the new entries of the submission queue, as long as their
+ *   completions are sure to fit in the completion queue, then wait for
+ *   mincomplete completions.  Called with the lock of the ring held.
+ *
+ ****************************************************************************/
+
+static int aio_ring_enter(FAR struct aio_ring_s *ring,
+                          uint32_t mincomplete)
+{
+  FAR struct aioring_sqe_s *sqe;
+  FAR struct aio_ring_slot_s *slot;
+  FAR struct aiocb *aiocbp;
+  uint32_t mask = ring->ar_nentries - 1;
+  uint32_t tail;
+  int submitted = 0;
+  int ret = OK;
+
+  for (; ; )
+    {
+      tail = ring->ar_shared->sq_tail;
+      if (tail == ring->ar_sqhead ||
+          ring->ar_inflight + aio_ring_pending(ring) >= ring->ar_nentries)
+        {
+          break;
+        }
+
+      if (tail - ring->ar_sqhead > ring->ar_nentries)
+        {
+          ret = -EINVAL;
+          break;
+        }
+
+      /* Read the entry only after its index, and copy it so that the user
+       * may reuse it at once.
+       */
+
+      atomic_thread_fence(memory_order_acquire);
+
+      sqe  = &ring->ar_sq[ring->ar_sqhead & mask];
+      slot = (FAR struct aio_ring_slot_s *)sq_remfirst(&ring->ar_free);
+      DEBUGASSERT(slot != NULL);
+
+      aiocbp = &slot->rs_aiocb;
+      memset(aiocbp, 0, sizeof(struct aiocb));
+      aiocbp->aio_fildes    = sqe->fildes;
+      aiocbp->aio_offset    = sqe->offset;
+      aiocbp->aio_buf       = sqe->buf;
+      aiocbp->aio_nbytes    = sqe->nbytes;
+      aiocbp->aio_result    = -EINPROGRESS;
+      aiocbp->aio_sigevent.sigev_notify = SIGEV_NONE;
+      slot->rs_user_data    = sqe->user_data;
+
+      switch (sqe->opcode)
+        {
+          case AIORING_OP_READ:
+          case AIORING_OP_WRITE:
+            aiocbp->aio_lio_opcode = sqe->opcode;
+            break;
+
+          case AIORING_OP_FSYNC:
+            aiocbp->aio_lio_opcode = LIO_NOP;
+            break;
+
+          default:
+            aiocbp->aio_lio_opcode = -1;
+            break;
+        }
+
+      ring->ar_shared->sq_head = ++ring->ar_sqhead;
+      ring->ar_inflight++;
+      nxmutex_unlock(&ring->ar_lock);
+
+      aio_ring_submit(ring, slot);
+      submitted++;
+
+      nxmutex_lock(&ring->ar_lock);
+    }
+
+  /* Wait for the completions, or until nothing more can complete */
+
+  while (ret >= 0 && aio_ring_pending(ring) < mincomplete &&
+         ring->ar_inflight > 0)
+    {
+      ring->ar_nwaiters++;
+      nxmutex_unlock(&ring->ar_lock);
+      ret = nxsem_wait(&ring->ar_waitsem);
+      nxmutex_lock(&ring->ar_lock);
+
+      /* If interrupted, stop waiting, or take back the count posted for
+       * this thread by a completion in between.
+       */
+
+      if (ret < 0 && ring->ar_nwaiters > 0)
+        {
+          ring->ar_nwaiters--;
+        }
+      else if (ret < 0)
+        {
+          nxsem_trywait(&ring->ar_waitsem);
+        }
+    }
+
+  return submitted > 0 ? submitted : ret;
+}
+
+/****************************************************************************
+ * Name: aio_ring_open
+ ****************************************************************************/
+
+static int aio_ring_open(FAR struct file *filep)
+{
+  FAR struct aio_ring_s *ring;
+
+  ring = kmm_zalloc(sizeof(struct aio_ring_s));
+  if (ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&ring->ar_lock);
+  nxsem_init(&ring->ar_waitsem, 0, 0);
+  ring->ar_crefs = 1;
+  filep->f_priv  = ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_ring_close
+ ****************************************************************************/
+
+static int aio_ring_close(FAR struct file *filep)
+{
+  FAR struct aio_ring_s *ring = filep->f_priv;
+  FAR struct aio_container_s *aioc;
+  FAR struct aio_container_s *next;
+
+  /* Cancel the requests not yet started */
+
+  aio_lock();
+  for (aioc = (FAR struct aio_container_s *)g_aio_pending.head;
+       aioc != NULL; aioc = next)
+    {
+      next = (FAR struct aio_container_s *)aioc->aioc_link.flink;
+      if (aioc->aioc_ring == ring && aio_dequeue(aioc) >= 0)
+        {
+          aioc_complete(aioc, -ECANCELED);
+        }
+    }
+
+  aio_unlock();
+
+  /* And wait for the others, they still reference the slots */
+
+  nxmutex_lock(&ring->ar_lock);
+  while (ring->ar_inflight > 0)
+    {
+      ring->ar_nwaiters++;
+      nxmutex_unlock(&ring->ar_lock);
+      nxsem_wait_uninterruptible(&ring->ar_waitsem);
+      nxmutex_lock(&ring->ar_lock);
+    }
+
+  /* The memory stays until it is no longer mapped */
+
+  aio_ring_release(ring);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_ring_ioctl
+ ****************************************************************************/
+
+static int aio_ring_ioctl(FAR struct file *filep, int cmd,
+                          unsigned long arg)
+{
+  FAR struct aio_ring_s *ring = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&ring->ar_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case AIORIOC_SETUP:
+        ret = aio_ring_setup(ring,
+                             (FAR struct aioring_params_s *)(uintptr_t)arg);
+        break;
+
+      case AIORIOC_ENTER:
+        if (ring->ar_shared == NULL)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            ret = aio_ring_enter(ring, arg);
+          }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&ring->ar_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: aio_ring_mmap
+ ****************************************************************************/
+
+static int aio_ring_mmap(FAR struct file *filep,
+                         FAR struct mm_map_entry_s *map)
+{
+  FAR struct aio_ring_s *ring = filep->f_priv;
+  int ret = OK;
+
+  nxmutex_lock(&ring->ar_lock);
+  if (ring->ar_shared == NULL || map->offset < 0 ||
+      map->offset >= ring->ar_size || map->length == 0 ||
+      map->offset + map->length > ring->ar_size)
+    {
+      ret = -EINVAL;
+    }
+  else
+    {
+      map->vaddr  = (FAR char *)ring->ar_shared + map->offset;
+      map->priv.p = ring;
+      map->munmap = aio_ring_munmap;
+      ret = mm_map_add(get_current_mm(), map);
+      if (ret >= 0)
+        {
+          ring->ar_crefs++;
+        }
+    }
+
+  nxmutex_unlock(&ring->ar_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: aio_ring_munmap
+ ****************************************************************************/
+
+static int aio_ring_munmap(FAR struct task_group_s *group,
+                           FAR struct mm_map_entry_s *entry,
+                           FAR void *start, size_t length)
+{
+  FAR struct aio_ring_s *ring = entry->priv.p;
+  int ret;
+
+  /* Partial unmap is not supported */
+
+  if (start != entry->vaddr || length != entry->length)
+    {
+      return -EINVAL;
+    }
+
+  ret = mm_map_remove(get_group_mm(group), entry);
+  if (ret >= 0)
+    {
+      nxmutex_lock(&ring->ar_lock);
+      aio_ring_release(ring);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: aio_ring_poll
+ ****************************************************************************/
+
+static int aio_ring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                         bool setup)
+{
+  FAR struct aio_ring_s *ring = filep->f_priv;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&ring->ar_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!setup)
+    {
+      /* This is a request to tear down the poll. */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      /* The setup may have failed */
+
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+        }
+
+      goto out;
+    }
+
+  /* This is a request to set up the poll. Find an available slot for the
+   * poll structure reference
+   */
+
+  for (i = 0; i < AIO_RING_NPOLLWAITERS; i++)
+    {
+      if (ring->ar_fds[i] == NULL)
+        {
+          ring->ar_fds[i] = fds;
+          fds->priv       = &ring->ar_fds[i];
+          break;
+        }
+    }
+
+  if (i >= AIO_RING_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      ret       = -EBUSY;
+      goto out;
+    }
+
+  /* Notify the POLLIN event if the completion queue is not empty */
+
+  if (ring->ar_shared != NULL && aio_ring_pending(ring) > 0)
+    {
+      poll_notify(&fds, 1, POLLIN);
+    }
+
+out:
+  nxmutex_unlock(&ring->ar_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_ring_register
+ *
+ * Description:
+ *   Register the AIO ring driver at /dev/aio.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int aio_ring_register(void)
+{
+  return register_driver(AIORING_DEVPATH, &g_aio_ring_fops, 0666, NULL);
+}
+
+/****************************************************************************
+ * Name: aio_ring_complete
+ *
+ * Description:
+ *   Post the completion of a request submitted from a ring.
+ *
+ * Input Parameters:
+ *   ring   - The ring the request was submitted from
+ *   aiocbp - The AIO control block of the request, holding the result
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_ring_complete(FAR struct aio_ring_s *ring,
+                       FAR struct aiocb *aiocbp)
+{
+  FAR struct aio_ring_slot_s *slot =
+    container_of(aiocbp, struct aio_ring_slot_s, rs_aiocb);
+  FAR struct aioring_cqe_s *cqe;
+
+  nxmutex_lock(&ring->ar_lock);
+
+  /* A request is only submitted when the completion queue has room for
+   * it and for all of those in flight, so that it never overflows.
+   */
+
+  cqe = &ring->ar_cq[ring->ar_cqtail & (ring->ar_nentries - 1)];
+  cqe->user_data = slot->rs_user_data;
+  cqe->result    = aiocbp->aio_result;
+
+  /* Publish the entry before its index */
+
+  atomic_thread_fence(memory_order_release);
+  ring->ar_shared->cq_tail = ++ring->ar_cqtail;
+
+  sq_addlast(&slot->rs_link, &ring->ar_free);
+  ring->ar_inflight--;
+
+  while (ring->ar_nwaiters > 0)
+    {
+      ring->ar_nwaiters--;
+      nxsem_post(&ring->ar_waitsem);
+    }
+
+  poll_notify(ring->ar_fds, AIO_RING_NPOLLWAITERS, POLLIN);
+  nxmutex_unlock(&ring->ar_lock);
+}
+
+#endif /* CONFIG_FS_AIO && CONFIG_FS_AIO_RING */
@@ -64,23 +64,22 @@ static void aio_write_worker(FAR void *arg)
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
   pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   uint8_t prio;
 #endif
   ssize_t nwritten = 0;
   int oflags;
 
-  /* Get the information from the container, decant the AIO control block,
-   * and free the container before starting any I/O.  That will minimize
-   * the delays by any other threads waiting for a pre-allocated container.
+  /* Get the information from the container.  The container holds the
+   * reference on the file, it is freed once the I/O is done.
    */
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   prio   = aioc->aioc_prio;
 #endif
-  aiocbp = aioc_decant(aioc);
+  aiocbp = aioc->aioc_aiocbp;
 
   /* Call fcntl(F_GETFL) to get the file open mode. */
 
@@ -129,11 +128,15 @@ static void aio_write_worker(FAR void *arg)
 
 errout:
 
+  /* Free the container and the reference on the file */
+
+  aioc_decant(aioc);
+
   /* Signal the client */
 
   aio_signal(pid, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   /* Restore the low priority worker thread default priority */
 
   lpwork_restorepriority(prio);
@@ -305,7 +308,7 @@ int aio_write(FAR struct aiocb *aiocbp)
 
   /* Defer the work to the worker thread */
 
-  ret = aio_queue(aioc, aio_write_worker);
+  ret = aio_queue(aioc, LIO_WRITE, aio_write_worker);
   if (ret < 0)
     {
       /* The result and the errno have already been set */
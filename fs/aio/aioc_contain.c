@@ -61,7 +61,7 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
   FAR struct aio_container_s *aioc;
   FAR struct file *filep;
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   struct sched_param param;
 #endif
   int ret;
@@ -93,7 +93,7 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
   aioc->aioc_filep  = filep;
   aioc->aioc_pid    = nxsched_getpid();
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_PRIORITY_INHERITANCE
   DEBUGVERIFY(nxsched_get_param(aioc->aioc_pid, &param));
   aioc->aioc_prio   = param.sched_priority;
 #endif
@@ -162,4 +162,42 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc)
   return aiocbp;
 }
 
+/****************************************************************************
+ * Name: aioc_complete
+ *
+ * Description:
+ *   Free the container of a request done or canceled, then post the result
+ *   to the client: by signal, or to the completion queue of its ring.
+ *
+ * Input Parameters:
+ *   aioc   - Pointer to the AIO control block container
+ *   result - The result of the request
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aioc_complete(FAR struct aio_container_s *aioc, ssize_t result)
+{
+  FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+  pid_t pid = aioc->aioc_pid;
+#ifdef CONFIG_FS_AIO_RING
+  FAR struct aio_ring_s *ring = aioc->aioc_ring;
+#endif
+
+  aioc_decant(aioc);
+  aiocbp->aio_result = result;
+
+#ifdef CONFIG_FS_AIO_RING
+  if (ring != NULL)
+    {
+      aio_ring_complete(ring, aiocbp);
+      return;
+    }
+#endif
+
+  aio_signal(pid, aiocbp);
+}
+
 #endif /* CONFIG_FS_AIO */
@@ -39,6 +39,8 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 
@@ -53,6 +55,11 @@
 
 #define CROMFS_MAX_LINKS 64
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
+#  define cromfs_cache_read(voloffs, dest, copyoffs, copysize) false
+#  define cromfs_cache_insert(fs, voloffs, src, ulen)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -71,9 +78,24 @@ struct cromfs_file_s
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
   uint32_t ff_offset;                       /* Cached block offset (zero means none) */
   uint16_t ff_ulen;                         /* Length of decompressed data in cache */
+  uint16_t ff_bulen;                        /* Uncompressed size of each block */
+  uint32_t ff_nblocks;                      /* Number of blocks in ff_blocks */
+  FAR uint32_t *ff_blocks;                  /* Offset of each block header */
   FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
 };
 
+/* One decompressed block in the cache shared by all open files */
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+struct cromfs_cache_s
+{
+  struct list_node cc_node;                 /* LRU list, most recent first */
+  uint32_t cc_offset;                       /* Block offset (zero means none) */
+  uint16_t cc_ulen;                         /* Length of decompressed data */
+  FAR uint8_t *cc_buffer;                   /* Decompressed data */
+};
+#endif
+
 /* This is the form of the callback from cromfs_foreach_node(): */
 
 typedef CODE int (*cromfs_foreach_t)(FAR const struct cromfs_volume_s *fs,
@@ -135,6 +157,23 @@ static int      cromfs_find_node(FAR const struct cromfs_volume_s *fs,
                                  FAR const char *relpath,
                                  FAR struct cromfs_nodeinfo_s *info,
                                  FAR uint32_t *offset);
+static uint32_t cromfs_parse_header(FAR const struct lzf_header_s *hdr,
+                                    FAR uint16_t *ulen, FAR uint16_t *clen);
+static int      cromfs_file_init(FAR const struct cromfs_volume_s *fs,
+                                 FAR struct cromfs_file_s *ff,
+                                 FAR const struct cromfs_node_s *node);
+static FAR const struct lzf_header_s *
+                cromfs_find_block(FAR const struct cromfs_volume_s *fs,
+                                  FAR const struct cromfs_file_s *ff,
+                                  off_t fpos, FAR uint32_t *blkoffs);
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+static bool     cromfs_cache_read(uint32_t voloffs, FAR uint8_t *dest,
+                                  unsigned int copyoffs,
+                                  unsigned int copysize);
+static void     cromfs_cache_insert(FAR const struct cromfs_volume_s *fs,
+                                    uint32_t voloffs,
+                                    FAR const uint8_t *src, uint16_t ulen);
+#endif
 
 /* Common file system methods */
 
@@ -226,6 +265,20 @@ const struct mountpt_operations g_cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+/* The decompressed blocks shared by all open files */
+
+static struct cromfs_cache_s g_cromfs_cache[CONFIG_FS_CROMFS_CACHE_NBLOCKS];
+static struct list_node g_cromfs_lru = LIST_INITIAL_VALUE(g_cromfs_lru);
+static mutex_t g_cromfs_cachelock = NXMUTEX_INITIALIZER;
+static uint32_t g_cromfs_hits;
+static uint32_t g_cromfs_misses;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -724,6 +777,263 @@ static int cromfs_find_node(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_parse_header
+ *
+ * Description:
+ *   Return the uncompressed and compressed data sizes of a block and the
+ *   size of the whole block, header included.
+ *
+ ****************************************************************************/
+
+static uint32_t cromfs_parse_header(FAR const struct lzf_header_s *hdr,
+                                    FAR uint16_t *ulen, FAR uint16_t *clen)
+{
+  if (hdr->lzf_type == LZF_TYPE0_HDR)
+    {
+      FAR const struct lzf_type0_header_s *hdr0 =
+        (FAR const struct lzf_type0_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr0->lzf_len[0] << 8 |
+              (uint16_t)hdr0->lzf_len[1];
+      *clen = *ulen;
+      return (uint32_t)*ulen + LZF_TYPE0_HDR_SIZE;
+    }
+  else
+    {
+      FAR const struct lzf_type1_header_s *hdr1 =
+        (FAR const struct lzf_type1_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr1->lzf_ulen[0] << 8 |
+              (uint16_t)hdr1->lzf_ulen[1];
+      *clen = (uint16_t)hdr1->lzf_clen[0] << 8 |
+              (uint16_t)hdr1->lzf_clen[1];
+      return (uint32_t)*clen + LZF_TYPE1_HDR_SIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: cromfs_file_init
+ *
+ * Description:
+ *   Initialize an open file instance: allocate the decompression buffer
+ *   and index the blocks of the file.  Every block but the last one holds
+ *   the same amount of uncompressed data, so the block containing an
+ *   offset is found by a division.  If that is not the case, or if the
+ *   index can't be allocated, cromfs_find_block() walks the headers.
+ *
+ ****************************************************************************/
+
+static int cromfs_file_init(FAR const struct cromfs_volume_s *fs,
+                            FAR struct cromfs_file_s *ff,
+                            FAR const struct cromfs_node_s *node)
+{
+  FAR const struct lzf_header_s *hdr;
+  uint32_t nblocks;
+  uint32_t fpos;
+  uint32_t i;
+  uint16_t ulen;
+  uint16_t clen;
+
+  ff->ff_node   = node;
+  ff->ff_buffer = fs_heap_malloc(fs->cv_bsize);
+  if (ff->ff_buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  if (node->cn_size == 0)
+    {
+      return OK;
+    }
+
+  hdr = cromfs_offset2addr(fs, node->u.cn_blocks);
+  cromfs_parse_header(hdr, &ulen, &clen);
+  if (ulen == 0)
+    {
+      return OK;
+    }
+
+  nblocks = (node->cn_size + ulen - 1) / ulen;
+  ff->ff_blocks = fs_heap_malloc(nblocks * sizeof(uint32_t));
+  if (ff->ff_blocks == NULL)
+    {
+      return OK;
+    }
+
+  ff->ff_bulen = ulen;
+  for (i = 0, fpos = 0; i < nblocks; i++)
+    {
+      ff->ff_blocks[i] = cromfs_addr2offset(fs, hdr);
+      hdr = (FAR const struct lzf_header_s *)
+            ((FAR const uint8_t *)hdr +
+             cromfs_parse_header(hdr, &ulen, &clen));
+
+      fpos += ulen;
+      if (ulen != ff->ff_bulen && fpos < node->cn_size)
+        {
+          fs_heap_free(ff->ff_blocks);
+          ff->ff_blocks = NULL;
+          return OK;
+        }
+    }
+
+  ff->ff_nblocks = nblocks;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cromfs_find_block
+ *
+ * Description:
+ *   Return the header of the block containing the file offset fpos, and
+ *   the file offset of the start of the block in blkoffs.
+ *
+ ****************************************************************************/
+
+static FAR const struct lzf_header_s *
+cromfs_find_block(FAR const struct cromfs_volume_s *fs,
+                  FAR const struct cromfs_file_s *ff, off_t fpos,
+                  FAR uint32_t *blkoffs)
+{
+  FAR const struct lzf_header_s *hdr;
+  uint32_t blksize;
+  uint16_t ulen;
+  uint16_t clen;
+
+  if (ff->ff_blocks != NULL)
+    {
+      uint32_t index = fpos / ff->ff_bulen;
+
+      DEBUGASSERT(index < ff->ff_nblocks);
+      *blkoffs = index * ff->ff_bulen;
+      return cromfs_offset2addr(fs, ff->ff_blocks[index]);
+    }
+
+  hdr      = cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+  *blkoffs = 0;
+
+  for (; ; )
+    {
+      blksize = cromfs_parse_header(hdr, &ulen, &clen);
+      if (fpos < *blkoffs + ulen)
+        {
+          return hdr;
+        }
+
+      *blkoffs += ulen;
+      hdr       = (FAR const struct lzf_header_s *)
+                  ((FAR const uint8_t *)hdr + blksize);
+    }
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_read
+ *
+ * Description:
+ *   Copy data of a decompressed block from the shared cache, if the block
+ *   is there.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+static bool cromfs_cache_read(uint32_t voloffs, FAR uint8_t *dest,
+                              unsigned int copyoffs, unsigned int copysize)
+{
+  FAR struct cromfs_cache_s *cache;
+  bool found = false;
+
+  nxmutex_lock(&g_cromfs_cachelock);
+
+  list_for_every_entry(&g_cromfs_lru, cache, struct cromfs_cache_s,
+                       cc_node)
+    {
+      if (cache->cc_offset == voloffs)
+        {
+          DEBUGASSERT(cache->cc_ulen >= copyoffs + copysize);
+          memcpy(dest, &cache->cc_buffer[copyoffs], copysize);
+
+          list_delete(&cache->cc_node);
+          list_add_head(&g_cromfs_lru, &cache->cc_node);
+          found = true;
+          break;
+        }
+    }
+
+  if (found)
+    {
+      g_cromfs_hits++;
+    }
+  else
+    {
+      g_cromfs_misses++;
+    }
+
+  nxmutex_unlock(&g_cromfs_cachelock);
+  return found;
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_insert
+ *
+ * Description:
+ *   Keep a copy of a decompressed block in the shared cache, in place of
+ *   the least recently used one.  The block is decompressed without the
+ *   cache locked, so readers of different blocks run in parallel.
+ *
+ ****************************************************************************/
+
+static void cromfs_cache_insert(FAR const struct cromfs_volume_s *fs,
+                                uint32_t voloffs, FAR const uint8_t *src,
+                                uint16_t ulen)
+{
+  FAR struct cromfs_cache_s *cache;
+  int i;
+
+  nxmutex_lock(&g_cromfs_cachelock);
+
+  if (list_is_empty(&g_cromfs_lru))
+    {
+      for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+        {
+          list_add_tail(&g_cromfs_lru, &g_cromfs_cache[i].cc_node);
+        }
+    }
+
+  /* Another reader may have inserted the same block meanwhile */
+
+  list_for_every_entry(&g_cromfs_lru, cache, struct cromfs_cache_s,
+                       cc_node)
+    {
+      if (cache->cc_offset == voloffs)
+        {
+          goto out;
+        }
+    }
+
+  cache = list_last_entry(&g_cromfs_lru, struct cromfs_cache_s, cc_node);
+  if (cache->cc_buffer == NULL)
+    {
+      cache->cc_buffer = fs_heap_malloc(fs->cv_bsize);
+      if (cache->cc_buffer == NULL)
+        {
+          goto errout;
+        }
+    }
+
+  memcpy(cache->cc_buffer, src, ulen);
+  cache->cc_offset = voloffs;
+  cache->cc_ulen   = ulen;
+
+out:
+  list_delete(&cache->cc_node);
+  list_add_head(&g_cromfs_lru, &cache->cc_node);
+
+errout:
+  nxmutex_unlock(&g_cromfs_cachelock);
+}
+#endif
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -792,20 +1102,18 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
+  /* Save the node in the open file instance, create a file buffer to
+   * support partial sector accesses and index the blocks.
+   */
 
-  ff->ff_buffer = fs_heap_malloc(fs->cv_bsize);
-  if (!ff->ff_buffer)
+  ret = cromfs_file_init(fs, ff, (FAR const struct cromfs_node_s *)
+                         cromfs_offset2addr(fs, offset));
+  if (ret < 0)
     {
       fs_heap_free(ff);
-      return -ENOMEM;
+      return ret;
     }
 
-  /* Save the node in the open file instance */
-
-  ff->ff_node = (FAR const struct cromfs_node_s *)
-    cromfs_offset2addr(fs, offset);
-
   /* Save the index as the open-specific state in filep->f_priv */
 
   filep->f_priv = (FAR void *)ff;
@@ -830,6 +1138,7 @@ static int cromfs_close(FAR struct file *filep)
 
   /* Free all resources consumed by the opened file */
 
+  fs_heap_free(ff->ff_blocks);
   fs_heap_free(ff->ff_buffer);
   fs_heap_free(ff);
 
@@ -846,13 +1155,13 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   FAR struct inode *inode;
   FAR const struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *ff;
-  FAR struct lzf_header_s *currhdr;
-  FAR struct lzf_header_s *nexthdr;
+  FAR const struct lzf_header_s *currhdr;
   FAR uint8_t *dest;
   FAR const uint8_t *src;
   off_t fpos;
   size_t remaining;
   uint32_t blkoffs;
+  uint32_t voloffs;
   uint16_t ulen;
   uint16_t clen;
   unsigned int copysize;
@@ -893,66 +1202,27 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = ff->ff_node->cn_size - filep->f_pos;
     }
 
-  /* Find the compressed block containing the current offset, f_pos */
-
   dest      = (FAR uint8_t *)buffer;
   remaining = buflen;
   fpos      = filep->f_pos;
-  blkoffs   = 0;
-  ulen      = 0;
-  nexthdr   = (FAR struct lzf_header_s *)
-               cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
-
-  /* Look until we find the compressed block containing the start of the
-   * requested data.
-   */
 
   while (remaining > 0)
     {
-      /* Search for the next block containing the fpos file offset.  This is
-       * real search on the first time through but the remaining blocks
-       * should be contiguous so that the logic should not loop.
-       *
-       */
-
-      do
-        {
-          uint32_t blksize;
+      /* Find the compressed block containing the current offset */
 
-          /* Go to the next block */
+      currhdr = cromfs_find_block(fs, ff, fpos, &blkoffs);
+      cromfs_parse_header(currhdr, &ulen, &clen);
 
-          currhdr  = nexthdr;
-          blkoffs += ulen;
+      copyoffs = fpos - blkoffs;
+      DEBUGASSERT(ulen > copyoffs);
+      copysize = ulen - copyoffs;
 
-          if (currhdr->lzf_type == LZF_TYPE0_HDR)
-            {
-              FAR struct lzf_type0_header_s *hdr0 =
-                (FAR struct lzf_type0_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr0->lzf_len[0] << 8 |
-                        (uint16_t)hdr0->lzf_len[1];
-              blksize = (uint32_t)ulen + LZF_TYPE0_HDR_SIZE;
-            }
-          else
-            {
-              FAR struct lzf_type1_header_s * hdr1 =
-                (FAR struct lzf_type1_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr1->lzf_ulen[0] << 8 |
-                        (uint16_t)hdr1->lzf_ulen[1];
-              clen    = (uint16_t)hdr1->lzf_clen[0] << 8 |
-                        (uint16_t)hdr1->lzf_clen[1];
-              blksize = (uint32_t)clen + LZF_TYPE1_HDR_SIZE;
-            }
+      if (copysize > remaining)
+        {
+          /* Clip to the size really needed */
 
-          nexthdr  = (FAR struct lzf_header_s *)
-                     ((FAR uint8_t *)currhdr + blksize);
+          copysize = remaining;
         }
-      while (fpos >= (blkoffs + ulen));
-
-      /* Check if we need to decompress the next block into the user
-       * buffer.
-       */
 
       if (currhdr->lzf_type == LZF_TYPE0_HDR)
         {
@@ -960,17 +1230,6 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
            * user buffer.
            */
 
-          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
-          DEBUGASSERT(ulen > copyoffs);
-          copysize = ulen - copyoffs;
-
-          if (copysize > remaining)
-            {
-              /* Clip to the size really needed */
-
-              copysize = remaining;
-            }
-
           src = (FAR const uint8_t *)currhdr + LZF_TYPE0_HDR_SIZE;
           memcpy(dest, &src[copyoffs], copysize);
 
@@ -979,86 +1238,56 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
         }
       else
         {
-          /* If the source of the data is at the beginning of the compressed
-           * data buffer and if the uncompressed data would not overrun the
-           * buffer, then we can decompress directly into the user buffer.
+          /* Get the address and offset in the CROMFS image to obtain the
+           * data.  Check if we already have this offset in the buffer of
+           * the file, then in the shared cache.
            */
 
-          if (filep->f_pos <= blkoffs && ulen <= remaining)
-            {
-              uint32_t voloffs;
-
-              copyoffs = 0;
-              copysize = ulen;
+          src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+          voloffs = cromfs_addr2offset(fs, src);
 
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
+          if (voloffs == ff->ff_offset)
+            {
+              DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
+              memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+            }
+          else if (cromfs_cache_read(voloffs, dest, copyoffs, copysize))
+            {
+              finfo("Cache hit voloffs=%" PRIu32 "\n", voloffs);
+            }
+          else if (copyoffs == 0 && copysize == ulen)
+            {
+              /* The whole block is wanted, decompress it directly into
+               * the user buffer.
                */
 
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
-
-              finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32
-                    " ulen=%" PRIu16 " ff_offset=%" PRIu32 " copysize=%u\n",
-                    voloffs, blkoffs, ulen, ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
+              lzf_decompress(src, clen, dest, fs->cv_bsize);
+              cromfs_cache_insert(fs, voloffs, dest, ulen);
             }
           else
             {
-              uint32_t voloffs;
-
               /* No, we will need to decompress into the our intermediate
                * decompression buffer.
                */
 
-              copyoffs = (blkoffs >= filep->f_pos) ?
-                            0 : filep->f_pos - blkoffs;
-              DEBUGASSERT(ulen > copyoffs);
-              copysize = ulen - copyoffs;
+              DEBUGASSERT((copyoffs + copysize) <= fs->cv_bsize);
 
-              if (copysize > remaining)
-                {
-                  /* Clip to the size really needed */
-
-                  copysize = remaining;
-                }
-
-              DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
-
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
+              ff->ff_ulen   = lzf_decompress(src, clen, ff->ff_buffer,
                                              fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
-
-              finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32 " ulen=%" PRIu16
-                    " clen=%" PRIu16 " ff_offset=%" PRIu32
-                    "  copyoffs=%u copysize=%u\n",
-                    voloffs, blkoffs, ulen, clen, ff->ff_offset,
-                    copyoffs, copysize);
+              ff->ff_offset = voloffs;
+              cromfs_cache_insert(fs, voloffs, ff->ff_buffer, ff->ff_ulen);
               DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
 
               /* Then copy to user buffer */
 
               memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
             }
+
+          finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32 " ulen=%" PRIu16
+                " clen=%" PRIu16 " ff_offset=%" PRIu32
+                " copyoffs=%u copysize=%u\n",
+                voloffs, blkoffs, ulen, clen, ff->ff_offset,
+                copyoffs, copysize);
         }
 
       /* Adjust pointers counts and offset */
@@ -1082,7 +1311,24 @@ static int cromfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   finfo("cmd: %d arg: %08lx\n", cmd, arg);
 
-  /* No IOCTL commands yet supported */
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+  if (cmd == FIOC_CACHESTATS)
+    {
+      FAR struct fs_cachestats_s *stats =
+        (FAR struct fs_cachestats_s *)((uintptr_t)arg);
+
+      if (stats == NULL)
+        {
+          return -EINVAL;
+        }
+
+      nxmutex_lock(&g_cromfs_cachelock);
+      stats->nhits   = g_cromfs_hits;
+      stats->nmisses = g_cromfs_misses;
+      nxmutex_unlock(&g_cromfs_cachelock);
+      return OK;
+    }
+#endif
 
   return -ENOTTY;
 }
@@ -1100,6 +1346,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   FAR struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *oldff;
   FAR struct cromfs_file_s *newff;
+  int ret;
 
   finfo("Dup %p->%p\n", oldp, newp);
   DEBUGASSERT(oldp->f_priv != NULL && oldp->f_inode != NULL &&
@@ -1125,19 +1372,17 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
+  /* Save the node in the open file instance, create a file buffer to
+   * support partial sector accesses and index the blocks.
+   */
 
-  newff->ff_buffer = fs_heap_malloc(fs->cv_bsize);
-  if (newff->ff_buffer == NULL)
+  ret = cromfs_file_init(fs, newff, oldff->ff_node);
+  if (ret < 0)
     {
       fs_heap_free(newff);
-      return -ENOMEM;
+      return ret;
     }
 
-  /* Save the node in the open file instance */
-
-  newff->ff_node = oldff->ff_node;
-
   /* Copy the index from the old to the new file structure */
 
   newp->f_priv = newff;
@@ -28,6 +28,7 @@
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <sys/mount.h>
+#include <sys/param.h>
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -262,13 +263,21 @@ static int fat_open(FAR struct file *filep, FAR const char *relpath,
 
       if ((oflags & (O_TRUNC | O_WRONLY)) == (O_TRUNC | O_WRONLY))
         {
-          /* Truncate the file to zero length */
+          /* Forget the cluster chain cached by the other open instances
+           * of the file, then truncate the file to zero length.
+           */
+
+          fat_extentinvalidate(fs,
+            ((uint32_t)DIR_GETFSTCLUSTHI(direntry) << 16) |
+            DIR_GETFSTCLUSTLO(direntry));
 
           ret = fat_dirtruncate(fs, direntry);
           if (ret < 0)
             {
               goto errout_with_lock;
             }
+
+          direntry = &fs->fs_buffer[dirinfo.fd_seq.ds_offset];
         }
 
       /* fall through to finish the file open operations */
@@ -613,7 +622,26 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
 
       cluster = ff->ff_startcluster;
       num_traversed = 1;
+      fat_extentadd(ff, 0, cluster);
+    }
+
+#if CONFIG_FAT_NEXTENTS > 0
+  /* Skip the part of the chain already known from the extent cache */
+
+  if (num_traversed > 0 && num_clu > 0)
+    {
+      uint32_t extcluster;
+      uint32_t known;
+
+      known = fat_extentlookup(ff, MIN(num_clu, new_num_clu) - 1,
+                               &extcluster);
+      if (known > num_traversed)
+        {
+          cluster = extcluster;
+          num_traversed = known;
+        }
     }
+#endif
 
   /* Traverse the existing chain */
 
@@ -627,6 +655,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
         {
           return -EIO;
         }
+
+      fat_extentadd(ff, i, cluster);
     }
 
   if (read)
@@ -679,6 +709,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+      fat_extentadd(ff, i, cluster);
+
       /* zero area (2) */
 
       ret = fat_zero_cluster(fs, cluster, 0, clu_size);
@@ -702,6 +734,8 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
 
+      fat_extentadd(ff, i, cluster);
+
       /* zero area (3) */
 
       zero_end = filep->f_pos & (clu_size -1);
@@ -739,6 +773,50 @@ out:
   return 0;
 }
 
+/****************************************************************************
+ * Name: fat_contiguous
+ *
+ * Description:
+ *   Count the clusters that follow the current cluster of the file and
+ *   are contiguous to it on the media, up to enough clusters to hold
+ *   'nsectors' more sectors.
+ *
+ * Returned Value:
+ *   The number of contiguous clusters found, the last one of them (or the
+ *   current cluster if none) is returned in 'lastcluster'.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+static unsigned int fat_contiguous(FAR struct fat_mountpt_s *fs,
+                                   FAR struct fat_file_s *ff,
+                                   unsigned int nsectors,
+                                   FAR uint32_t *lastcluster)
+{
+  uint32_t cluster = ff->ff_currentcluster;
+  uint32_t index = ff->ff_pos /
+                   (fs->fs_fatsecperclus * fs->fs_hwsectorsize);
+  unsigned int nclusters = 0;
+  off_t next;
+
+  while (nclusters * fs->fs_fatsecperclus < nsectors)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next != cluster + 1)
+        {
+          break;
+        }
+
+      cluster = next;
+      nclusters++;
+      fat_extentadd(ff, index + nclusters, cluster);
+    }
+
+  *lastcluster = cluster;
+  return nclusters;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_read
  ****************************************************************************/
@@ -758,6 +836,8 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  unsigned int nclusters;
+  uint32_t lastcluster;
   bool force_indirect = false;
 #endif
 
@@ -864,12 +944,22 @@ fat_read_restart:
            *
            * Limit the number of sectors that we read on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and in the following clusters that are
+           * contiguous to it.
            */
 
+          nclusters = 0;
           if (nsectors > ff->ff_sectorsincluster)
             {
-              nsectors = ff->ff_sectorsincluster;
+              nclusters = fat_contiguous(fs, ff,
+                                         nsectors - ff->ff_sectorsincluster,
+                                         &lastcluster);
+              if (nsectors > ff->ff_sectorsincluster +
+                             nclusters * fs->fs_fatsecperclus)
+                {
+                  nsectors = ff->ff_sectorsincluster +
+                             nclusters * fs->fs_fatsecperclus;
+                }
             }
 
           /* We are not sure of the state of the file buffer so
@@ -904,7 +994,19 @@ fat_read_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+          if (nclusters > 0)
+            {
+              /* The read went on into the following contiguous clusters,
+               * continue the chain walk from the last one.
+               */
+
+              ff->ff_currentcluster = lastcluster;
+              ff->ff_pos           += nclusters * fs->fs_fatsecperclus *
+                                      fs->fs_hwsectorsize;
+            }
+
+          ff->ff_sectorsincluster += nclusters * fs->fs_fatsecperclus -
+                                     nsectors;
           ff->ff_currentsector    += nsectors;
           bytesread                = nsectors * fs->fs_hwsectorsize;
         }
@@ -1909,6 +2011,12 @@ static int fat_truncate(FAR struct file *filep, off_t length)
       ndx      = (ff->ff_dirindex & DIRSEC_NDXMASK(fs)) * DIR_SIZE;
       direntry = &fs->fs_buffer[ndx];
 
+      /* The tail of the cluster chain goes away, forget what the open
+       * instances of the file know about it.
+       */
+
+      fat_extentinvalidate(fs, ff->ff_startcluster);
+
       /* Handle the simple case where we are shrinking the file to zero
        * length.
        */
@@ -2348,9 +2456,9 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* Release the mountpoint private data */
 
-  if (fs->fs_buffer)
+  if (fs->fs_cachebuffer)
     {
-      fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
+      fat_io_free(fs->fs_cachebuffer, FAT_NCACHE * fs->fs_hwsectorsize);
     }
 
   nxmutex_destroy(&fs->fs_lock);
@@ -338,6 +338,30 @@
 
 #define UMOUNT_FORCED        8
 
+/* Mountpoint sector cache.  FAT table sectors and the other (directory,
+ * FSINFO) sectors are cached in separate LRU pools, so that walking a long
+ * cluster chain does not evict the directory sectors and vice versa.
+ */
+
+#ifndef CONFIG_FAT_FATCACHE_NSECTORS
+#  define CONFIG_FAT_FATCACHE_NSECTORS 1
+#endif
+
+#ifndef CONFIG_FAT_DIRCACHE_NSECTORS
+#  define CONFIG_FAT_DIRCACHE_NSECTORS 1
+#endif
+
+#define FAT_NCACHE           (CONFIG_FAT_FATCACHE_NSECTORS + \
+                              CONFIG_FAT_DIRCACHE_NSECTORS)
+
+#define FAT_CACHE_BUFFER(f,i) (&(f)->fs_cachebuffer[(i) * (f)->fs_hwsectorsize])
+
+/* Per-file cluster chain extent cache */
+
+#ifndef CONFIG_FAT_NEXTENTS
+#  define CONFIG_FAT_NEXTENTS  0
+#endif
+
 /****************************************************************************
  * These offset describe the FSINFO sector
  */
@@ -860,6 +884,17 @@
  * is mounted with a fat32 filesystem.
  */
 
+/* One entry of the mountpoint sector cache.  The entry that fs_buffer
+ * refers to is described by fs_currentsector and fs_dirty instead.
+ */
+
+struct fat_cache_s
+{
+  off_t    fc_sector;              /* The sector in the entry, -1 if none */
+  uint32_t fc_stamp;               /* LRU stamp of the last access */
+  bool     fc_dirty;               /* true: The entry must be written back */
+};
+
 struct fat_file_s;
 struct fat_mountpt_s
 {
@@ -887,10 +922,28 @@ struct fat_mountpt_s
   uint8_t  fs_type;                /* FSTYPE_FAT12, FSTYPE_FAT16, or FSTYPE_FAT32 */
   uint8_t  fs_fatnumfats;          /* MBR: Number of FATs (probably 2) */
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
-  uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
-                                    * sector from the device */
+  uint8_t  fs_cacheindex;          /* The cache entry used as fs_buffer */
+  uint32_t fs_cachestamp;          /* LRU clock of the sector cache */
+  uint8_t *fs_buffer;              /* The buffer of the current sector in the
+                                    * sector cache */
+  uint8_t *fs_cachebuffer;         /* Buffers of all sector cache entries */
+  struct fat_cache_s fs_cache[FAT_NCACHE];
 };
 
+/* A run of contiguous clusters of a file: file clusters [fe_index,
+ * fe_index + fe_count) are the clusters [fe_cluster, fe_cluster + fe_count)
+ * on the media.
+ */
+
+#if CONFIG_FAT_NEXTENTS > 0
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* Index of the first cluster in the file */
+  uint32_t fe_cluster;             /* The first cluster on the media */
+  uint32_t fe_count;               /* Number of clusters, 0 if unused */
+};
+#endif
+
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
  * opened file.
@@ -911,6 +964,10 @@ struct fat_file_s
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   off_t    ff_pos;                 /* Current position in the file */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#if CONFIG_FAT_NEXTENTS > 0
+  uint8_t  ff_extnext;             /* Next extent to be replaced */
+  struct fat_extent_s ff_extents[CONFIG_FAT_NEXTENTS];
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1097,6 +1154,21 @@ EXTERN int    fat_ffcacheread(FAR struct fat_mountpt_s *fs,
                               FAR struct fat_file_s *ff, off_t sector);
 EXTERN int    fat_ffcacheinvalidate(FAR struct fat_mountpt_s *fs,
                                     FAR struct fat_file_s *ff);
+EXTERN void   fat_fscacheinit(FAR struct fat_mountpt_s *fs);
+
+/* Cluster chain extent cache (for fast seeks) */
+
+#if CONFIG_FAT_NEXTENTS > 0
+EXTERN void   fat_extentadd(FAR struct fat_file_s *ff, uint32_t index,
+                            uint32_t cluster);
+EXTERN uint32_t fat_extentlookup(FAR struct fat_file_s *ff, uint32_t index,
+                                 FAR uint32_t *cluster);
+EXTERN void   fat_extentinvalidate(FAR struct fat_mountpt_s *fs,
+                                   off_t startcluster);
+#else
+#  define fat_extentadd(ff,i,c)
+#  define fat_extentinvalidate(fs,c)
+#endif
 
 /* FSINFO sector support */
 
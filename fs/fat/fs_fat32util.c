@@ -263,6 +263,138 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fscachestale
+ *
+ * Description:
+ *   Sectors [sector, sector + nsectors) were written from 'buffer'.  Drop
+ *   the copies of them held by other cache entries, they are stale now.
+ *
+ ****************************************************************************/
+
+static void fat_fscachestale(struct fat_mountpt_s *fs, uint8_t *buffer,
+                             off_t sector, unsigned int nsectors)
+{
+  int i;
+
+  if (fs->fs_cachebuffer == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < FAT_NCACHE; i++)
+    {
+      FAR struct fat_cache_s *entry = &fs->fs_cache[i];
+
+      if (i == fs->fs_cacheindex)
+        {
+          if (fs->fs_currentsector >= sector &&
+              fs->fs_currentsector < sector + nsectors &&
+              fs->fs_buffer != buffer)
+            {
+              fs->fs_currentsector = -1;
+              fs->fs_dirty         = false;
+            }
+        }
+      else if (entry->fc_sector >= sector &&
+               entry->fc_sector < sector + nsectors &&
+               FAT_CACHE_BUFFER(fs, i) != buffer)
+        {
+          entry->fc_sector = -1;
+          entry->fc_dirty  = false;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_fscachewrite
+ *
+ * Description:
+ *   Write one cached sector back to the media, and to the other copies of
+ *   the FAT if the sector lies in the FAT region.
+ *
+ ****************************************************************************/
+
+static int fat_fscachewrite(struct fat_mountpt_s *fs, uint8_t *buffer,
+                            off_t sector)
+{
+  int ret;
+  int i;
+
+  ret = fat_hwwrite(fs, buffer, sector, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Does the sector lie in the FAT region? */
+
+  if (sector >= fs->fs_fatbase &&
+      sector < fs->fs_fatbase + fs->fs_nfatsects)
+    {
+      /* Yes, then make the change in the FAT copy as well */
+
+      for (i = fs->fs_fatnumfats; i >= 2; i--)
+        {
+          sector += fs->fs_nfatsects;
+          ret = fat_hwwrite(fs, buffer, sector, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscachevictim
+ *
+ * Description:
+ *   Select the least recently used entry of the pool that 'sector' belongs
+ *   to: FAT table sectors and the other sectors are cached separately.
+ *
+ ****************************************************************************/
+
+static int fat_fscachevictim(struct fat_mountpt_s *fs, off_t sector)
+{
+  uint32_t oldest = UINT32_MAX;
+  int victim;
+  int first;
+  int last;
+  int i;
+
+  if (sector >= fs->fs_fatbase &&
+      sector < fs->fs_fatbase + fs->fs_nfatsects)
+    {
+      first = 0;
+      last  = CONFIG_FAT_FATCACHE_NSECTORS;
+    }
+  else
+    {
+      first = CONFIG_FAT_FATCACHE_NSECTORS;
+      last  = FAT_NCACHE;
+    }
+
+  victim = first;
+  for (i = first; i < last; i++)
+    {
+      if (fs->fs_cache[i].fc_sector < 0)
+        {
+          return i;
+        }
+
+      if (fs->fs_cache[i].fc_stamp < oldest)
+        {
+          oldest = fs->fs_cache[i].fc_stamp;
+          victim = i;
+        }
+    }
+
+  return victim;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -504,15 +636,18 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   fs->fs_hwsectorsize = geo.geo_sectorsize;
   fs->fs_hwnsectors   = geo.geo_nsectors;
 
-  /* Allocate a buffer to hold one hardware sector */
+  /* Allocate the sector cache, FAT_NCACHE hardware sectors */
 
-  fs->fs_buffer = (FAR uint8_t *)fat_io_alloc(fs->fs_hwsectorsize);
-  if (!fs->fs_buffer)
+  fs->fs_cachebuffer = (FAR uint8_t *)
+    fat_io_alloc(FAT_NCACHE * fs->fs_hwsectorsize);
+  if (!fs->fs_cachebuffer)
     {
       ret = -ENOMEM;
       goto errout;
     }
 
+  fat_fscacheinit(fs);
+
   /* Search FAT boot record on the drive.  First check the MBR at sector
    * zero.  This could be either the boot record or a partition that refers
    * to the boot record.
@@ -651,8 +786,9 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
-  fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
-  fs->fs_buffer = NULL;
+  fat_io_free(fs->fs_cachebuffer, FAT_NCACHE * fs->fs_hwsectorsize);
+  fs->fs_cachebuffer = NULL;
+  fs->fs_buffer      = NULL;
 
 errout:
   fs->fs_mounted = false;
@@ -757,6 +893,10 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
           ssize_t nsectorswritten =
               inode->u.i_bops->write(inode, buffer, sector, nsectors);
 
+          /* Other cached copies of these sectors are no longer valid */
+
+          fat_fscachestale(fs, buffer, sector, nsectors);
+
           if (nsectorswritten == nsectors)
             {
               ret = OK;
@@ -1751,17 +1891,45 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fscacheinit
+ *
+ * Description:
+ *   Initialize the sector cache to the empty state, with the first entry
+ *   as fs_buffer.
+ *
+ ****************************************************************************/
+
+void fat_fscacheinit(struct fat_mountpt_s *fs)
+{
+  int i;
+
+  for (i = 0; i < FAT_NCACHE; i++)
+    {
+      fs->fs_cache[i].fc_sector = -1;
+      fs->fs_cache[i].fc_stamp  = 0;
+      fs->fs_cache[i].fc_dirty  = false;
+    }
+
+  fs->fs_cacheindex    = 0;
+  fs->fs_cachestamp    = 0;
+  fs->fs_buffer        = fs->fs_cachebuffer;
+  fs->fs_currentsector = -1;
+  fs->fs_dirty         = false;
+}
+
 /****************************************************************************
  * Name: fat_fscacheflush
  *
  * Description:
- *   Flush any dirty sector if fs_buffer as necessary
+ *   Flush all dirty sectors of the sector cache as necessary
  *
  ****************************************************************************/
 
 int fat_fscacheflush(struct fat_mountpt_s *fs)
 {
   int ret;
+  int i;
 
   /* Check if the fs_buffer is dirty.  In this case, we will write back the
    * contents of fs_buffer.
@@ -1769,37 +1937,32 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
 
   if (fs->fs_dirty)
     {
-      /* Write the dirty sector */
-
-      ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
+      ret = fat_fscachewrite(fs, fs->fs_buffer, fs->fs_currentsector);
       if (ret < 0)
         {
           return ret;
         }
 
-      /* Does the sector lie in the FAT region? */
+      /* No longer dirty */
 
-      if (fs->fs_currentsector >= fs->fs_fatbase &&
-          fs->fs_currentsector < fs->fs_fatbase + fs->fs_nfatsects)
-        {
-          int i;
+      fs->fs_dirty = false;
+    }
 
-          /* Yes, then make the change in the FAT copy as well */
+  /* Then the other dirty entries of the cache */
 
-          for (i = fs->fs_fatnumfats; i >= 2; i--)
+  for (i = 0; i < FAT_NCACHE; i++)
+    {
+      if (i != fs->fs_cacheindex && fs->fs_cache[i].fc_dirty)
+        {
+          ret = fat_fscachewrite(fs, FAT_CACHE_BUFFER(fs, i),
+                                 fs->fs_cache[i].fc_sector);
+          if (ret < 0)
             {
-              fs->fs_currentsector += fs->fs_nfatsects;
-              ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
-              if (ret < 0)
-                {
-                  return ret;
-                }
+              return ret;
             }
-        }
-
-      /* No longer dirty */
 
-      fs->fs_dirty = false;
+          fs->fs_cache[i].fc_dirty = false;
+        }
     }
 
   return OK;
@@ -1809,45 +1972,107 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
  * Name: fat_fscacheread
  *
  * Description:
- *   Read the specified sector into the sector cache, flushing any existing
- *   dirty sectors as necessary.
+ *   Make the specified sector the current one in fs_buffer, reading it into
+ *   the sector cache if it is not cached, and writing back the dirty sector
+ *   that it replaces as necessary.
  *
  ****************************************************************************/
 
 int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 {
+  FAR struct fat_cache_s *entry;
+  int index;
   int ret;
+  int i;
 
   /* fs->fs_currentsector holds the current sector that is buffered in
    * fs->fs_buffer. If the requested sector is the same as this sector, then
-   * we do nothing. Otherwise, we will have to read the new sector.
+   * we do nothing.
    */
 
-  if (fs->fs_currentsector != sector)
+  if (fs->fs_currentsector == sector)
     {
-      /* We will need to read the new sector.  First, flush the cached
-       * sector if it is dirty.
+      return OK;
+    }
+
+  /* Save the state of the current entry.  Its sector may have been set
+   * without reading it (e.g. a new directory cluster), so it replaces any
+   * other copy of that sector in the cache.
+   */
+
+  entry            = &fs->fs_cache[fs->fs_cacheindex];
+  entry->fc_sector = fs->fs_currentsector;
+  entry->fc_dirty  = fs->fs_dirty;
+
+  index = -1;
+  for (i = 0; i < FAT_NCACHE; i++)
+    {
+      if (i == fs->fs_cacheindex)
+        {
+          continue;
+        }
+
+      if (fs->fs_cache[i].fc_sector == sector)
+        {
+          index = i;
+        }
+      else if (fs->fs_cache[i].fc_sector == entry->fc_sector)
+        {
+          fs->fs_cache[i].fc_sector = -1;
+          fs->fs_cache[i].fc_dirty  = false;
+        }
+    }
+
+  if (index < 0)
+    {
+      /* We will need to read the new sector.  First, write back the entry
+       * to be reused if it is dirty.
        */
 
-      ret = fat_fscacheflush(fs);
-      if (ret < 0)
+      index = fat_fscachevictim(fs, sector);
+      entry = &fs->fs_cache[index];
+
+      if (entry->fc_dirty)
         {
-          return ret;
+          ret = fat_fscachewrite(fs, FAT_CACHE_BUFFER(fs, index),
+                                 entry->fc_sector);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          entry->fc_dirty = false;
+          if (index == fs->fs_cacheindex)
+            {
+              fs->fs_dirty = false;
+            }
+        }
+
+      entry->fc_sector = -1;
+      if (index == fs->fs_cacheindex)
+        {
+          fs->fs_currentsector = -1;
         }
 
       /* Then read the specified sector into the cache */
 
-      ret = fat_hwread(fs, fs->fs_buffer, sector, 1);
+      ret = fat_hwread(fs, FAT_CACHE_BUFFER(fs, index), sector, 1);
       if (ret < 0)
         {
           return ret;
         }
 
-      /* Update the cached sector number */
-
-      fs->fs_currentsector = sector;
+      entry->fc_sector = sector;
     }
 
+  /* Make it the current sector */
+
+  entry                = &fs->fs_cache[index];
+  entry->fc_stamp      = ++fs->fs_cachestamp;
+  fs->fs_cacheindex    = index;
+  fs->fs_buffer        = FAT_CACHE_BUFFER(fs, index);
+  fs->fs_currentsector = sector;
+  fs->fs_dirty         = entry->fc_dirty;
   return OK;
 }
 
@@ -2199,3 +2424,126 @@ int fat_currentsector(struct fat_mountpt_s *fs, struct fat_file_s *ff,
 
   return -ENOSPC;
 }
+
+/****************************************************************************
+ * Name: fat_extentadd
+ *
+ * Description:
+ *   Record that the cluster 'index' of the file is 'cluster' on the media,
+ *   growing the extent that it continues or starting a new one.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NEXTENTS > 0
+void fat_extentadd(struct fat_file_s *ff, uint32_t index, uint32_t cluster)
+{
+  FAR struct fat_extent_s *ext;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_NEXTENTS; i++)
+    {
+      ext = &ff->ff_extents[i];
+      if (ext->fe_count == 0)
+        {
+          continue;
+        }
+
+      /* Already known? */
+
+      if (index >= ext->fe_index && index < ext->fe_index + ext->fe_count)
+        {
+          return;
+        }
+
+      /* Does it continue this extent? */
+
+      if (index == ext->fe_index + ext->fe_count &&
+          cluster == ext->fe_cluster + ext->fe_count)
+        {
+          ext->fe_count++;
+          return;
+        }
+    }
+
+  /* Start a new extent, replacing the oldest one */
+
+  ext = &ff->ff_extents[ff->ff_extnext];
+  ext->fe_index   = index;
+  ext->fe_cluster = cluster;
+  ext->fe_count   = 1;
+
+  if (++ff->ff_extnext >= CONFIG_FAT_NEXTENTS)
+    {
+      ff->ff_extnext = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_extentlookup
+ *
+ * Description:
+ *   Find the cached cluster of the file closest to, but not beyond, the
+ *   cluster 'index'.
+ *
+ * Returned Value:
+ *   The number of clusters of the chain up to the one found, i.e. its index
+ *   plus one, with the cluster returned in 'cluster'.  Zero if none is
+ *   known.
+ *
+ ****************************************************************************/
+
+uint32_t fat_extentlookup(struct fat_file_s *ff, uint32_t index,
+                          FAR uint32_t *cluster)
+{
+  FAR struct fat_extent_s *ext;
+  uint32_t known = 0;
+  uint32_t last;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_NEXTENTS; i++)
+    {
+      ext = &ff->ff_extents[i];
+      if (ext->fe_count == 0 || ext->fe_index > index)
+        {
+          continue;
+        }
+
+      last = ext->fe_index + ext->fe_count - 1;
+      if (last > index)
+        {
+          last = index;
+        }
+
+      if (last + 1 > known)
+        {
+          known    = last + 1;
+          *cluster = ext->fe_cluster + (last - ext->fe_index);
+        }
+    }
+
+  return known;
+}
+
+/****************************************************************************
+ * Name: fat_extentinvalidate
+ *
+ * Description:
+ *   Forget the extents of all open instances of the file that starts at
+ *   'startcluster', its cluster chain is being changed.
+ *
+ ****************************************************************************/
+
+void fat_extentinvalidate(struct fat_mountpt_s *fs, off_t startcluster)
+{
+  FAR struct fat_file_s *ff;
+
+  for (ff = fs->fs_head; ff != NULL; ff = ff->ff_next)
+    {
+      if (ff->ff_startcluster == startcluster)
+        {
+          memset(ff->ff_extents, 0, sizeof(ff->ff_extents));
+          ff->ff_extnext = 0;
+        }
+    }
+}
+#endif /* CONFIG_FAT_NEXTENTS > 0 */
@@ -0,0 +1,489 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "inode/inode.h"
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_INODE_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_FS_INODE_CACHE_SIZE & (CONFIG_FS_INODE_CACHE_SIZE - 1)) != 0
+#  error CONFIG_FS_INODE_CACHE_SIZE must be a power of two
+#endif
+
+#define INODE_CACHE_MASK    (CONFIG_FS_INODE_CACHE_SIZE - 1)
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by the procfs logic.
+ */
+
+#define INODE_CACHE_LINELEN 192
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached path lookup.  The entry holds the result of _inode_search()
+ * for the absolute path, relpath is kept as an offset into the path.
+ */
+
+struct inode_cache_s
+{
+  FAR struct inode *node;                    /* The inode found */
+  FAR struct inode *peer;                    /* Node to the "left" */
+  FAR struct inode *parent;                  /* Node "above" */
+  uint32_t hash;                             /* Hash of the path */
+  uint16_t reloff;                           /* Offset of relpath in path */
+  char path[CONFIG_FS_INODE_CACHE_PATHLEN];  /* The absolute path */
+};
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_INODECACHE)
+
+/* This structure describes one open "file" */
+
+struct inodecache_file_s
+{
+  struct procfs_file_s base;        /* Base open file structure */
+  unsigned int linesize;            /* Number of valid characters in line[] */
+  char line[INODE_CACHE_LINELEN];   /* Pre-allocated buffer for lines */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_INODECACHE)
+
+/* File system methods */
+
+static int     inodecache_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     inodecache_close(FAR struct file *filep);
+static ssize_t inodecache_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     inodecache_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     inodecache_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The direct mapped cache.  A slot is unused while its node is NULL. */
+
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODE_CACHE_SIZE];
+
+/* The lookups run concurrently under the inode read lock, the slots are
+ * protected by this spinlock.
+ */
+
+static spinlock_t g_inode_cache_lock = SP_UNLOCKED;
+
+/* Statistics reported through procfs */
+
+static uint32_t g_inode_cache_hits;
+static uint32_t g_inode_cache_misses;
+static uint32_t g_inode_cache_flushes;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_INODECACHE)
+
+/* See fs_procfs.c -- this structure is explicitly externed there. */
+
+const struct procfs_operations g_inodecache_operations =
+{
+  inodecache_open,    /* open */
+  inodecache_close,   /* close */
+  inodecache_read,    /* read */
+  NULL,               /* write */
+  NULL,               /* poll */
+
+  inodecache_dup,     /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  inodecache_stat     /* stat */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Hash the path with FNV-1a and return its length.
+ *
+ ****************************************************************************/
+
+static uint32_t inode_cache_hash(FAR const char *path, FAR size_t *len)
+{
+  FAR const char *ptr = path;
+  uint32_t hash = 2166136261u;
+
+  while (*ptr != '\0')
+    {
+      hash ^= (uint8_t)*ptr++;
+      hash *= 16777619u;
+    }
+
+  *len = ptr - path;
+  return hash;
+}
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_INODECACHE)
+
+/****************************************************************************
+ * Name: inodecache_open
+ ****************************************************************************/
+
+static int inodecache_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode)
+{
+  FAR struct inodecache_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct inodecache_file_s));
+  if (attr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inodecache_close
+ ****************************************************************************/
+
+static int inodecache_close(FAR struct file *filep)
+{
+  FAR struct inodecache_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inodecache_read
+ ****************************************************************************/
+
+static ssize_t inodecache_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR struct inodecache_file_s *attr;
+  irqstate_t flags;
+  uint32_t lookups;
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t flushes;
+  int used = 0;
+  off_t offset;
+  ssize_t ret;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = filep->f_priv;
+  DEBUGASSERT(attr);
+
+  if (filep->f_pos == 0)
+    {
+      flags   = spin_lock_irqsave(&g_inode_cache_lock);
+      hits    = g_inode_cache_hits;
+      misses  = g_inode_cache_misses;
+      flushes = g_inode_cache_flushes;
+
+      for (i = 0; i < CONFIG_FS_INODE_CACHE_SIZE; i++)
+        {
+          if (g_inode_cache[i].node != NULL)
+            {
+              used++;
+            }
+        }
+
+      spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+
+      lookups = hits + misses;
+      attr->linesize =
+        procfs_snprintf(attr->line, INODE_CACHE_LINELEN,
+                        "Entries: %d/%d\n"
+                        "Hits:    %" PRIu32 "\n"
+                        "Misses:  %" PRIu32 "\n"
+                        "Flushes: %" PRIu32 "\n"
+                        "Hitrate: %" PRIu32 "%%\n",
+                        used, CONFIG_FS_INODE_CACHE_SIZE, hits, misses,
+                        flushes, lookups ?
+                        (uint32_t)((uint64_t)hits * 100 / lookups) : 0);
+    }
+
+  offset = filep->f_pos;
+  ret = procfs_memcpy(attr->line, attr->linesize, buffer, buflen, &offset);
+
+  /* Update the file offset */
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: inodecache_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int inodecache_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct inodecache_file_s *oldattr;
+  FAR struct inodecache_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct inodecache_file_s));
+  if (newattr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct inodecache_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inodecache_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int inodecache_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "fs/inodecache" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the absolute path in the path cache.  On a hit, the search
+ *   descriptor is filled in as _inode_search() would have done.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR struct inode_search_s *desc)
+{
+  FAR struct inode_cache_s *entry;
+  FAR const char *path = desc->path;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+  bool hit = false;
+
+  hash  = inode_cache_hash(path, &len);
+  entry = &g_inode_cache[hash & INODE_CACHE_MASK];
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+  if (entry->node != NULL && entry->hash == hash &&
+      strcmp(entry->path, path) == 0)
+    {
+      desc->node    = entry->node;
+      desc->peer    = entry->peer;
+      desc->parent  = entry->parent;
+      desc->path    = path + entry->reloff;
+      desc->relpath = desc->path;
+      g_inode_cache_hits++;
+      hit = true;
+    }
+  else
+    {
+      g_inode_cache_misses++;
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+  return hit;
+}
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember the successful search of the absolute path.  Searches that
+ *   end in an allocated path buffer (a soft link into a mountpoint) and
+ *   the paths too long for a slot are not cached.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+void inode_cache_add(FAR const char *path,
+                     FAR const struct inode_search_s *desc)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+
+  hash = inode_cache_hash(path, &len);
+  if (len >= CONFIG_FS_INODE_CACHE_PATHLEN || desc->relpath != desc->path ||
+      desc->relpath < path || desc->relpath > path + len)
+    {
+      return;
+    }
+
+  entry = &g_inode_cache[hash & INODE_CACHE_MASK];
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+  entry->node   = desc->node;
+  entry->peer   = desc->peer;
+  entry->parent = desc->parent;
+  entry->hash   = hash;
+  entry->reloff = desc->relpath - path;
+  memcpy(entry->path, path, len + 1);
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_flush
+ *
+ * Description:
+ *   Invalidate the whole path cache.  This must be called whenever the
+ *   shape of the inode tree changes.
+ *
+ * Assumptions:
+ *   The caller holds the inode write lock.
+ *
+ ****************************************************************************/
+
+void inode_cache_flush(void)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+  for (i = 0; i < CONFIG_FS_INODE_CACHE_SIZE; i++)
+    {
+      g_inode_cache[i].node = NULL;
+    }
+
+  g_inode_cache_flushes++;
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+#endif /* CONFIG_FS_INODE_CACHE */
@@ -97,6 +97,10 @@ static FAR struct inode *inode_unlink(FAR const char *path)
       inode->i_peer   = NULL;
       inode->i_parent = NULL;
       atomic_fetch_sub(&inode->i_crefs, 1);
+
+      /* The cached lookups may no longer be valid */
+
+      inode_cache_flush();
     }
 
   RELEASE_SEARCH(&desc);
@@ -127,6 +127,10 @@ static void inode_insert(FAR struct inode *inode,
       inode->i_parent = parent;
       parent->i_child = inode;
     }
+
+  /* The cached lookups may no longer be valid */
+
+  inode_cache_flush();
 }
 
 /****************************************************************************
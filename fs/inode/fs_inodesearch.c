@@ -466,6 +466,10 @@ static FAR const char *_inode_getcwd(void)
 
 int inode_search(FAR struct inode_search_s *desc)
 {
+#ifdef CONFIG_FS_INODE_CACHE
+  FAR const char *path;
+  FAR char *buffer;
+#endif
   int ret;
 
   /* Perform the common _inode_search() logic.  This does everything except
@@ -489,7 +493,28 @@ int inode_search(FAR struct inode_search_s *desc)
       desc->path = desc->buffer;
     }
 
+#ifdef CONFIG_FS_INODE_CACHE
+  /* Try the path cache first, and remember the result of a full search
+   * unless a soft link released the path buffer on the way.
+   */
+
+  if (inode_cache_lookup(desc))
+    {
+      ret = OK;
+    }
+  else
+    {
+      path   = desc->path;
+      buffer = desc->buffer;
+      ret    = _inode_search(desc);
+      if (ret >= 0 && desc->buffer == buffer)
+        {
+          inode_cache_add(path, desc);
+        }
+    }
+#else
   ret = _inode_search(desc);
+#endif
 
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
   if (ret >= 0)
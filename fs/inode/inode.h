@@ -235,6 +235,29 @@ void inode_runlock(void);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_cache_lookup, inode_cache_add and inode_cache_flush
+ *
+ * Description:
+ *   The path lookup cache of inode_search().  inode_cache_flush() must be
+ *   called whenever an inode is linked into or unlinked from the tree.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+bool inode_cache_lookup(FAR struct inode_search_s *desc);
+void inode_cache_add(FAR const char *path,
+                     FAR const struct inode_search_s *desc);
+void inode_cache_flush(void);
+#else
+#  define inode_cache_lookup(d) false
+#  define inode_cache_add(p, d)
+#  define inode_cache_flush()
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
@@ -72,6 +72,7 @@ extern const struct procfs_operations g_tcbinfo_operations;
 extern const struct procfs_operations g_thermal_operations;
 extern const struct procfs_operations g_uptime_operations;
 extern const struct procfs_operations g_version_operations;
+extern const struct procfs_operations g_wqueue_operations;
 extern const struct procfs_operations g_pressure_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
@@ -80,6 +81,7 @@ extern const struct procfs_operations g_pressure_operations;
  * configuration.
  */
 
+extern const struct procfs_operations g_inodecache_operations;
 extern const struct procfs_operations g_mount_operations;
 extern const struct procfs_operations g_net_operations;
 extern const struct procfs_operations g_netroute_operations;
@@ -132,6 +134,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/blocks",    &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_FS_INODE_CACHE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_INODECACHE)
+  { "fs/inodecache", &g_inodecache_operations, PROCFS_FILE_TYPE },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MOUNT
   { "fs/mount",     &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
@@ -211,6 +217,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_VERSION
   { "version",      &g_version_operations,  PROCFS_FILE_TYPE   },
 #endif
+
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+  { "wqueue",       &g_wqueue_operations,   PROCFS_FILE_TYPE   },
+#endif
 };
 
 #ifdef CONFIG_FS_PROCFS_REGISTER
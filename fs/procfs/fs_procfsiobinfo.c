@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -185,6 +186,9 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
   size_t copysize;
   size_t totalsize;
   off_t offset;
+#ifdef CONFIG_IOB_CACHE
+  int i;
+#endif
 
   finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
 
@@ -221,6 +225,36 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
                              &offset);
   totalsize += copysize;
 
+#ifdef CONFIG_IOB_CACHE
+  /* Followed by the statistics of the per-CPU caches */
+
+  buffer   += copysize;
+  buflen   -= copysize;
+
+  linesize  = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                              "%10s%10s%10s%10s%10s\n",
+                              "cpu", "ncached", "nhit", "nmiss", "ndrain");
+  copysize  = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize += copysize;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      buffer   += copysize;
+      buflen   -= copysize;
+
+      linesize  = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                                  "%10d%10d%10" PRIu32 "%10" PRIu32
+                                  "%10" PRIu32 "\n",
+                                  i, stats.cache[i].ncached,
+                                  stats.cache[i].nhit, stats.cache[i].nmiss,
+                                  stats.cache[i].ndrain);
+      copysize  = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                &offset);
+      totalsize += copysize;
+    }
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
@@ -340,6 +340,34 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
           copysize   = procfs_memcpy(procfile->line, linesize, buffer,
                                      buflen, &offset);
           totalsize += copysize;
+
+#if CONFIG_MM_HEAP_ARENAS > 1
+          /* Show the information of each arena of the heap */
+
+          int i;
+
+          for (i = 0; buflen > 0 &&
+                      mm_mallinfo_arena(entry->heap, i, &info) >= 0; i++)
+            {
+              buffer    += copysize;
+              buflen    -= copysize;
+
+              linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                           "%11lu%11lu%11lu%11lu%11lu"
+                                           "%7lu%7lu %s.%d\n",
+                                           (unsigned long)info.arena,
+                                           (unsigned long)info.uordblks,
+                                           (unsigned long)info.fordblks,
+                                           (unsigned long)info.usmblks,
+                                           (unsigned long)info.mxordblk,
+                                           (unsigned long)info.aordblks,
+                                           (unsigned long)info.ordblks,
+                                           entry->name, i);
+              copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                         buflen, &offset);
+              totalsize += copysize;
+            }
+#endif
         }
     }
 
@@ -94,9 +94,30 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+#ifdef TMPFS_PAGESIZE
+static int  tmpfs_realloc_pages(FAR struct tmpfs_file_s *tfo,
+              size_t newsize);
+#endif
+static void tmpfs_free_filedata(FAR struct tmpfs_file_s *tfo);
+static FAR uint8_t *tmpfs_file_addr(FAR struct tmpfs_file_s *tfo,
+              size_t pos, FAR size_t *avail);
+static void tmpfs_read_data(FAR struct tmpfs_file_s *tfo, size_t pos,
+              FAR char *buffer, size_t len);
+static void tmpfs_write_data(FAR struct tmpfs_file_s *tfo, size_t pos,
+              FAR const char *buffer, size_t len);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
+#ifdef TMPFS_DIRECTORY_HASH
+static uint32_t tmpfs_hash_name(FAR const char *name, size_t len);
+static int  tmpfs_hash_rebuild(FAR struct tmpfs_directory_s *tdo);
+static FAR uint16_t *tmpfs_hash_link(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
+static void tmpfs_hash_add(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
+static void tmpfs_hash_remove(FAR struct tmpfs_directory_s *tdo,
+              unsigned int index);
+#endif
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
               FAR const char *name, size_t len);
 static int  tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -275,6 +296,26 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
   size_t allocsize;
   size_t delta;
 
+  /* The data of a pinned file must stay in place, it may only be resized
+   * within its allocation.
+   */
+
+  if (tfo->tfo_pins > 0 &&
+      (newsize == 0 || newsize > tfo->tfo_alloc ||
+       tfo->tfo_alloc - newsize > CONFIG_FS_TMPFS_FILE_FREEGUARD))
+    {
+      return -EBUSY;
+    }
+
+#ifdef TMPFS_PAGESIZE
+  /* Is the file or will it be larger than one page? */
+
+  if (newsize > TMPFS_PAGESIZE || tfo->tfo_pages != NULL)
+    {
+      return tmpfs_realloc_pages(tfo, newsize);
+    }
+#endif
+
   /* Are we growing or shrinking the object? */
 
   if (newsize <= tfo->tfo_alloc)
@@ -326,6 +367,13 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
       return -ENOMEM;
     }
 
+#ifdef TMPFS_PAGESIZE
+  if (allocsize > TMPFS_PAGESIZE)
+    {
+      allocsize = TMPFS_PAGESIZE;
+    }
+#endif
+
   /* Realloc the file object */
 
   newdata = fs_heap_realloc(tfo->tfo_data, allocsize);
@@ -342,6 +390,254 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_realloc_pages
+ *
+ * Description:
+ *   Resize a file kept in pages.  Growing the file allocates the new pages
+ *   and, now and then, a larger page table, but never moves the data.
+ *   Shrinking it frees the pages past the new end of the file.
+ *
+ ****************************************************************************/
+
+#ifdef TMPFS_PAGESIZE
+static int tmpfs_realloc_pages(FAR struct tmpfs_file_s *tfo,
+                               size_t newsize)
+{
+  FAR uint8_t **pages;
+  FAR uint8_t *page;
+  size_t maxpages;
+  size_t npages;
+  size_t i;
+
+  if (newsize > SIZE_MAX - TMPFS_PAGESIZE)
+    {
+      return -ENOMEM;
+    }
+
+  npages = (newsize + TMPFS_PAGESIZE - 1) / TMPFS_PAGESIZE;
+
+  /* Is the file outgrowing its only buffer? */
+
+  if (tfo->tfo_pages == NULL)
+    {
+      /* Yes.. make the buffer its first page */
+
+      page = fs_heap_realloc(tfo->tfo_data, TMPFS_PAGESIZE);
+      if (page == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      tfo->tfo_alloc = TMPFS_PAGESIZE;
+      tfo->tfo_data  = page;
+
+      pages = fs_heap_malloc(npages * sizeof(FAR uint8_t *));
+      if (pages == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      pages[0]          = page;
+      tfo->tfo_pages    = pages;
+      tfo->tfo_npages   = 1;
+      tfo->tfo_maxpages = npages;
+    }
+
+  /* Is the file shrinking back to one page or less? */
+
+  else if (npages <= 1)
+    {
+      /* Yes.. free all of the pages but the first one, and the table */
+
+      for (i = 1; i < tfo->tfo_npages; i++)
+        {
+          fs_heap_free(tfo->tfo_pages[i]);
+        }
+
+      fs_heap_free(tfo->tfo_pages);
+      tfo->tfo_pages    = NULL;
+      tfo->tfo_npages   = 0;
+      tfo->tfo_maxpages = 0;
+      tfo->tfo_alloc    = TMPFS_PAGESIZE;
+
+      if (npages == 0)
+        {
+          fs_heap_free(tfo->tfo_data);
+          tfo->tfo_data  = NULL;
+          tfo->tfo_alloc = 0;
+        }
+
+      tfo->tfo_size = newsize;
+      return OK;
+    }
+
+  /* Grow the page table, doubling it so that appending to the file costs
+   * O(1) on average.
+   */
+
+  if (npages > tfo->tfo_maxpages)
+    {
+      maxpages = tfo->tfo_maxpages * 2;
+      if (maxpages < npages)
+        {
+          maxpages = npages;
+        }
+
+      pages = fs_heap_realloc(tfo->tfo_pages,
+                              maxpages * sizeof(FAR uint8_t *));
+      if (pages == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      tfo->tfo_pages    = pages;
+      tfo->tfo_maxpages = maxpages;
+    }
+
+  /* Allocate the new pages */
+
+  for (i = tfo->tfo_npages; i < npages; i++)
+    {
+      page = fs_heap_malloc(TMPFS_PAGESIZE);
+      if (page == NULL)
+        {
+          while (i-- > tfo->tfo_npages)
+            {
+              fs_heap_free(tfo->tfo_pages[i]);
+            }
+
+          return -ENOMEM;
+        }
+
+      tfo->tfo_pages[i] = page;
+    }
+
+  /* Or free the pages past the end of the file */
+
+  for (i = npages; i < tfo->tfo_npages; i++)
+    {
+      fs_heap_free(tfo->tfo_pages[i]);
+    }
+
+  tfo->tfo_npages = npages;
+  tfo->tfo_alloc  = npages * TMPFS_PAGESIZE;
+  tfo->tfo_size   = newsize;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_free_filedata
+ ****************************************************************************/
+
+static void tmpfs_free_filedata(FAR struct tmpfs_file_s *tfo)
+{
+#ifdef TMPFS_PAGESIZE
+  size_t i;
+
+  if (tfo->tfo_pages != NULL)
+    {
+      /* The first page is tfo_data */
+
+      for (i = 1; i < tfo->tfo_npages; i++)
+        {
+          fs_heap_free(tfo->tfo_pages[i]);
+        }
+
+      fs_heap_free(tfo->tfo_pages);
+    }
+#endif
+
+  fs_heap_free(tfo->tfo_data);
+}
+
+/****************************************************************************
+ * Name: tmpfs_file_addr
+ *
+ * Description:
+ *   Return the address of the byte at pos in the file memory, and in avail
+ *   how many bytes are contiguous from there.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_file_addr(FAR struct tmpfs_file_s *tfo,
+                                    size_t pos, FAR size_t *avail)
+{
+#ifdef TMPFS_PAGESIZE
+  if (tfo->tfo_pages != NULL)
+    {
+      *avail = TMPFS_PAGESIZE - pos % TMPFS_PAGESIZE;
+      return tfo->tfo_pages[pos / TMPFS_PAGESIZE] + pos % TMPFS_PAGESIZE;
+    }
+#endif
+
+  *avail = tfo->tfo_alloc - pos;
+  return tfo->tfo_data + pos;
+}
+
+/****************************************************************************
+ * Name: tmpfs_read_data
+ ****************************************************************************/
+
+static void tmpfs_read_data(FAR struct tmpfs_file_s *tfo, size_t pos,
+                            FAR char *buffer, size_t len)
+{
+  FAR uint8_t *addr;
+  size_t avail;
+
+  while (len > 0)
+    {
+      addr = tmpfs_file_addr(tfo, pos, &avail);
+      if (avail > len)
+        {
+          avail = len;
+        }
+
+      memcpy(buffer, addr, avail);
+      buffer += avail;
+      pos    += avail;
+      len    -= avail;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_write_data
+ *
+ * Description:
+ *   Copy buffer to the file memory at pos, or zero it if buffer is NULL.
+ *
+ ****************************************************************************/
+
+static void tmpfs_write_data(FAR struct tmpfs_file_s *tfo, size_t pos,
+                             FAR const char *buffer, size_t len)
+{
+  FAR uint8_t *addr;
+  size_t avail;
+
+  while (len > 0)
+    {
+      addr = tmpfs_file_addr(tfo, pos, &avail);
+      if (avail > len)
+        {
+          avail = len;
+        }
+
+      if (buffer != NULL)
+        {
+          memcpy(addr, buffer, avail);
+          buffer += avail;
+        }
+      else
+        {
+          memset(addr, 0, avail);
+        }
+
+      pos += avail;
+      len -= avail;
+    }
+}
+
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
  ****************************************************************************/
@@ -379,7 +675,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_filedata(tfo);
       fs_heap_free(tfo);
     }
 
@@ -414,6 +710,170 @@ static int tmpfs_release_file(FAR struct tmpfs_file_s *tfo)
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_hash_name
+ *
+ * Description:
+ *   Hash a directory entry name with FNV-1a.
+ *
+ ****************************************************************************/
+
+#ifdef TMPFS_DIRECTORY_HASH
+static uint32_t tmpfs_hash_name(FAR const char *name, size_t len)
+{
+  uint32_t hash = 2166136261u;
+
+  while (len-- > 0)
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_rebuild
+ *
+ * Description:
+ *   (Re)build the hash index of a directory with about two buckets per
+ *   entry.  On failure, the directory keeps its current index, if any.
+ *
+ ****************************************************************************/
+
+static int tmpfs_hash_rebuild(FAR struct tmpfs_directory_s *tdo)
+{
+  FAR struct tmpfs_dirent_s *tde;
+  FAR uint16_t *hash;
+  unsigned int nbuckets;
+  unsigned int bucket;
+  unsigned int i;
+
+  for (nbuckets = 16; nbuckets < 2 * tdo->tdo_nentries &&
+       nbuckets < 32768; nbuckets <<= 1);
+
+  if (nbuckets == tdo->tdo_nbuckets)
+    {
+      return -EEXIST;
+    }
+
+  hash = fs_heap_malloc(nbuckets * sizeof(uint16_t));
+  if (hash == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < nbuckets; i++)
+    {
+      hash[i] = TMPFS_HASH_NONE;
+    }
+
+  for (i = 0; i < tdo->tdo_nentries; i++)
+    {
+      tde           = &tdo->tdo_entry[i];
+      bucket        = tde->tde_hash & (nbuckets - 1);
+      tde->tde_next = hash[bucket];
+      hash[bucket]  = i;
+    }
+
+  fs_heap_free(tdo->tdo_hash);
+  tdo->tdo_hash     = hash;
+  tdo->tdo_nbuckets = nbuckets;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_link
+ *
+ * Description:
+ *   Return the link to a directory entry in its hash chain.
+ *
+ ****************************************************************************/
+
+static FAR uint16_t *tmpfs_hash_link(FAR struct tmpfs_directory_s *tdo,
+                                     unsigned int index)
+{
+  FAR uint16_t *link;
+
+  link = &tdo->tdo_hash[tdo->tdo_entry[index].tde_hash &
+                        (tdo->tdo_nbuckets - 1)];
+  while (*link != index)
+    {
+      DEBUGASSERT(*link != TMPFS_HASH_NONE);
+      link = &tdo->tdo_entry[*link].tde_next;
+    }
+
+  return link;
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_add
+ *
+ * Description:
+ *   Add a new directory entry to the hash index, building or growing the
+ *   index if the directory has outgrown it.
+ *
+ ****************************************************************************/
+
+static void tmpfs_hash_add(FAR struct tmpfs_directory_s *tdo,
+                           unsigned int index)
+{
+  FAR uint16_t *head;
+
+  if (tdo->tdo_nentries > TMPFS_DIRECTORY_HASH &&
+      tdo->tdo_nentries > tdo->tdo_nbuckets &&
+      tmpfs_hash_rebuild(tdo) >= 0)
+    {
+      /* The new index includes the entry */
+
+      return;
+    }
+
+  if (tdo->tdo_hash != NULL)
+    {
+      head = &tdo->tdo_hash[tdo->tdo_entry[index].tde_hash &
+                            (tdo->tdo_nbuckets - 1)];
+      tdo->tdo_entry[index].tde_next = *head;
+      *head = index;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_remove
+ *
+ * Description:
+ *   Remove a directory entry from the hash index before the last entry of
+ *   the directory is moved in its place.  The index is dropped when the
+ *   directory has shrunk well below the threshold.
+ *
+ ****************************************************************************/
+
+static void tmpfs_hash_remove(FAR struct tmpfs_directory_s *tdo,
+                              unsigned int index)
+{
+  unsigned int last = tdo->tdo_nentries - 1;
+
+  if (tdo->tdo_hash == NULL)
+    {
+      return;
+    }
+
+  if (last < TMPFS_DIRECTORY_HASH / 2)
+    {
+      fs_heap_free(tdo->tdo_hash);
+      tdo->tdo_hash     = NULL;
+      tdo->tdo_nbuckets = 0;
+      return;
+    }
+
+  *tmpfs_hash_link(tdo, index) = tdo->tdo_entry[index].tde_next;
+  if (index != last)
+    {
+      *tmpfs_hash_link(tdo, last) = index;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: tmpfs_find_dirent
  ****************************************************************************/
@@ -437,6 +897,24 @@ static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
         }
     }
 
+#ifdef TMPFS_DIRECTORY_HASH
+  /* Search the hash chain of the name if the directory is hashed */
+
+  if (tdo->tdo_hash != NULL)
+    {
+      uint32_t hash = tmpfs_hash_name(name, len);
+
+      for (i = tdo->tdo_hash[hash & (tdo->tdo_nbuckets - 1)];
+           i != TMPFS_HASH_NONE &&
+           (tdo->tdo_entry[i].tde_hash != hash ||
+            strncmp(tdo->tdo_entry[i].tde_name, name, len) != 0 ||
+            tdo->tdo_entry[i].tde_name[len] != 0);
+           i = tdo->tdo_entry[i].tde_next);
+
+      return i != TMPFS_HASH_NONE ? i : -ENOENT;
+    }
+#endif
+
   /* Search the list of directory entries for a match */
 
   for (i = 0;
@@ -475,6 +953,10 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
       fs_heap_free(tdo->tdo_entry[index].tde_name);
     }
 
+#ifdef TMPFS_DIRECTORY_HASH
+  tmpfs_hash_remove(tdo, index);
+#endif
+
   /* Remove by replacing this entry with the final directory entry */
 
   last = tdo->tdo_nentries - 1;
@@ -548,6 +1030,11 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
   tde->tde_object = to;
   tde->tde_name   = newname;
 
+#ifdef TMPFS_DIRECTORY_HASH
+  tde->tde_hash   = tmpfs_hash_name(newname, namelen);
+  tmpfs_hash_add(tdo, index);
+#endif
+
   return OK;
 }
 
@@ -579,6 +1066,12 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
   tfo->tfo_data   = NULL;
+  tfo->tfo_pins   = 0;
+#ifdef TMPFS_PAGESIZE
+  tfo->tfo_npages   = 0;
+  tfo->tfo_maxpages = 0;
+  tfo->tfo_pages    = NULL;
+#endif
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -728,6 +1221,10 @@ tmpfs_alloc_directory(FAR struct tmpfs_directory_s *parent)
   tdo->tdo_parent   = parent;
   tdo->tdo_nentries = 0;
   tdo->tdo_entry    = NULL;
+#ifdef TMPFS_DIRECTORY_HASH
+  tdo->tdo_nbuckets = 0;
+  tdo->tdo_hash     = NULL;
+#endif
 
   nxrmutex_init(&tdo->tdo_lock);
 
@@ -1220,6 +1717,10 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
       fs_heap_free(tdo->tdo_entry[index].tde_name);
     }
 
+#ifdef TMPFS_DIRECTORY_HASH
+  tmpfs_hash_remove(tdo, index);
+#endif
+
   /* Remove by replacing this entry with the final directory entry */
 
   tde  = &tdo->tdo_entry[index];
@@ -1253,13 +1754,16 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_filedata(tfo);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
       tdo = (FAR struct tmpfs_directory_s *)to;
 
       fs_heap_free(tdo->tdo_entry);
+#ifdef TMPFS_DIRECTORY_HASH
+      fs_heap_free(tdo->tdo_hash);
+#endif
     }
 
   /* Free the object now */
@@ -1576,7 +2080,7 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   if (tfo->tfo_data != NULL)
     {
-      memcpy(buffer, &tfo->tfo_data[startpos], nread);
+      tmpfs_read_data(tfo, startpos, buffer, nread);
       filep->f_pos += nread;
     }
   else
@@ -1601,6 +2105,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+  size_t oldsize;
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1632,6 +2137,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   nwritten = buflen;
   endpos   = startpos + buflen;
+  oldsize  = tfo->tfo_size;
 
   if (endpos > tfo->tfo_size)
     {
@@ -1642,13 +2148,20 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
         {
           goto errout_with_lock;
         }
+
+      /* Zero the gap if the write starts past the end of the file */
+
+      if (startpos > oldsize)
+        {
+          tmpfs_write_data(tfo, oldsize, NULL, startpos - oldsize);
+        }
     }
 
   /* Copy data from the memory object to the user buffer */
 
   if (tfo->tfo_data != NULL)
     {
-      memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
+      tmpfs_write_data(tfo, startpos, buffer, nwritten);
     }
   else
     {
@@ -1763,6 +2276,8 @@ static int tmpfs_unmap(FAR struct task_group_s *group,
 static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 {
   FAR struct tmpfs_file_s *tfo;
+  FAR uint8_t *addr;
+  size_t avail;
   int ret = -EINVAL;
 
   DEBUGASSERT(filep->f_priv != NULL);
@@ -1776,7 +2291,17 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
-      map->vaddr = tfo->tfo_data + map->offset;
+      /* Map the file memory directly if the range is contiguous, a range
+       * across pages is copied by the caller instead.
+       */
+
+      addr = tmpfs_file_addr(tfo, map->offset, &avail);
+      if (map->length > avail)
+        {
+          return -ENOTTY;
+        }
+
+      map->vaddr = addr;
       map->priv.p = tfo;
       map->munmap = tmpfs_unmap;
       ret = mm_map_add(get_current_mm(), map);
@@ -1830,9 +2355,50 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     {
       FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
 
+#ifdef TMPFS_PAGESIZE
+      /* The data of the file is not contiguous */
+
+      if (tfo->tfo_pages != NULL)
+        {
+          return -ENOTTY;
+        }
+#endif
+
       *ptr = (uintptr_t)tfo->tfo_data;
       return OK;
     }
+  else if (cmd == FIOC_XIPPIN || cmd == FIOC_XIPUNPIN)
+    {
+      ret = tmpfs_lock_file(tfo);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (cmd == FIOC_XIPUNPIN)
+        {
+          DEBUGASSERT(tfo->tfo_pins > 0);
+          tfo->tfo_pins--;
+        }
+#ifdef TMPFS_PAGESIZE
+      else if (tfo->tfo_pages != NULL)
+        {
+          /* The data of the file is not contiguous */
+
+          ret = -ENOTTY;
+        }
+#endif
+      else if (tfo->tfo_pins == UINT16_MAX)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          tfo->tfo_pins++;
+        }
+
+      tmpfs_unlock_file(tfo);
+    }
 
   return ret;
 }
@@ -1970,7 +2536,7 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
 
       if (length > oldsize)
         {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
+          tmpfs_write_data(tfo, oldsize, NULL, length - oldsize);
         }
 
       ret = OK;
@@ -2248,6 +2814,9 @@ static int tmpfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   nxrmutex_destroy(&tdo->tdo_lock);
   fs_heap_free(tdo->tdo_entry);
+#ifdef TMPFS_DIRECTORY_HASH
+  fs_heap_free(tdo->tdo_hash);
+#endif
   fs_heap_free(tdo);
 
   nxrmutex_destroy(&fs->tfs_lock);
@@ -2414,7 +2983,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_filedata(tfo);
       fs_heap_free(tfo);
     }
 
@@ -2557,6 +3126,9 @@ static int tmpfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   nxrmutex_destroy(&tdo->tdo_lock);
   fs_heap_free(tdo->tdo_entry);
+#ifdef TMPFS_DIRECTORY_HASH
+  fs_heap_free(tdo->tdo_hash);
+#endif
   fs_heap_free(tdo);
 
   /* Release the reference and lock on the parent directory */
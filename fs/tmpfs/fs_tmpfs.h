@@ -40,6 +40,20 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* Files larger than one page are kept in pages of this size */
+
+#if defined(CONFIG_FS_TMPFS_PAGESIZE) && CONFIG_FS_TMPFS_PAGESIZE > 0
+#  define TMPFS_PAGESIZE CONFIG_FS_TMPFS_PAGESIZE
+#endif
+
+/* Directories with more entries than this get a hash index of the names */
+
+#if defined(CONFIG_FS_TMPFS_DIRECTORY_HASH) && \
+    CONFIG_FS_TMPFS_DIRECTORY_HASH > 0
+#  define TMPFS_DIRECTORY_HASH CONFIG_FS_TMPFS_DIRECTORY_HASH
+#  define TMPFS_HASH_NONE      0xffff /* End of a hash chain */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -68,6 +82,10 @@ struct tmpfs_dirent_s
 {
   FAR struct tmpfs_object_s *tde_object;
   FAR char *tde_name;
+#ifdef TMPFS_DIRECTORY_HASH
+  uint32_t tde_hash;     /* Hash of the name */
+  uint16_t tde_next;     /* Next entry in the same hash bucket */
+#endif
 };
 
 /* The generic form of a TMPFS memory object */
@@ -99,11 +117,23 @@ struct tmpfs_directory_s
 
   uint16_t tdo_nentries; /* Number of directory entries */
   FAR struct tmpfs_dirent_s *tdo_entry;
+#ifdef TMPFS_DIRECTORY_HASH
+  uint16_t tdo_nbuckets; /* Number of hash buckets, zero if not hashed */
+
+  /* First entry of each hash bucket */
+
+  FAR uint16_t *tdo_hash;
+#endif
 };
 
 #define SIZEOF_TMPFS_DIRECTORY(n) ((n) * sizeof(struct tmpfs_dirent_s))
 
 /* The form of a regular file memory object
+ *
+ * The data of a file is kept in one buffer, tfo_data.  With
+ * TMPFS_PAGESIZE, a file that outgrows one page is kept in a table of
+ * pages instead, tfo_data then being the first one.  The pages don't move
+ * as the file grows.
  *
  * NOTE that in this very simplified implementation, there is no per-open
  * state.  The file memory object also serves as the open file object,
@@ -127,6 +157,12 @@ struct tmpfs_file_s
   uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
   size_t        tfo_size;  /* Valid file size */
   FAR uint8_t  *tfo_data;  /* File data starts here */
+  uint16_t      tfo_pins;  /* Users of tfo_data in place, see FIOC_XIPPIN */
+#ifdef TMPFS_PAGESIZE
+  size_t        tfo_npages;   /* Number of pages in tfo_pages */
+  size_t        tfo_maxpages; /* Allocated size of tfo_pages */
+  FAR uint8_t **tfo_pages;    /* Page table, NULL if tfo_data is all */
+#endif
 };
 
 /* This structure represents one instance of a TMPFS file system */
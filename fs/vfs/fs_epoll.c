@@ -40,6 +40,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 #include "fs_heap.h"
@@ -50,9 +51,10 @@
 
 struct epoll_node_s
 {
-  struct list_node         node;
+  struct list_node         node;  /* Entry of the setup/oneshot/free list */
+  struct list_node         rnode; /* Entry of the ready list */
   epoll_data_t             data;
-  bool                     notified;
+  bool                     ready; /* The node is queued on the ready list */
   struct pollfd            pfd;
   FAR struct epoll_head_s *eph;
 };
@@ -65,13 +67,17 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
-  struct list_node      setup;    /* The setup list, store all the setuped
-                                   * epoll node.
+  spinlock_t            rlock;    /* Protect the ready list, the poll
+                                   * callback may run in interrupt context.
+                                   */
+  struct list_node      ready;    /* The ready list, the poll callback queue
+                                   * the notified epoll node here, so
+                                   * epoll_wait() only visits the ready fd
+                                   * instead of all the registered fd.
                                    */
-  struct list_node      teardown; /* The teardown list, store all the epoll
-                                   * node notified after epoll_wait finish,
-                                   * these epoll node should be setup again
-                                   * to check the pending poll notification.
+  struct list_node      setup;    /* The setup list, store all the setuped
+                                   * epoll node, these nodes keep armed
+                                   * between epoll_wait() calls.
                                    */
   struct list_node      oneshot;  /* The oneshot list, store all the epoll
                                    * node notified after epoll_wait and with
@@ -98,9 +104,10 @@ static int epoll_do_open(FAR struct file *filep);
 static int epoll_do_close(FAR struct file *filep);
 static int epoll_do_poll(FAR struct file *filep,
                          FAR struct pollfd *fds, bool setup);
-static int epoll_setup(FAR epoll_head_t *eph);
-static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
-                          int maxevents);
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn);
+static void epoll_rearm(FAR epoll_head_t *eph, FAR epoll_node_t *epn);
+static int epoll_collect(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                         int maxevents);
 
 /****************************************************************************
  * Private Data
@@ -235,13 +242,14 @@ static int epoll_do_create(int size, int flags)
   eph->size = size;
   nxmutex_init(&eph->lock);
   nxsem_init(&eph->sem, 0, 0);
+  spin_initialize(&eph->rlock, SP_UNLOCKED);
 
   /* List initialize */
 
   epn = (FAR epoll_node_t *)(eph + 1);
 
+  list_initialize(&eph->ready);
   list_initialize(&eph->setup);
-  list_initialize(&eph->teardown);
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
@@ -267,61 +275,107 @@ static int epoll_do_create(int size, int flags)
 }
 
 /****************************************************************************
- * Name: epoll_setup
+ * Name: epoll_wakeup
  *
  * Description:
- *   Setup all the fd.
+ *   Wake up the epoll_wait() waiter if it isn't posted yet.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
  *
  * Returned Value:
- *   Positive on success, negative on fail
+ *   None
  *
  ****************************************************************************/
 
-static int epoll_setup(FAR epoll_head_t *eph)
+static void epoll_wakeup(FAR epoll_head_t *eph)
 {
-  FAR epoll_node_t *tepn;
-  FAR epoll_node_t *epn;
-  int ret;
+  int semcount = 0;
 
-  ret = nxmutex_lock(&eph->lock);
-  if (ret < 0)
+  nxsem_get_value(&eph->sem, &semcount);
+  if (semcount < 1)
     {
-      return ret;
+      nxsem_post(&eph->sem);
     }
+}
 
-  list_for_every_entry_safe(&eph->teardown, epn, tepn, epoll_node_t, node)
+/****************************************************************************
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Remove the epoll node from the ready list and discard the pending
+ *   events, the caller should hold eph->lock and the node should not be
+ *   armed any more.
+ *
+ * Input Parameters:
+ *   eph       - The epoll head pointer
+ *   epn       - The epoll node
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (epn->ready)
     {
-      /* Setup again to check the notified pollfd last epoll_wait() to
-       * cover the situation several poll event pending on one fd.
-       */
+      list_delete(&epn->rnode);
+      epn->ready = false;
+    }
 
-      epn->notified    = false;
-      epn->pfd.revents = 0;
-      ret = poll_fdsetup(epn->pfd.fd, &epn->pfd, true);
-      if (ret < 0)
-        {
-          ferr("epoll setup failed, fd=%d, events=%08" PRIx32 ", ret=%d\n",
-               epn->pfd.fd, epn->pfd.events, ret);
-          break;
-        }
+  epn->pfd.revents = 0;
+  spin_unlock_irqrestore(&eph->rlock, flags);
+}
+
+/****************************************************************************
+ * Name: epoll_rearm
+ *
+ * Description:
+ *   Teardown and setup the level triggered fd again, the driver will notify
+ *   the fd again in the setup step if the event is still pending, so the
+ *   node is queued to the ready list for the next epoll_wait().
+ *
+ * Input Parameters:
+ *   eph       - The epoll head pointer
+ *   epn       - The epoll node
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void epoll_rearm(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  int ret;
+
+  poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+  epoll_unready(eph, epn);
+
+  ret = poll_fdsetup(epn->pfd.fd, &epn->pfd, true);
+  if (ret < 0)
+    {
+      ferr("epoll setup failed, fd=%d, events=%08" PRIx32 ", ret=%d\n",
+           epn->pfd.fd, epn->pfd.events, ret);
+
+      /* Park the node on the oneshot list until epoll_ctl() rearm it */
 
       list_delete(&epn->node);
-      list_add_tail(&eph->setup, &epn->node);
+      list_add_tail(&eph->oneshot, &epn->node);
     }
-
-  nxmutex_unlock(&eph->lock);
-  return ret;
 }
 
 /****************************************************************************
- * Name: epoll_teardown
+ * Name: epoll_collect
  *
  * Description:
- *   Teardown all the notifed fd and check the notified fd's event with user
- *   expected event.
+ *   Consume the ready list and report the notified fd's event. Only the
+ *   ready fd are visited, all the other fd keep armed. The level triggered
+ *   fd are armed again to check whether the event is still pending, the
+ *   EPOLLONESHOT fd are disarmed and the EPOLLET fd are left untouched.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -330,52 +384,86 @@ static int epoll_setup(FAR epoll_head_t *eph)
  *
  * Returned Value:
  *   Return the number of fd that notifed and the events is also user
- *   expected.
+ *   expected, negative on fail.
  *
  ****************************************************************************/
 
-static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
-                          int maxevents)
+static int epoll_collect(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
+                         int maxevents)
 {
   FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  struct list_node rearm;
+  pollevent_t revents;
+  irqstate_t flags;
+  bool pending;
+  int ret;
   int i = 0;
 
-  nxmutex_lock(&eph->lock);
+  ret = nxmutex_lock(&eph->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  list_initialize(&rearm);
+  flags = spin_lock_irqsave(&eph->rlock);
+
+  while (i < maxevents && !list_is_empty(&eph->ready))
     {
-      /* Only check the notifed fd */
+      epn = container_of(list_remove_head(&eph->ready), epoll_node_t, rnode);
+      epn->ready       = false;
+      revents          = epn->pfd.revents;
+      epn->pfd.revents = 0;
 
-      if (!epn->notified)
+      if (revents == 0)
         {
           continue;
         }
 
-      /* Teradown all the notified fd */
+      evs[i].data     = epn->data;
+      evs[i++].events = revents;
 
-      poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
-      list_delete(&epn->node);
+      /* The poll callback never touch epn->node, so it is safe to move the
+       * node which need rearm to the local list with eph->lock held.
+       */
+
+      if ((epn->pfd.events & EPOLLET) == 0 ||
+          (epn->pfd.events & EPOLLONESHOT) != 0)
+        {
+          list_delete(&epn->node);
+          list_add_tail(&rearm, &epn->node);
+        }
+    }
+
+  pending = !list_is_empty(&eph->ready);
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
+  /* Handle the rearm outside the spinlock since poll_fdsetup() may sleep */
 
-      if (epn->pfd.revents != 0 && i < maxevents)
+  list_for_every_entry_safe(&rearm, epn, tepn, epoll_node_t, node)
+    {
+      list_delete(&epn->node);
+      if ((epn->pfd.events & EPOLLONESHOT) != 0)
         {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
-            {
-              list_add_tail(&eph->oneshot, &epn->node);
-            }
-          else
-            {
-              list_add_tail(&eph->teardown, &epn->node);
-            }
+          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+          epoll_unready(eph, epn);
+          list_add_tail(&eph->oneshot, &epn->node);
         }
       else
         {
-          list_add_tail(&eph->teardown, &epn->node);
+          list_add_tail(&eph->setup, &epn->node);
+          epoll_rearm(eph, epn);
         }
     }
 
+  /* More events than maxevents are pending, let the next call go */
+
+  if (pending)
+    {
+      epoll_wakeup(eph);
+    }
+
   nxmutex_unlock(&eph->lock);
   return i;
 }
@@ -385,7 +473,8 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
  *
  * Description:
  *   The default epoll callback function, this function do the final step of
- *   poll notification.
+ *   poll notification: queue the epoll node to the ready list and wake up
+ *   the waiter.
  *
  * Input Parameters:
  *   fds - The fds
@@ -398,16 +487,28 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
-  int semcount = 0;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
+  bool wakeup = false;
 
-  epn->notified = true;
-  if (fds->revents != 0)
+  if (fds->revents == 0)
     {
-      nxsem_get_value(&epn->eph->sem, &semcount);
-      if (semcount < 1)
-        {
-          nxsem_post(&epn->eph->sem);
-        }
+      return;
+    }
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (!epn->ready)
+    {
+      epn->ready = true;
+      list_add_tail(&eph->ready, &epn->rnode);
+      wakeup = true;
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
+  if (wakeup)
+    {
+      epoll_wakeup(eph);
     }
 }
 
@@ -511,15 +612,6 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
               }
           }
 
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
         list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
           {
             if (epn->pfd.fd == fd)
@@ -556,7 +648,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         epn = container_of(list_remove_head(&eph->free), epoll_node_t, node);
         epn->eph         = eph;
         epn->data        = ev->data;
-        epn->notified    = false;
+        epn->ready       = false;
         epn->pfd.events  = ev->events | POLLALWAYS;
         epn->pfd.fd      = fd;
         epn->pfd.arg     = epn;
@@ -566,6 +658,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         ret = poll_fdsetup(fd, &epn->pfd, true);
         if (ret < 0)
           {
+            epoll_unready(eph, epn);
             list_add_tail(&eph->free, &epn->node);
             goto err;
           }
@@ -580,16 +673,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             if (epn->pfd.fd == fd)
               {
                 poll_fdsetup(fd, &epn->pfd, false);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
+                epoll_unready(eph, epn);
                 list_delete(&epn->node);
                 list_add_tail(&eph->free, &epn->node);
                 goto out;
@@ -614,47 +698,22 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
           {
             if (epn->pfd.fd == fd)
               {
+                epn->data = ev->data;
                 if (epn->pfd.events != (ev->events | POLLALWAYS))
                   {
                     poll_fdsetup(fd, &epn->pfd, false);
+                    epoll_unready(eph, epn);
 
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.fd      = fd;
-                    epn->pfd.revents = 0;
-
-                    ret = poll_fdsetup(fd, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-                  }
-
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    epn->notified    = false;
-                    epn->data        = ev->data;
                     epn->pfd.events  = ev->events | POLLALWAYS;
                     epn->pfd.fd      = fd;
-                    epn->pfd.revents = 0;
 
                     ret = poll_fdsetup(fd, &epn->pfd, true);
                     if (ret < 0)
                       {
+                        list_delete(&epn->node);
+                        list_add_tail(&eph->oneshot, &epn->node);
                         goto err;
                       }
-
-                    list_delete(&epn->node);
-                    list_add_tail(&eph->setup, &epn->node);
                   }
 
                 goto out;
@@ -665,7 +724,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
           {
             if (epn->pfd.fd == fd)
               {
-                epn->notified    = false;
+                epn->ready       = false;
                 epn->data        = ev->data;
                 epn->pfd.events  = ev->events | POLLALWAYS;
                 epn->pfd.fd      = fd;
@@ -721,13 +780,8 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
     }
 
 retry:
-  ret = epoll_setup(eph);
-  if (ret < 0)
-    {
-      goto err;
-    }
 
-  /* Wait the poll ready */
+  /* Wait the poll ready, the armed fd queue itself to the ready list */
 
   nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
 
@@ -751,8 +805,13 @@ retry:
     }
   else /* ret >= 0 or ret == -ETIMEDOUT */
     {
-      int num = epoll_teardown(eph, evs, maxevents);
-      if (num == 0 && ret >= 0)
+      int num = epoll_collect(eph, evs, maxevents);
+      if (num < 0)
+        {
+          ret = num;
+          goto err;
+        }
+      else if (num == 0 && ret >= 0)
         {
           goto retry;
         }
@@ -796,13 +855,8 @@ int epoll_wait(int epfd, FAR struct epoll_event *evs,
     }
 
 retry:
-  ret = epoll_setup(eph);
-  if (ret < 0)
-    {
-      goto err;
-    }
 
-  /* Wait the poll ready */
+  /* Wait the poll ready, the armed fd queue itself to the ready list */
 
   if (timeout == 0)
     {
@@ -823,8 +877,13 @@ retry:
     }
   else /* ret >= 0 or ret == -ETIMEDOUT */
     {
-      int num = epoll_teardown(eph, evs, maxevents);
-      if (num == 0 && ret >= 0)
+      int num = epoll_collect(eph, evs, maxevents);
+      if (num < 0)
+        {
+          ret = num;
+          goto err;
+        }
+      else if (num == 0 && ret >= 0)
         {
           goto retry;
         }
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/stat.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <debug.h>
@@ -32,6 +33,9 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/net.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "inode/inode.h"
 #include "fs_heap.h"
 
 /****************************************************************************
@@ -231,6 +235,84 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
   return ntransferred;
 }
 
+/****************************************************************************
+ * Name: copyfile_xip
+ *
+ * Description:
+ *   Write the content of a directly addressable file to the outfile, with
+ *   no bounce buffer and no read.
+ *
+ ****************************************************************************/
+
+static ssize_t copyfile_xip(FAR struct file *outfile,
+                            FAR struct file *infile, FAR off_t *offset,
+                            size_t count, FAR const uint8_t *base,
+                            off_t size)
+{
+  ssize_t nbyteswritten;
+  size_t ntransferred = 0;
+  off_t pos;
+
+  if (offset)
+    {
+      pos = *offset;
+    }
+  else
+    {
+      pos = file_seek(infile, 0, SEEK_CUR);
+      if (pos < 0)
+        {
+          return pos;
+        }
+    }
+
+  if (pos >= size)
+    {
+      return 0;
+    }
+
+  if (count > size - pos)
+    {
+      count = size - pos;
+    }
+
+  while (ntransferred < count)
+    {
+      nbyteswritten = file_write(outfile, base + pos + ntransferred,
+                                 count - ntransferred);
+      if (nbyteswritten < 0)
+        {
+          /* EINTR is not an error if some data has been transferred */
+
+          if (nbyteswritten != -EINTR || ntransferred == 0)
+            {
+              return nbyteswritten;
+            }
+
+          break;
+        }
+
+      ntransferred += nbyteswritten;
+    }
+
+  /* Advance the file position, or return the new offset */
+
+  if (offset)
+    {
+      *offset = pos + ntransferred;
+    }
+  else
+    {
+      pos = file_seek(infile, pos + ntransferred, SEEK_SET);
+      if (pos < 0)
+        {
+          return pos;
+        }
+    }
+
+  return ntransferred;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -247,6 +329,9 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count)
 {
+  FAR const uint8_t *base;
+  off_t size;
+
   if (count == 0)
     {
       nwarn("WARNING: sendfile count is zero\n");
@@ -277,13 +362,115 @@ ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
     }
 #endif
 
-  /* No... then this is probably a file-to-file transfer.  The generic
-   * copyfile() can handle that case.
+  /* No... then this is probably a file-to-file transfer.  Write straight
+   * from the file content if the file system keeps it addressable and the
+   * write cannot resize it, otherwise the generic copyfile() can handle
+   * that case.
    */
 
+  if (outfile->f_inode != infile->f_inode &&
+      file_xipbase(infile, &base, &size) >= 0)
+    {
+      ssize_t ret = copyfile_xip(outfile, infile, offset, count, base,
+                                 size);
+
+      file_xiprelease(infile);
+      return ret;
+    }
+
   return copyfile(outfile, infile, offset, count);
 }
 
+/****************************************************************************
+ * Name: file_xipbase
+ *
+ * Description:
+ *   Get the address and the size of the file content if the file system
+ *   keeps it directly addressable.
+ *
+ ****************************************************************************/
+
+int file_xipbase(FAR struct file *filep, FAR const uint8_t **base,
+                 FAR off_t *size)
+{
+  FAR struct inode *inode = filep->f_inode;
+  struct stat buf;
+  uintptr_t xipbase;
+  int ret;
+
+  /* Only the files of a mounted file system know FIOC_XIPBASE, don't
+   * pass it to the drivers.
+   */
+
+  if (inode == NULL || !INODE_IS_MOUNTPT(inode))
+    {
+      return -ENOTTY;
+    }
+
+  /* The content is used after the file system lock is released, across
+   * the waits of a transfer.  Hold the inode, and have a writable file
+   * system pin the content so that a write() or a ftruncate() cannot move
+   * or free it meanwhile.  A file system that cannot pin is not used.
+   */
+
+  inode_addref(inode);
+  if (inode->u.i_mops->write != NULL || inode->u.i_mops->truncate != NULL)
+    {
+      ret = file_ioctl(filep, FIOC_XIPPIN, 0);
+      if (ret < 0)
+        {
+          inode_release(inode);
+          return ret;
+        }
+    }
+
+  ret = file_ioctl(filep, FIOC_XIPBASE, &xipbase);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_fstat(filep, &buf);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!S_ISREG(buf.st_mode) || (xipbase == 0 && buf.st_size > 0))
+    {
+      ret = -ENXIO;
+      goto errout;
+    }
+
+  *base = (FAR const uint8_t *)xipbase;
+  *size = buf.st_size;
+  return OK;
+
+errout:
+  file_xiprelease(filep);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: file_xiprelease
+ *
+ * Description:
+ *   Unpin the content of a file returned by a successful file_xipbase().
+ *
+ ****************************************************************************/
+
+void file_xiprelease(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  if (inode->u.i_mops->write != NULL || inode->u.i_mops->truncate != NULL)
+    {
+      file_ioctl(filep, FIOC_XIPUNPIN, 0);
+    }
+
+  inode_release(inode);
+}
+
 /****************************************************************************
  * Name: sendfile
  *
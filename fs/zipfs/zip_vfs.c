@@ -37,6 +37,15 @@
 
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+#  define ZIPFS_WINSIZE    32768  /* The inflate window of a checkpoint */
+#  define ZIPFS_INBUFSIZE  1024   /* Compressed data read at once */
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -54,11 +63,46 @@ struct zipfs_mountpt_s
   char abspath[1];
 };
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+/* The inflate state at a deflate block boundary */
+
+struct zipfs_point_s
+{
+  off_t out;                /* Uncompressed offset */
+  off_t in;                 /* Compressed offset of the next full byte */
+  uint8_t bits;             /* Bits of the previous byte not consumed yet */
+  uInt wlen;                /* Length of the window */
+  FAR Bytef *window;        /* The last uncompressed data */
+};
+
+/* The entry read directly from the archive */
+
+struct zipfs_index_s
+{
+  struct file raw;          /* The archive */
+  z_stream strm;            /* Inflate state, if the entry is deflated */
+  off_t base;               /* Offset of the entry data in the archive */
+  off_t csize;              /* Compressed size of the entry */
+  off_t usize;              /* Uncompressed size of the entry */
+  off_t in;                 /* Compressed data read into inbuf */
+  off_t out;                /* Current uncompressed offset */
+  off_t span;               /* Distance between the checkpoints */
+  bool stored;              /* The entry is not compressed */
+  bool end;                 /* The end of the stream was reached */
+  int npoints;
+  struct zipfs_point_s points[CONFIG_ZIPFS_SEEK_INDEX_POINTS];
+  Bytef inbuf[ZIPFS_INBUFSIZE];
+};
+#endif
+
 struct zipfs_file_s
 {
   unzFile uf;
   mutex_t lock;
   FAR char *seekbuf;
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  FAR struct zipfs_index_s *index;
+#endif
   char relpath[1];
 };
 
@@ -239,6 +283,365 @@ static int zipfs_convert_result(int ziperr)
     }
 }
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+static int zipfs_index_result(int zerr)
+{
+  switch (zerr)
+    {
+      case Z_OK:
+      case Z_STREAM_END:
+        return OK;
+      case Z_MEM_ERROR:
+        return -ENOMEM;
+      default:
+        return -EIO;
+    }
+}
+
+static int zipfs_index_open(FAR struct zipfs_mountpt_s *fs,
+                            FAR struct zipfs_file_s *fp)
+{
+  FAR struct zipfs_index_s *idx;
+  unz_file_info64 file_info;
+  int ret;
+
+  ret = unzGetCurrentFileInfo64(fp->uf, &file_info,
+                                NULL, 0, NULL, 0, NULL, 0);
+  ret = zipfs_convert_result(ret);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Encrypted entries and other methods are left to minizip */
+
+  if ((file_info.flag & 1) != 0 ||
+      (file_info.compression_method != 0 &&
+       file_info.compression_method != Z_DEFLATED))
+    {
+      return OK;
+    }
+
+  idx = fs_heap_zalloc(sizeof(*idx));
+  if (idx == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = file_open(&idx->raw, fs->abspath, O_RDONLY);
+  if (ret < 0)
+    {
+      goto err_with_idx;
+    }
+
+  idx->base   = unzGetCurrentFileZStreamPos64(fp->uf);
+  idx->csize  = file_info.compressed_size;
+  idx->usize  = file_info.uncompressed_size;
+  idx->span   = CONFIG_ZIPFS_SEEK_INDEX_SPAN * 1024;
+  idx->stored = file_info.compression_method == 0;
+
+  if (!idx->stored)
+    {
+      ret = zipfs_index_result(inflateInit2(&idx->strm, -MAX_WBITS));
+      if (ret < 0)
+        {
+          goto err_with_raw;
+        }
+    }
+
+  /* The entry is read directly from now on */
+
+  unzCloseCurrentFile(fp->uf);
+  fp->index = idx;
+  return OK;
+
+err_with_raw:
+  file_close(&idx->raw);
+err_with_idx:
+  fs_heap_free(idx);
+  return ret;
+}
+
+static void zipfs_index_close(FAR struct zipfs_index_s *idx)
+{
+  int i;
+
+  for (i = 0; i < idx->npoints; i++)
+    {
+      fs_heap_free(idx->points[i].window);
+    }
+
+  if (!idx->stored)
+    {
+      inflateEnd(&idx->strm);
+    }
+
+  file_close(&idx->raw);
+  fs_heap_free(idx);
+}
+
+/* Read the next compressed data of the entry */
+
+static int zipfs_index_fill(FAR struct zipfs_index_s *idx)
+{
+  ssize_t nread;
+  off_t remain;
+
+  remain = idx->csize - idx->in;
+  if (remain > ZIPFS_INBUFSIZE)
+    {
+      remain = ZIPFS_INBUFSIZE;
+    }
+  else if (remain <= 0)
+    {
+      return -EIO;
+    }
+
+  nread = file_pread(&idx->raw, idx->inbuf, remain, idx->base + idx->in);
+  if (nread <= 0)
+    {
+      return nread < 0 ? nread : -EIO;
+    }
+
+  idx->strm.next_in  = idx->inbuf;
+  idx->strm.avail_in = nread;
+  idx->in           += nread;
+  return OK;
+}
+
+/* Record a checkpoint at the block boundary the stream stopped at.  When
+ * the table is full, every other checkpoint is dropped and the span
+ * doubles.  Failing to allocate a window only loses the checkpoint.
+ */
+
+static void zipfs_index_addpoint(FAR struct zipfs_index_s *idx)
+{
+  FAR struct zipfs_point_s *point;
+  off_t last;
+  int i;
+
+  last = idx->npoints > 0 ? idx->points[idx->npoints - 1].out : 0;
+  if (idx->out - last < idx->span)
+    {
+      return;
+    }
+
+  if (idx->npoints == CONFIG_ZIPFS_SEEK_INDEX_POINTS)
+    {
+      for (i = 0; i < idx->npoints; i++)
+        {
+          if ((i & 1) == 0)
+            {
+              fs_heap_free(idx->points[i].window);
+            }
+          else
+            {
+              idx->points[i / 2] = idx->points[i];
+            }
+        }
+
+      idx->npoints /= 2;
+      idx->span    *= 2;
+      return;
+    }
+
+  point = &idx->points[idx->npoints];
+  point->window = fs_heap_malloc(ZIPFS_WINSIZE);
+  if (point->window == NULL)
+    {
+      return;
+    }
+
+  point->wlen = ZIPFS_WINSIZE;
+  inflateGetDictionary(&idx->strm, point->window, &point->wlen);
+  point->out  = idx->out;
+  point->in   = idx->in - idx->strm.avail_in;
+  point->bits = idx->strm.data_type & 7;
+  idx->npoints++;
+}
+
+/* Restart the stream from a checkpoint, or from the start of the entry if
+ * point is NULL.
+ */
+
+static int zipfs_index_restore(FAR struct zipfs_index_s *idx,
+                               FAR struct zipfs_point_s *point)
+{
+  int ret;
+
+  inflateReset(&idx->strm);
+  idx->strm.avail_in = 0;
+  idx->end = false;
+
+  if (point == NULL)
+    {
+      idx->in  = 0;
+      idx->out = 0;
+      return OK;
+    }
+
+  idx->in  = point->bits ? point->in - 1 : point->in;
+  idx->out = point->out;
+
+  if (point->bits)
+    {
+      ret = zipfs_index_fill(idx);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = inflatePrime(&idx->strm, point->bits,
+                         *idx->strm.next_in >> (8 - point->bits));
+      idx->strm.next_in++;
+      idx->strm.avail_in--;
+      if (ret != Z_OK)
+        {
+          return zipfs_index_result(ret);
+        }
+    }
+
+  return zipfs_index_result(inflateSetDictionary(&idx->strm, point->window,
+                                                 point->wlen));
+}
+
+static ssize_t zipfs_index_read(FAR struct zipfs_index_s *idx,
+                                FAR void *buffer, size_t buflen)
+{
+  ssize_t ret;
+  uInt avail;
+
+  if (idx->stored)
+    {
+      if (idx->out >= idx->usize)
+        {
+          return 0;
+        }
+      else if (buflen > idx->usize - idx->out)
+        {
+          buflen = idx->usize - idx->out;
+        }
+
+      ret = file_pread(&idx->raw, buffer, buflen, idx->base + idx->out);
+      if (ret > 0)
+        {
+          idx->out += ret;
+        }
+
+      return ret;
+    }
+
+  idx->strm.next_out  = buffer;
+  idx->strm.avail_out = buflen;
+
+  while (idx->strm.avail_out > 0 && !idx->end)
+    {
+      /* The last bytes may still be in the bit buffer of the stream */
+
+      if (idx->strm.avail_in == 0 && idx->in < idx->csize)
+        {
+          ret = zipfs_index_fill(idx);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      /* Stop at each block boundary to record the checkpoints */
+
+      avail     = idx->strm.avail_out;
+      ret       = inflate(&idx->strm, Z_BLOCK);
+      idx->out += avail - idx->strm.avail_out;
+
+      if (ret == Z_STREAM_END)
+        {
+          idx->end = true;
+        }
+      else if (ret != Z_OK)
+        {
+          return zipfs_index_result(ret);
+        }
+      else if ((idx->strm.data_type & 128) != 0 &&
+               (idx->strm.data_type & 64) == 0)
+        {
+          zipfs_index_addpoint(idx);
+        }
+    }
+
+  return buflen - idx->strm.avail_out;
+}
+
+static off_t zipfs_index_seek(FAR struct zipfs_file_s *fp, off_t offset)
+{
+  FAR struct zipfs_index_s *idx = fp->index;
+  FAR struct zipfs_point_s *point = NULL;
+  ssize_t nread;
+  int ret;
+  int i;
+
+  if (offset < 0)
+    {
+      return -EINVAL;
+    }
+
+  if (idx->stored)
+    {
+      idx->out = offset < idx->usize ? offset : idx->usize;
+      return idx->out;
+    }
+
+  /* Restart from the nearest checkpoint before the offset, unless it is
+   * behind the current position.
+   */
+
+  for (i = 0; i < idx->npoints && idx->points[i].out <= offset; i++)
+    {
+      point = &idx->points[i];
+    }
+
+  if (offset < idx->out ||
+      (point != NULL && point->out > idx->out))
+    {
+      ret = zipfs_index_restore(idx, point);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (idx->out < offset && fp->seekbuf == NULL)
+    {
+      fp->seekbuf = fs_heap_malloc(CONFIG_ZIPFS_SEEK_BUFSIZE);
+      if (fp->seekbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  while (idx->out < offset)
+    {
+      off_t remain = offset - idx->out;
+
+      if (remain > CONFIG_ZIPFS_SEEK_BUFSIZE)
+        {
+          remain = CONFIG_ZIPFS_SEEK_BUFSIZE;
+        }
+
+      nread = zipfs_index_read(idx, fp->seekbuf, remain);
+      if (nread < 0)
+        {
+          return nread;
+        }
+      else if (nread == 0)
+        {
+          break;
+        }
+    }
+
+  return idx->out;
+}
+#endif
+
 static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
                       int oflags, mode_t mode)
 {
@@ -279,6 +682,15 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
       goto err_with_zip;
     }
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  fp->index = NULL;
+  ret = zipfs_index_open(fs, fp);
+  if (ret < 0)
+    {
+      goto err_with_zip;
+    }
+#endif
+
   if (ret == OK)
     {
       fp->seekbuf = NULL;
@@ -303,6 +715,13 @@ static int zipfs_close(FAR struct file *filep)
   FAR struct zipfs_file_s *fp = filep->f_priv;
   int ret;
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  if (fp->index != NULL)
+    {
+      zipfs_index_close(fp->index);
+    }
+#endif
+
   ret = zipfs_convert_result(unzClose(fp->uf));
   nxmutex_destroy(&fp->lock);
   fs_heap_free(fp->seekbuf);
@@ -317,7 +736,18 @@ static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t ret;
 
   nxmutex_lock(&fp->lock);
-  ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer, buflen));
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  if (fp->index != NULL)
+    {
+      ret = zipfs_index_read(fp->index, buffer, buflen);
+    }
+  else
+#endif
+    {
+      ret = unzReadCurrentFile(fp->uf, buffer, buflen);
+      ret = zipfs_convert_result(ret);
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -394,6 +824,19 @@ static off_t zipfs_seek(FAR struct file *filep, off_t offset,
         goto err_with_lock;
     }
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  if (fp->index != NULL)
+    {
+      ret = zipfs_index_seek(fp, offset);
+      if (ret >= 0)
+        {
+          filep->f_pos = ret;
+        }
+
+      goto err_with_lock;
+    }
+#endif
+
   if (filep->f_pos == offset)
     {
       goto err_with_lock;
@@ -27,6 +27,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/types.h>
 #include <stdint.h>
 
@@ -70,6 +72,28 @@ uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val);
 
 uint32_t crc32(FAR const uint8_t *src, size_t len);
 
+/****************************************************************************
+ * Name: up_crc32part
+ *
+ * Description:
+ *   Architecture specific crc32part() for the leading part of the buffer.
+ *   crc32part() finishes the remaining bytes with the tables.
+ *
+ * Input Parameters:
+ *   src      - The buffer
+ *   len      - The length of the buffer in bytes
+ *   crc32val - The CRC to continue, updated on return
+ *
+ * Returned Value:
+ *   The number of bytes taken, which may be zero for a short buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_ARCH_CRC32
+size_t up_crc32part(FAR const uint8_t *src, size_t len,
+                    FAR uint32_t *crc32val);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
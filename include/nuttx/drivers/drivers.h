@@ -32,6 +32,21 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Statistics of the sector cache of a BCH device, see DIOC_CACHESTATS */
+
+struct bch_cachestats_s
+{
+  uint32_t nhits;          /* Sector accesses served by the cache */
+  uint32_t nmisses;        /* Sector accesses which read the media */
+  uint32_t nreadahead;     /* Sectors read ahead of a sequential access */
+  uint32_t nwriteback;     /* Dirty sectors written back to the media */
+  uint32_t nwrites;        /* Media write requests issued by write-back */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -221,4 +221,86 @@ struct ethtool_cmd
   uint32_t reserved[2];
 };
 
+/* struct ethtool_coalesce - coalescing parameters for IRQs and stats updates
+ * cmd: ETHTOOL_{G,S}COALESCE
+ * rx_coalesce_usecs: How many usecs to delay an RX interrupt after
+ *  a packet arrives.
+ * rx_max_coalesced_frames: Maximum number of packets to receive
+ *  before an RX interrupt.
+ * rx_coalesce_usecs_irq: Same as rx_coalesce_usecs, except that
+ *  this value applies while an IRQ is being serviced by the host.
+ * rx_max_coalesced_frames_irq: Same as rx_max_coalesced_frames,
+ *  except that this value applies while an IRQ is being serviced
+ *  by the host.
+ * tx_coalesce_usecs: How many usecs to delay a TX interrupt after
+ *  a packet is sent.
+ * tx_max_coalesced_frames: Maximum number of packets to be sent
+ *  before a TX interrupt.
+ * tx_coalesce_usecs_irq: Same as tx_coalesce_usecs, except that
+ *  this value applies while an IRQ is being serviced by the host.
+ * tx_max_coalesced_frames_irq: Same as tx_max_coalesced_frames,
+ *  except that this value applies while an IRQ is being serviced
+ *  by the host.
+ * stats_block_coalesce_usecs: How many usecs to delay in-memory
+ *  statistics block updates.
+ * use_adaptive_rx_coalesce: Enable adaptive RX coalescing.
+ * use_adaptive_tx_coalesce: Enable adaptive TX coalescing.
+ * pkt_rate_low: Threshold for low packet rate (packets per second).
+ * rx_coalesce_usecs_low: How many usecs to delay an RX interrupt after
+ *  a packet arrives, when the packet rate is below pkt_rate_low.
+ * rx_max_coalesced_frames_low: Maximum number of packets to be received
+ *  before an RX interrupt, when the packet rate is below pkt_rate_low.
+ * tx_coalesce_usecs_low: How many usecs to delay a TX interrupt after
+ *  a packet is sent, when the packet rate is below pkt_rate_low.
+ * tx_max_coalesced_frames_low: Maximum number of packets to be sent before
+ *  a TX interrupt, when the packet rate is below pkt_rate_low.
+ * pkt_rate_high: Threshold for high packet rate (packets per second).
+ * rx_coalesce_usecs_high: How many usecs to delay an RX interrupt after
+ *  a packet arrives, when the packet rate is above pkt_rate_high.
+ * rx_max_coalesced_frames_high: Maximum number of packets to be received
+ *  before an RX interrupt, when the packet rate is above pkt_rate_high.
+ * tx_coalesce_usecs_high: How many usecs to delay a TX interrupt after
+ *  a packet is sent, when the packet rate is above pkt_rate_high.
+ * tx_max_coalesced_frames_high: Maximum number of packets to be sent before
+ *  a TX interrupt, when the packet rate is above pkt_rate_high.
+ * rate_sample_interval: How often to do adaptive coalescing packet rate
+ *  sampling, measured in seconds.  Must not be zero.
+ *
+ * The drivers based on the netdev upper half poll the device from a work
+ * thread: rx_coalesce_usecs delays the poll after an RX interrupt, and
+ * rx_max_coalesced_frames is the budget of packets received in one poll
+ * (0 for no limit).  The other fields are passed to the lower half.
+ *
+ * A value of zero in a usecs field means the corresponding max frames
+ * field should be used instead, and each driver may ignore the fields
+ * which the hardware does not support.
+ */
+
+struct ethtool_coalesce
+{
+  uint32_t cmd;
+  uint32_t rx_coalesce_usecs;
+  uint32_t rx_max_coalesced_frames;
+  uint32_t rx_coalesce_usecs_irq;
+  uint32_t rx_max_coalesced_frames_irq;
+  uint32_t tx_coalesce_usecs;
+  uint32_t tx_max_coalesced_frames;
+  uint32_t tx_coalesce_usecs_irq;
+  uint32_t tx_max_coalesced_frames_irq;
+  uint32_t stats_block_coalesce_usecs;
+  uint32_t use_adaptive_rx_coalesce;
+  uint32_t use_adaptive_tx_coalesce;
+  uint32_t pkt_rate_low;
+  uint32_t rx_coalesce_usecs_low;
+  uint32_t rx_max_coalesced_frames_low;
+  uint32_t tx_coalesce_usecs_low;
+  uint32_t tx_max_coalesced_frames_low;
+  uint32_t pkt_rate_high;
+  uint32_t rx_coalesce_usecs_high;
+  uint32_t rx_max_coalesced_frames_high;
+  uint32_t tx_coalesce_usecs_high;
+  uint32_t tx_max_coalesced_frames_high;
+  uint32_t rate_sample_interval;
+};
+
 #endif
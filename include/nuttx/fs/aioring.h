@@ -0,0 +1,137 @@
+/****************************************************************************
+ * include/nuttx/fs/aioring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_AIORING_H
+#define __INCLUDE_NUTTX_FS_AIORING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <aio.h>
+
+#include <nuttx/fs/ioctl.h>
+
+#ifdef CONFIG_FS_AIO_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The character driver giving a submission and completion ring to each
+ * open
+ */
+
+#define AIORING_DEVPATH     "/dev/aio"
+
+/* The largest number of entries of a ring */
+
+#define AIORING_MAXENTRIES  4096
+
+/* The operations of a submission queue entry */
+
+#define AIORING_OP_READ     LIO_READ   /* pread() into buf */
+#define AIORING_OP_WRITE    LIO_WRITE  /* pwrite() from buf, or write() if
+                                        * the file is opened for append */
+#define AIORING_OP_FSYNC    3          /* fsync() */
+
+/* AIO ring IOCTL commands */
+
+/* Command:      AIORIOC_SETUP
+ * Description:  Allocate the rings of this open.  The memory holding them
+ *               is then mapped with mmap() at offset zero.
+ * Argument:     A pointer to an instance of struct aioring_params_s.
+ *               nentries is rounded up to a power of two, and the size to
+ *               map is returned.
+ * Dependencies: CONFIG_FS_AIO_RING
+ */
+
+/* Command:      AIORIOC_ENTER
+ * Description:  Submit the entries added to the submission queue, then
+ *               wait until the completion queue holds at least the given
+ *               number of entries, or nothing more is in flight.  The
+ *               entries that do not fit with those in flight and those
+ *               not yet consumed from the completion queue are left in
+ *               the submission queue.
+ * Argument:     The number of completions to wait for, zero not to wait.
+ * Returned:     The number of entries submitted.
+ * Dependencies: CONFIG_FS_AIO_RING
+ */
+
+#define AIORIOC_SETUP       _AIOC(0x0001)
+#define AIORIOC_ENTER       _AIOC(0x0002)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A submission queue entry, filled in by the user */
+
+struct aioring_sqe_s
+{
+  uint8_t opcode;            /* AIORING_OP_* */
+  int fildes;                /* The file descriptor of the request */
+  off_t offset;              /* The file offset of a read or a write */
+  FAR void *buf;             /* The buffer of a read or a write */
+  size_t nbytes;             /* The length of a read or a write */
+  uintptr_t user_data;       /* Returned as is in the completion */
+};
+
+/* A completion queue entry, filled in by the OS */
+
+struct aioring_cqe_s
+{
+  uintptr_t user_data;       /* From the submission queue entry */
+  ssize_t result;            /* The result, or a negated errno value */
+};
+
+/* The start of the mapped memory.  The user owns sq_tail and cq_head, the
+ * OS owns sq_head and cq_tail.  The indexes are free running, the entry
+ * of index i is at i & (nentries - 1).
+ */
+
+struct aioring_s
+{
+  volatile uint32_t sq_head; /* Next submission consumed by the OS */
+  volatile uint32_t sq_tail; /* Next submission added by the user */
+  volatile uint32_t cq_head; /* Next completion consumed by the user */
+  volatile uint32_t cq_tail; /* Next completion added by the OS */
+  uint32_t nentries;         /* The number of entries of each queue */
+  uint32_t sq_offset;        /* Offset of the struct aioring_sqe_s array */
+  uint32_t cq_offset;        /* Offset of the struct aioring_cqe_s array */
+};
+
+/* The argument of AIORIOC_SETUP */
+
+struct aioring_params_s
+{
+  uint32_t nentries;         /* In: the requested number of entries
+                              * Out: the number of entries */
+  size_t size;               /* Out: the size of the memory to map */
+};
+
+#endif /* CONFIG_FS_AIO_RING */
+#endif /* __INCLUDE_NUTTX_FS_AIORING_H */
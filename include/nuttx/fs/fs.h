@@ -1534,6 +1534,35 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count);
 
+/****************************************************************************
+ * Name: file_xipbase
+ *
+ * Description:
+ *   Get the address and the size of the file content if the file system
+ *   keeps it directly addressable (romfs on XIP media, a small tmpfs
+ *   file), so it can be sent without reading it through a bounce buffer.
+ *   The content is pinned until file_xiprelease(): a write or a truncate
+ *   that would move or free it fails with EBUSY meanwhile.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if the content of the file
+ *   is not directly addressable.
+ *
+ ****************************************************************************/
+
+int file_xipbase(FAR struct file *filep, FAR const uint8_t **base,
+                 FAR off_t *size);
+
+/****************************************************************************
+ * Name: file_xiprelease
+ *
+ * Description:
+ *   Unpin the content of a file returned by a successful file_xipbase().
+ *
+ ****************************************************************************/
+
+void file_xiprelease(FAR struct file *filep);
+
 /****************************************************************************
  * Name: file_seek
  *
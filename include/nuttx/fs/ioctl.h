@@ -107,6 +107,7 @@
 #define _PINCTRLBASE    (0x4000) /* Pinctrl driver ioctl commands */
 #define _PCIBASE        (0x4100) /* Pci ioctl commands */
 #define _I3CBASE        (0x4200) /* I3C driver ioctl commands */
+#define _AIOCBASE       (0x4300) /* AIO ring ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -232,6 +233,19 @@
 #define FIOC_XIPBASE        _FIOC(0x0015) /* IN:  uinptr_t *
                                            * OUT: Current file xip base address
                                            */
+#define FIOC_CACHESTATS     _FIOC(0x0016) /* IN:  Pointer to writable instance
+                                           *      of struct fs_cachestats_s
+                                           * OUT: Statistics of the data
+                                           *      cache of the file system
+                                           */
+#define FIOC_XIPPIN         _FIOC(0x0017) /* IN:  None
+                                           * OUT: None, the xip base address
+                                           *      of the file no longer moves
+                                           *      until FIOC_XIPUNPIN
+                                           */
+#define FIOC_XIPUNPIN       _FIOC(0x0018) /* IN:  None
+                                           * OUT: None
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -251,6 +265,11 @@
 #define DIOC_SETKEY     _DIOC(0X0004)     /* IN:  Encryption key
                                            * OUT: None
                                            */
+#define DIOC_CACHESTATS _DIOC(0x0005)     /* IN:  Pointer to writable instance
+                                           *      of struct bch_cachestats_s
+                                           * OUT: Sector cache statistics of
+                                           *      the BCH device
+                                           */
 
 /* NuttX block driver ioctl definitions *************************************/
 
@@ -346,6 +365,13 @@
                                            *      to return sector numbers.
                                            * OUT: Data return in user-provided
                                            *      buffer. */
+#define BIOC_FTLSTATS   _BIOC(0x0011)     /* Get the statistics of a log-structured
+                                           * FTL.
+                                           * IN:  Pointer to writable struct
+                                           *      ftl_stats_s in which to
+                                           *      return the statistics.
+                                           * OUT: Data return in user-provided
+                                           *      buffer. */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -754,6 +780,13 @@
 #define _PINCTRLIOCVALID(c) (_IOC_TYPE(c)==_PINCTRLBASE)
 #define _PINCTRLIOC(nr)     _IOC(_PINCTRLBASE,nr)
 
+/* AIO ring driver ioctl definitions ****************************************/
+
+/* see nuttx/include/nuttx/fs/aioring.h */
+
+#define _AIOCVALID(c)   (_IOC_TYPE(c)==_AIOCBASE)
+#define _AIOC(nr)       _IOC(_AIOCBASE,nr)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -765,6 +798,14 @@ struct pipe_peek_s
   size_t size;
 };
 
+/* Statistics of a file system data cache, see FIOC_CACHESTATS */
+
+struct fs_cachestats_s
+{
+  uint32_t nhits;          /* Accesses served by the cache */
+  uint32_t nmisses;        /* Accesses which had to fill the cache */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
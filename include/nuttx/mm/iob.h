@@ -162,12 +162,25 @@ struct iob_queue_s
 };
 #endif /* CONFIG_IOB_NCHAINS > 0 */
 
+#ifdef CONFIG_IOB_CACHE
+struct iob_cache_stats_s
+{
+  int      ncached;  /* I/O buffers held by the cache */
+  uint32_t nhit;     /* Allocations served by the cache */
+  uint32_t nmiss;    /* Allocations which refilled the cache */
+  uint32_t ndrain;   /* Times the cache was drained to the pool */
+};
+#endif
+
 struct iob_stats_s
 {
   int ntotal;
   int nfree;
   int nwait;
   int nthrottle;
+#ifdef CONFIG_IOB_CACHE
+  struct iob_cache_stats_s cache[CONFIG_SMP_NCPUS];
+#endif
 };
 
 /****************************************************************************
@@ -405,6 +405,13 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
 size_t mm_heapfree(FAR struct mm_heap_s *heap);
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap);
 
+/* Functions contained in mm_arena.c ****************************************/
+
+#if CONFIG_MM_HEAP_ARENAS > 1
+int mm_mallinfo_arena(FAR struct mm_heap_s *heap, int arena,
+                      FAR struct mallinfo *info);
+#endif
+
 /* Functions contained in kmm_mallinfo.c ************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
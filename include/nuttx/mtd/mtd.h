@@ -121,6 +121,24 @@ struct mtd_geometry_s
   char     model[NAME_MAX + 1];
 };
 
+/* The statistics of a log-structured FTL, returned by BIOC_FTLSTATS.  The
+ * write amplification is flashwrites / hostwrites.
+ */
+
+struct ftl_stats_s
+{
+  uint64_t hostwrites;    /* Sectors written by the user */
+  uint64_t flashwrites;   /* Pages programmed, moves and summaries included */
+  uint64_t gcmoves;       /* Pages moved by the garbage collection */
+  uint32_t gcblocks;      /* Erase blocks collected */
+  uint32_t erases;        /* Erase blocks erased */
+  uint32_t minerases;     /* Lowest erase count of a good erase block */
+  uint32_t maxerases;     /* Highest erase count of a good erase block */
+  uint32_t avgerases;     /* Average erase count of the good erase blocks */
+  uint32_t freeblocks;    /* Erase blocks holding no data */
+  uint32_t badblocks;     /* Bad erase blocks */
+};
+
 /* This structure describes a range of sectors to be protected or
  * unprotected.
  */
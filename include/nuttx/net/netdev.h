@@ -174,6 +174,19 @@
 #  define NETDEV_TXTIMEOUTS(dev)  _NETDEV_ERROR(dev,tx_timeouts)
 #  define NETDEV_ERRORS(dev)      _NETDEV_STATISTIC(dev,errors)
 
+#  ifdef CONFIG_NETDEV_RSS
+#    define NETDEV_QUEUE_RXPACKETS(dev,q) \
+       ((dev)->d_statistics.queues[q].rx_packets++)
+#    define NETDEV_QUEUE_RXSTEERED(dev,q) \
+       ((dev)->d_statistics.queues[q].rx_steered++)
+#    define NETDEV_QUEUE_TXPACKETS(dev,q) \
+       ((dev)->d_statistics.queues[q].tx_packets++)
+#  else
+#    define NETDEV_QUEUE_RXPACKETS(dev,q)
+#    define NETDEV_QUEUE_RXSTEERED(dev,q)
+#    define NETDEV_QUEUE_TXPACKETS(dev,q)
+#  endif
+
 #else
 #  define NETDEV_RESET_STATISTICS(dev)
 #  define NETDEV_RXPACKETS(dev)
@@ -190,6 +203,10 @@
 #  define NETDEV_TXTIMEOUTS(dev)
 
 #  define NETDEV_ERRORS(dev)
+
+#  define NETDEV_QUEUE_RXPACKETS(dev,q)
+#  define NETDEV_QUEUE_RXSTEERED(dev,q)
+#  define NETDEV_QUEUE_TXPACKETS(dev,q)
 #endif
 
 /* There are some helper pointers for accessing the contents of the IP
@@ -220,6 +237,17 @@
  * Public Types
  ****************************************************************************/
 
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_RSS)
+/* Per queue (CPU) counts of the upper half driver */
+
+struct netdev_queue_statistics_s
+{
+  uint32_t rx_packets;     /* Number of packets received on the queue */
+  uint32_t rx_steered;     /* Number of packets steered to another CPU */
+  uint32_t tx_packets;     /* Number of packets sent on the queue */
+};
+#endif
+
 #ifdef CONFIG_NETDEV_STATISTICS
 /* If CONFIG_NETDEV_STATISTICS is enabled and if the driver supports
  * statistics, then this structure holds the counts of network driver
@@ -257,6 +285,10 @@ struct netdev_statistics_s
 
   uint32_t errors;         /* Total number of errors */
 
+#ifdef CONFIG_NETDEV_RSS
+  struct netdev_queue_statistics_s queues[CONFIG_SMP_NCPUS];
+#endif
+
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
   struct work_s logwork;   /* For periodic log work */
 #endif
@@ -830,6 +862,50 @@ uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 
 uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset);
 
+/****************************************************************************
+ * Name: chksum_iob_copyin
+ *
+ * Description:
+ *   Copy data into an iob chain and calculate the raw change sum over it
+ *   in the same pass, equivalent to iob_copyin() followed by chksum() on
+ *   src.  The chain must already be long enough, see iob_update_pktlen().
+ *
+ * Input Parameters:
+ *   sum    - Partial calculations carried over from a previous call,
+ *            updated on return.  This should be zero on the first call.
+ *   iob    - The iob chain to copy to.
+ *   src    - Beginning of the data to copy and include in the checksum.
+ *   len    - Number of bytes to copy.
+ *   offset - Byte offset of the destination in the chain.
+ *
+ * Returned Value:
+ *   The number of bytes copied, less than len only if the chain is too
+ *   short.
+ *
+ ****************************************************************************/
+
+unsigned int chksum_iob_copyin(FAR uint16_t *sum, FAR struct iob_s *iob,
+                               FAR const uint8_t *src, unsigned int len,
+                               unsigned int offset);
+
+/****************************************************************************
+ * Name: up_chksum
+ *
+ * Description:
+ *   Calculate the one's complement sum of a memory region taken as 16-bit
+ *   words in the native byte order, folded to 16 bits.  The odd trailing
+ *   byte, if any, is padded with zero.  The region may start at any
+ *   address.
+ *
+ *   If CONFIG_LIBC_ARCH_CHKSUM is defined, this function is provided by
+ *   the architecture-specific C library and used by chksum() and friends.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_ARCH_CHKSUM
+uint16_t up_chksum(FAR const void *data, size_t len);
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -1347,4 +1423,30 @@ int netdev_ipv6_foreach(FAR struct net_driver_s *dev,
 void netdev_statistics_log(FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: netdev_flowhash
+ *
+ * Description:
+ *   Calculate the flow hash of a connection, the same hash is reported to
+ *   the driver by SIOCNOTIFYRECVCPU.  The local address and port are the
+ *   destination of the received packets.
+ *
+ * Input Parameters:
+ *   domain   - The layer 3 protocol, PF_INET/PF_INET6
+ *   src_addr - The local address
+ *   src_port - The local port
+ *   dst_addr - The remote address
+ *   dst_port - The remote port
+ *
+ * Returned Value:
+ *   The hash value
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RSS
+uint32_t netdev_flowhash(uint8_t domain,
+                         FAR const void *src_addr, uint16_t src_port,
+                         FAR const void *dst_addr, uint16_t dst_port);
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_H */
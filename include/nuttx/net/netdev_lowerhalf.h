@@ -119,6 +119,16 @@ struct netdev_lowerhalf_s
 
   atomic_int quota[NETPKT_TYPENUM];
 
+#ifdef CONFIG_NETDEV_RSS
+  /* Number of hardware RX/TX queues, 0 or 1 for the single queue devices.
+   * Queue n is served by the work thread pinned to CPU n, so there could
+   * be at most CONFIG_SMP_NCPUS queues.
+   */
+
+  uint8_t rxqueues;
+  uint8_t txqueues;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -172,6 +182,17 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+#ifdef CONFIG_NETDEV_RSS
+  /* transmit_queue/receive_queue - The same as transmit/receive, but on the
+   *   specified hardware queue.  Required when txqueues/rxqueues > 1.
+   */
+
+  CODE int (*transmit_queue)(FAR struct netdev_lowerhalf_s *dev,
+                             FAR netpkt_t *pkt, int queue);
+  CODE FAR netpkt_t *(*receive_queue)(FAR struct netdev_lowerhalf_s *dev,
+                                      int queue);
+#endif
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -308,6 +329,42 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   the specified hardware queue.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The hardware queue index
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RSS
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue);
+#endif
+
+/****************************************************************************
+ * Name: netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about a TX packet is sent on the
+ *   specified hardware queue.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The hardware queue index
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RSS
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               int queue);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
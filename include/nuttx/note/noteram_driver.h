@@ -54,6 +54,9 @@
  * NOTERAM_SETREADMODE
  *              - Set read mode
  *                Argument: A read-only pointer to unsigned int
+ * NOTERAM_GETSTATS
+ *              - Get the statistics summed over all CPUs
+ *                Argument: A writable pointer to struct noteram_stats_s
  */
 
 #ifdef CONFIG_DRIVERS_NOTERAM
@@ -62,6 +65,7 @@
 #define NOTERAM_SETMODE         _NOTERAMIOC(0x03)
 #define NOTERAM_GETREADMODE     _NOTERAMIOC(0x04)
 #define NOTERAM_SETREADMODE     _NOTERAMIOC(0x05)
+#define NOTERAM_GETSTATS        _NOTERAMIOC(0x06)
 #endif
 
 /* Overwrite mode definitions */
@@ -81,6 +85,18 @@
 
 struct noteram_driver_s;
 
+/* This is the type of the argument passed to the NOTERAM_GETSTATS ioctl.
+ * ncycles / nnotes is the average cost of adding a note in perf counter
+ * ticks, which are CPU cycles on most architectures.
+ */
+
+struct noteram_stats_s
+{
+  uint32_t nnotes;            /* Number of notes added */
+  uint32_t nlost;             /* Notes dropped or overwritten unread */
+  uint64_t ncycles;           /* Perf counter ticks spent adding notes */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -0,0 +1,226 @@
+/****************************************************************************
+ * include/nuttx/rcu.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RCU_H
+#define __INCLUDE_NUTTX_RCU_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#ifdef CONFIG_RCU
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Order the initialization of an object before its publication */
+
+#ifdef __GNUC__
+#  define RCU_PUBLISH_BARRIER() \
+  do \
+    { \
+      __asm__ __volatile__("" : : : "memory"); \
+      SP_DMB(); \
+    } \
+  while (0)
+#else
+#  define RCU_PUBLISH_BARRIER() SP_DMB()
+#endif
+
+/* Fetch a pointer protected by RCU inside a read-side critical section.
+ * The pointer is read exactly once.
+ */
+
+#define rcu_dereference(p)  (*(FAR volatile typeof(p) *)&(p))
+
+/* Publish a pointer to an initialized object to the readers */
+
+#define rcu_assign_pointer(p, v) \
+  do \
+    { \
+      RCU_PUBLISH_BARRIER(); \
+      *(FAR volatile typeof(p) *)&(p) = (v); \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* The read-side state of one CPU.  Readers run with the local interrupts
+ * disabled, so they are never preempted nor migrated, and only the local
+ * CPU touches flags and nest.
+ */
+
+struct rcu_cpu_s
+{
+  irqstate_t        flags;  /* Interrupt state saved by the outermost reader */
+  uint16_t          nest;   /* Nesting depth of the read-side sections */
+  volatile uint32_t qs;     /* Count of context switches of this CPU */
+};
+
+/* Deferred callback queued by call_rcu() */
+
+struct rcu_head_s;
+typedef CODE void (*rcu_callback_t)(FAR struct rcu_head_s *head);
+
+struct rcu_head_s
+{
+  FAR struct rcu_head_s *next;
+  rcu_callback_t         func;
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+EXTERN struct rcu_cpu_s g_rcu_cpu[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_read_lock
+ *
+ * Description:
+ *   Enter a read-side critical section.  The objects reached through
+ *   rcu_dereference() stay valid until the matching rcu_read_unlock().
+ *   The section may nest and may be entered from an interrupt handler,
+ *   but it must be short and must not block.
+ *
+ ****************************************************************************/
+
+static inline_function void rcu_read_lock(void)
+{
+  FAR struct rcu_cpu_s *rcu;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  rcu   = &g_rcu_cpu[this_cpu()];
+  if (rcu->nest++ == 0)
+    {
+      rcu->flags = flags;
+    }
+}
+
+/****************************************************************************
+ * Name: rcu_read_unlock
+ *
+ * Description:
+ *   Leave a read-side critical section.
+ *
+ ****************************************************************************/
+
+static inline_function void rcu_read_unlock(void)
+{
+  FAR struct rcu_cpu_s *rcu = &g_rcu_cpu[this_cpu()];
+
+  DEBUGASSERT(rcu->nest > 0);
+  if (--rcu->nest == 0)
+    {
+      up_irq_restore(rcu->flags);
+    }
+}
+
+/****************************************************************************
+ * Name: rcu_read_lock_held
+ *
+ * Description:
+ *   Return true if the caller is inside a read-side critical section.
+ *
+ ****************************************************************************/
+
+static inline_function bool rcu_read_lock_held(void)
+{
+  bool held;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  held  = g_rcu_cpu[this_cpu()].nest > 0;
+  up_irq_restore(flags);
+  return held;
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait until every read-side critical section which was in progress when
+ *   this function was called has completed.  Objects unpublished before the
+ *   call may then be freed.  It must be called from a task, outside of any
+ *   read-side critical section.
+ *
+ ****************************************************************************/
+
+void synchronize_rcu(void);
+
+/****************************************************************************
+ * Name: call_rcu
+ *
+ * Description:
+ *   Call func(head) from the work queue after a grace period, without
+ *   waiting for it.  The callbacks queued at about the same time share one
+ *   grace period.  This may be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   head - Embedded in the object to reclaim, owned by RCU until the call.
+ *   func - The function which reclaims the object.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+void call_rcu(FAR struct rcu_head_s *head, rcu_callback_t func);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_RCU */
+#endif /* __INCLUDE_NUTTX_RCU_H */
@@ -466,4 +466,12 @@
 
 #define SNIOC_GET_EVENTS              _SNIOC(0x009E)
 
+/* Command:      SNIOC_WAIT_UPDATE
+ * Description:  Wait until the head of the mapped circular buffer differs
+ *               from the given event index.
+ * Argument:     The event index the subscriber has caught up to, uint32_t
+ */
+
+#define SNIOC_WAIT_UPDATE             _SNIOC(0x009F)
+
 #endif /* __INCLUDE_NUTTX_SENSORS_IOCTL_H */
@@ -1128,6 +1128,22 @@ struct sensor_ustate_s
   uint64_t generation;         /* The recent generation of circular buffer */
 };
 
+/* This structure is the start of the circular buffer mapped by mmap(), the
+ * events follow it, event n at offset (n & (nbuffer - 1)) * esize, nbuffer
+ * being rounded up to a power of two for the mapping.  The publisher
+ * sets begin before it overwrites any event and head after it is done, so a
+ * subscriber copies event n (n < head) and then checks that
+ * begin - n <= nbuffer, otherwise the event was overwritten meanwhile.
+ */
+
+struct sensor_ring_s
+{
+  uint32_t esize;              /* The element size of circular buffer */
+  uint32_t nbuffer;            /* The number of events that the circular buffer can hold */
+  volatile uint32_t begin;     /* The number of events published or being written */
+  volatile uint32_t head;      /* The number of events published */
+};
+
 /* This structure describes the register info for the user sensor */
 
 #ifdef CONFIG_USENSOR
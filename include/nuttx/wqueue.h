@@ -261,6 +261,10 @@ struct work_s
   worker_t  worker;              /* Work callback */
   FAR void *arg;                 /* Callback argument */
   FAR struct kwork_wqueue_s *wq; /* Work queue */
+#if defined(CONFIG_SCHED_WORKQUEUE_PERCPU) || \
+    defined(CONFIG_SCHED_WORKQUEUE_TIMER)
+  uint8_t flags;                 /* Kernel work queue private flags */
+#endif
 };
 
 /* This is an enumeration of the various events that may be
@@ -417,6 +421,34 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
                   FAR struct work_s *work, worker_t worker,
                   FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue work like work_queue(), to be performed by the worker threads of
+ *   one CPU.  The work is never taken by the workers of another CPU.  This
+ *   is the same as work_queue() if CONFIG_SCHED_WORKQUEUE_PERCPU is not
+ *   enabled.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   cpu    - The CPU to perform the work
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, clock_t delay);
+
 /****************************************************************************
  * Name: work_queue_pri
  *
@@ -522,7 +554,9 @@ int work_cancel_sync_wq(FAR struct kwork_wqueue_s *wqueue,
  *
  ****************************************************************************/
 
-#ifdef __KERNEL__
+#if defined(__KERNEL__) && defined(CONFIG_SCHED_WORKQUEUE_TIMER)
+sclock_t work_timeleft(FAR struct work_s *work);
+#elif defined(__KERNEL__)
 #  define work_timeleft(work) wd_gettime(&((work)->u.timer))
 #else
 #  define work_timeleft(work) ((sclock_t)((work)->u.s.qtime - clock()))
@@ -0,0 +1,129 @@
+/****************************************************************************
+ * libs/libc/machine/arm64/arch_chksum.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <arm_neon.h>
+
+#include <nuttx/net/netdev.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Byte loads have no alignment requirement even if checking is enabled */
+
+#define CHKSUM_LOAD(p)      vreinterpretq_u32_u8(vld1q_u8(p))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint16_t chksum_fold(uint64_t acc)
+{
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  return (uint16_t)acc;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_chksum
+ *
+ * Description:
+ *   Calculate the one's complement sum of a memory region as native 16-bit
+ *   words.  The 32-bit words are pairwise added into 64-bit lanes, so no
+ *   carry is lost and the lanes are folded only once at the end.  Unaligned
+ *   loads are cheap here, so any start address is taken as is.
+ *
+ ****************************************************************************/
+
+uint16_t up_chksum(FAR const void *data, size_t len)
+{
+  FAR const uint8_t *ptr = data;
+  uint64x2_t sum0 = vdupq_n_u64(0);
+  uint64x2_t sum1 = vdupq_n_u64(0);
+  uint64_t acc;
+  uint32_t word;
+  uint16_t half;
+
+  /* Two accumulators to hide the latency of the accumulating adds */
+
+  while (len >= 64)
+    {
+      sum0 = vpadalq_u32(sum0, CHKSUM_LOAD(ptr));
+      sum1 = vpadalq_u32(sum1, CHKSUM_LOAD(ptr + 16));
+      sum0 = vpadalq_u32(sum0, CHKSUM_LOAD(ptr + 32));
+      sum1 = vpadalq_u32(sum1, CHKSUM_LOAD(ptr + 48));
+      ptr += 64;
+      len -= 64;
+    }
+
+  while (len >= 16)
+    {
+      sum0 = vpadalq_u32(sum0, CHKSUM_LOAD(ptr));
+      ptr += 16;
+      len -= 16;
+    }
+
+  acc = vaddvq_u64(vaddq_u64(sum0, sum1));
+
+  while (len >= 4)
+    {
+      memcpy(&word, ptr, 4);
+      acc += word;
+      ptr += 4;
+      len -= 4;
+    }
+
+  if (len >= 2)
+    {
+      memcpy(&half, ptr, 2);
+      acc += half;
+      ptr += 2;
+      len -= 2;
+    }
+
+  if (len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc += (uint16_t)*ptr << 8;
+#else
+      acc += *ptr;
+#endif
+    }
+
+  return chksum_fold(acc);
+}
@@ -0,0 +1,118 @@
+/****************************************************************************
+ * libs/libc/machine/arm64/arch_crc32.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <arm_acle.h>
+
+#include <nuttx/crc32.h>
+#include <nuttx/crc32c.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The CRC32 extension is optional in ARMv8.0 and mandatory from ARMv8.1,
+ * enable it per function if the compiler doesn't target it already.
+ */
+
+#if defined(__ARM_FEATURE_CRC32)
+#  define CRC32_TARGET
+#elif defined(__clang__)
+#  define CRC32_TARGET      __attribute__((target("crc")))
+#else
+#  define CRC32_TARGET      __attribute__((target("+crc")))
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_crc32part
+ *
+ * Description:
+ *   Calculate CRC32 eight bytes at a time with the CRC32X instruction.
+ *   Unaligned loads are cheap here, so any start address is taken as is.
+ *
+ ****************************************************************************/
+
+CRC32_TARGET
+size_t up_crc32part(FAR const uint8_t *src, size_t len,
+                    FAR uint32_t *crc32val)
+{
+  uint32_t crc = *crc32val;
+  uint64_t word;
+  size_t i;
+
+  for (i = 0; i + 8 <= len; i += 8)
+    {
+      memcpy(&word, src + i, 8);
+      crc = __crc32d(crc, word);
+    }
+
+  for (; i < len; i++)
+    {
+      crc = __crc32b(crc, src[i]);
+    }
+
+  *crc32val = crc;
+  return len;
+}
+
+/****************************************************************************
+ * Name: up_crc32cpart
+ *
+ * Description:
+ *   Calculate CRC32C eight bytes at a time with the CRC32CX instruction.
+ *
+ ****************************************************************************/
+
+CRC32_TARGET
+size_t up_crc32cpart(FAR const uint8_t *src, size_t len,
+                     FAR uint32_t *crc32val)
+{
+  uint32_t crc = *crc32val;
+  uint64_t word;
+  size_t i;
+
+  for (i = 0; i + 8 <= len; i += 8)
+    {
+      memcpy(&word, src + i, 8);
+      crc = __crc32cd(crc, word);
+    }
+
+  for (; i < len; i++)
+    {
+      crc = __crc32cb(crc, src[i]);
+    }
+
+  *crc32val = crc;
+  return len;
+}
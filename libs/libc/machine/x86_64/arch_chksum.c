@@ -0,0 +1,144 @@
+/****************************************************************************
+ * libs/libc/machine/x86_64/arch_chksum.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <immintrin.h>
+
+#include <nuttx/net/netdev.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint16_t chksum_fold(uint64_t acc)
+{
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  return (uint16_t)acc;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_chksum
+ *
+ * Description:
+ *   Calculate the one's complement sum of a memory region as native 16-bit
+ *   words.  The 32-bit words are zero extended into 64-bit lanes, so no
+ *   carry is lost and the lanes are folded only once at the end.  Unaligned
+ *   loads are cheap here, so any start address is taken as is.
+ *
+ ****************************************************************************/
+
+uint16_t up_chksum(FAR const void *data, size_t len)
+{
+  FAR const uint8_t *ptr = data;
+  __m128i zero = _mm_setzero_si128();
+  __m128i sum = zero;
+  uint64_t acc;
+  uint32_t word;
+  uint16_t half;
+
+#ifdef __AVX2__
+  if (len >= 64)
+    {
+      __m256i zero256 = _mm256_setzero_si256();
+      __m256i sum256 = zero256;
+      __m256i a;
+      __m256i b;
+
+      do
+        {
+          a = _mm256_loadu_si256((FAR const __m256i *)ptr);
+          b = _mm256_loadu_si256((FAR const __m256i *)(ptr + 32));
+          sum256 = _mm256_add_epi64(sum256,
+                                    _mm256_unpacklo_epi32(a, zero256));
+          sum256 = _mm256_add_epi64(sum256,
+                                    _mm256_unpackhi_epi32(a, zero256));
+          sum256 = _mm256_add_epi64(sum256,
+                                    _mm256_unpacklo_epi32(b, zero256));
+          sum256 = _mm256_add_epi64(sum256,
+                                    _mm256_unpackhi_epi32(b, zero256));
+          ptr += 64;
+          len -= 64;
+        }
+      while (len >= 64);
+
+      sum = _mm_add_epi64(_mm256_castsi256_si128(sum256),
+                          _mm256_extracti128_si256(sum256, 1));
+    }
+#endif
+
+  while (len >= 32)
+    {
+      __m128i a = _mm_loadu_si128((FAR const __m128i *)ptr);
+      __m128i b = _mm_loadu_si128((FAR const __m128i *)(ptr + 16));
+
+      sum  = _mm_add_epi64(sum, _mm_unpacklo_epi32(a, zero));
+      sum  = _mm_add_epi64(sum, _mm_unpackhi_epi32(a, zero));
+      sum  = _mm_add_epi64(sum, _mm_unpacklo_epi32(b, zero));
+      sum  = _mm_add_epi64(sum, _mm_unpackhi_epi32(b, zero));
+      ptr += 32;
+      len -= 32;
+    }
+
+  acc = (uint64_t)_mm_cvtsi128_si64(sum) +
+        (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(sum, sum));
+
+  /* Lanes hold at most len / 8 32-bit words each, so acc can't wrap */
+
+  while (len >= 4)
+    {
+      memcpy(&word, ptr, 4);
+      acc += word;
+      ptr += 4;
+      len -= 4;
+    }
+
+  if (len >= 2)
+    {
+      memcpy(&half, ptr, 2);
+      acc += half;
+      ptr += 2;
+      len -= 2;
+    }
+
+  if (len > 0)
+    {
+      acc += *ptr;
+    }
+
+  return chksum_fold(acc);
+}
@@ -0,0 +1,217 @@
+/****************************************************************************
+ * libs/libc/machine/x86_64/arch_crc32.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <immintrin.h>
+
+#include <nuttx/crc32.h>
+#include <nuttx/crc32c.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Enabled per function, so the simulator can be built for any host CPU */
+
+#define CRC32_TARGET        __attribute__((target("sse4.2,pclmul")))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Folding constants for the bit reflected polynomial 0x04c11db7, all of
+ * them reflected and shifted left by one bit:
+ *
+ *   k1, k2 - x^(4*128+32) and x^(4*128-32) mod P, fold 512 bits ahead
+ *   k3, k4 - x^(128+32) and x^(128-32) mod P, fold 128 bits ahead
+ *   k5     - x^64 mod P, fold 64 bits to 32 bits
+ *   mu, P' - floor(x^64 / P) and P for the Barrett reduction
+ */
+
+static const uint64_t g_crc32_k1k2[2] __attribute__((aligned(16))) =
+{
+  0x0154442bd4, 0x01c6e41596
+};
+
+static const uint64_t g_crc32_k3k4[2] __attribute__((aligned(16))) =
+{
+  0x01751997d0, 0x00ccaa009e
+};
+
+static const uint64_t g_crc32_k5k0[2] __attribute__((aligned(16))) =
+{
+  0x0163cd6124, 0x0000000000
+};
+
+static const uint64_t g_crc32_poly[2] __attribute__((aligned(16))) =
+{
+  0x01db710641, 0x01f7011641
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Multiply both halves of x by k and add them to y */
+
+CRC32_TARGET
+static inline __m128i crc32_fold(__m128i x, __m128i k, __m128i y)
+{
+  __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+  __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+
+  return _mm_xor_si128(_mm_xor_si128(hi, lo), y);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_crc32part
+ *
+ * Description:
+ *   Fold the buffer 64 bytes per round with carry-less multiplications
+ *   (PCLMULQDQ), as described in Intel's "Fast CRC Computation for Generic
+ *   Polynomials Using PCLMULQDQ Instruction".  Only buffers of 64 bytes or
+ *   more are worth it, and the last 0-15 bytes are left to the tables.
+ *
+ ****************************************************************************/
+
+CRC32_TARGET
+size_t up_crc32part(FAR const uint8_t *src, size_t len,
+                    FAR uint32_t *crc32val)
+{
+  FAR const uint8_t *ptr = src;
+  __m128i x0;
+  __m128i x1;
+  __m128i x2;
+  __m128i x3;
+  __m128i k;
+  __m128i mask;
+
+  if (len < 64)
+    {
+      return 0;
+    }
+
+  len &= ~(size_t)15;
+
+  x0 = _mm_loadu_si128((FAR const __m128i *)ptr);
+  x1 = _mm_loadu_si128((FAR const __m128i *)(ptr + 16));
+  x2 = _mm_loadu_si128((FAR const __m128i *)(ptr + 32));
+  x3 = _mm_loadu_si128((FAR const __m128i *)(ptr + 48));
+  x0 = _mm_xor_si128(x0, _mm_cvtsi32_si128(*crc32val));
+  ptr += 64;
+  len -= 64;
+
+  /* Four independent folds per round to hide the multiplier latency */
+
+  k = _mm_load_si128((FAR const __m128i *)g_crc32_k1k2);
+  while (len >= 64)
+    {
+      x0 = crc32_fold(x0, k, _mm_loadu_si128((FAR const __m128i *)ptr));
+      x1 = crc32_fold(x1, k,
+                      _mm_loadu_si128((FAR const __m128i *)(ptr + 16)));
+      x2 = crc32_fold(x2, k,
+                      _mm_loadu_si128((FAR const __m128i *)(ptr + 32)));
+      x3 = crc32_fold(x3, k,
+                      _mm_loadu_si128((FAR const __m128i *)(ptr + 48)));
+      ptr += 64;
+      len -= 64;
+    }
+
+  /* Fold the four lanes into one, then the remaining 16 byte blocks */
+
+  k  = _mm_load_si128((FAR const __m128i *)g_crc32_k3k4);
+  x0 = crc32_fold(x0, k, x1);
+  x0 = crc32_fold(x0, k, x2);
+  x0 = crc32_fold(x0, k, x3);
+
+  while (len >= 16)
+    {
+      x0 = crc32_fold(x0, k, _mm_loadu_si128((FAR const __m128i *)ptr));
+      ptr += 16;
+      len -= 16;
+    }
+
+  /* Fold 128 bits to 64 bits, then 64 bits to 32 bits */
+
+  mask = _mm_setr_epi32(~0, 0, ~0, 0);
+  x1   = _mm_clmulepi64_si128(x0, k, 0x10);
+  x0   = _mm_xor_si128(_mm_srli_si128(x0, 8), x1);
+
+  k  = _mm_loadl_epi64((FAR const __m128i *)g_crc32_k5k0);
+  x1 = _mm_srli_si128(x0, 4);
+  x0 = _mm_clmulepi64_si128(_mm_and_si128(x0, mask), k, 0x00);
+  x0 = _mm_xor_si128(x0, x1);
+
+  /* Barrett reduction to the 32-bit remainder */
+
+  k  = _mm_load_si128((FAR const __m128i *)g_crc32_poly);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x0, mask), k, 0x10);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x00);
+  x0 = _mm_xor_si128(x0, x1);
+
+  *crc32val = _mm_extract_epi32(x0, 1);
+  return ptr - src;
+}
+
+/****************************************************************************
+ * Name: up_crc32cpart
+ *
+ * Description:
+ *   The SSE4.2 CRC32 instruction computes CRC32C directly, eight bytes at a
+ *   time.  It handles any length, so the whole buffer is taken.
+ *
+ ****************************************************************************/
+
+CRC32_TARGET
+size_t up_crc32cpart(FAR const uint8_t *src, size_t len,
+                     FAR uint32_t *crc32val)
+{
+  uint64_t crc = *crc32val;
+  uint64_t word;
+  size_t i;
+
+  for (i = 0; i + 8 <= len; i += 8)
+    {
+      memcpy(&word, src + i, 8);
+      crc = _mm_crc32_u64(crc, word);
+    }
+
+  for (; i < len; i++)
+    {
+      crc = _mm_crc32_u8((uint32_t)crc, src[i]);
+    }
+
+  *crc32val = (uint32_t)crc;
+  return len;
+}
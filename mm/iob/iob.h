@@ -139,6 +139,83 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_free_pool
+ *
+ * Description:
+ *   Return a list of I/O buffers linked by io_flink to the global pool
+ *   in one critical section.
+ *
+ ****************************************************************************/
+
+void iob_free_pool(FAR struct iob_s *iob);
+
+#ifdef CONFIG_IOB_CACHE
+/****************************************************************************
+ * Name: iob_alloc_pool
+ *
+ * Description:
+ *   Take up to 'count' I/O buffers from the free list of the global pool in
+ *   one critical section.  The buffers are linked by io_flink.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_pool(int count);
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Allocate an I/O buffer from the cache of this CPU, refill the cache
+ *   from the global pool in a batch if it is empty.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(void);
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Keep a free I/O buffer in the cache of this CPU.  Return false if some
+ *   task is waiting for an I/O buffer and it must go to the global pool.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the I/O buffers held by the caches of all CPUs to the global
+ *   pool.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void);
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers held by the caches of all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void);
+
+/****************************************************************************
+ * Name: iob_cache_getstats
+ *
+ * Description:
+ *   Return the statistics of the caches of all CPUs.
+ *
+ ****************************************************************************/
+
+void iob_cache_getstats(FAR struct iob_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
@@ -207,6 +207,15 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
    * we are waiting for I/O buffers to become free.
    */
 
+#ifdef CONFIG_IOB_CACHE
+  /* Try the cache of this CPU first for the non-throttled allocation */
+
+  if (!throttled && (iob = iob_cache_alloc()) != NULL)
+    {
+      return iob;
+    }
+#endif
+
   flags = spin_lock_irqsave(&g_iob_lock);
 
   /* Try to get an I/O buffer.  If successful, the semaphore count will be
@@ -226,6 +235,14 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
       spin_unlock_irqrestore(&g_iob_lock, flags);
 
+#ifdef CONFIG_IOB_CACHE
+      /* Return the buffers held by the caches, they are committed to the
+       * waiters (including us) now that the count is negative.
+       */
+
+      iob_cache_drain();
+#endif
+
       if (timeout == UINT_MAX)
         {
           ret = nxsem_wait_uninterruptible(sem);
@@ -337,12 +354,61 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
    * to protect the free list:  We disable interrupts very briefly.
    */
 
+#ifdef CONFIG_IOB_CACHE
+  /* Try the cache of this CPU first for the non-throttled allocation */
+
+  if (!throttled && (iob = iob_cache_alloc()) != NULL)
+    {
+      return iob;
+    }
+#endif
+
   flags = spin_lock_irqsave(&g_iob_lock);
   iob = iob_tryalloc_internal(throttled);
   spin_unlock_irqrestore(&g_iob_lock, flags);
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_alloc_pool
+ *
+ * Description:
+ *   Take up to 'count' I/O buffers from the free list of the global pool in
+ *   one critical section, but no more than half of the free buffers, so
+ *   the others are not starved.  The buffers are linked by io_flink.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_CACHE
+FAR struct iob_s *iob_alloc_pool(int count)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  if (count > g_iob_count / 2)
+    {
+      count = g_iob_count / 2;
+    }
+
+  if (count < 1)
+    {
+      count = 1;
+    }
+
+  while (count-- > 0 && (iob = iob_tryalloc_internal(false)) != NULL)
+    {
+      iob->io_flink = head;
+      head          = iob;
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  return head;
+}
+#endif
+
 #ifdef CONFIG_IOB_ALLOC
 
 /****************************************************************************
@@ -0,0 +1,344 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <stdbool.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/spinlock.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_IOB_CACHE_BATCH < 1 || CONFIG_IOB_CACHE_BATCH > CONFIG_IOB_CACHE_SIZE
+#  error CONFIG_IOB_CACHE_BATCH must be in 1..CONFIG_IOB_CACHE_SIZE
+#endif
+
+/* Is any task waiting for a free I/O buffer? */
+
+#if CONFIG_IOB_THROTTLE > 0
+#  define IOB_WAITING() (g_iob_count < 0 || g_throttle_count < 0)
+#else
+#  define IOB_WAITING() (g_iob_count < 0)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The cache of free I/O buffers of one CPU.  Only the local CPU touches it
+ * except when the caches are drained for a waiter, so the lock is almost
+ * never contended and the cache line stays local.
+ */
+
+struct iob_cache_s
+{
+  spinlock_t        lock;
+  FAR struct iob_s *head;     /* Free I/O buffers linked by io_flink */
+  int16_t           count;    /* Number of I/O buffers in the cache */
+  uint32_t          nhit;     /* Allocations served by the cache */
+  uint32_t          nmiss;    /* Allocations which refilled the cache */
+  uint32_t          ndrain;   /* Times the cache was drained to the pool */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_lock
+ *
+ * Description:
+ *   Disable the local interrupts and lock the cache of this CPU.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_cache_s *iob_cache_lock(FAR irqstate_t *flags)
+{
+  FAR struct iob_cache_s *cache;
+
+  *flags = up_irq_save();
+  cache  = &g_iob_cache[this_cpu()];
+  spin_lock(&cache->lock);
+  return cache;
+}
+
+static void iob_cache_unlock(FAR struct iob_cache_s *cache,
+                             irqstate_t flags)
+{
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: iob_cache_init
+ *
+ * Description:
+ *   Put an I/O buffer taken from the cache in a known state.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_cache_init(FAR struct iob_s *iob)
+{
+  iob->io_flink  = NULL; /* Not in a chain */
+  iob->io_len    = 0;    /* Length of the data in the entry */
+  iob->io_offset = 0;    /* Offset to the beginning of data */
+  iob->io_pktlen = 0;    /* Total length of the packet */
+  return iob;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Allocate an I/O buffer from the cache of this CPU, refill the cache
+ *   from the global pool in a batch if it is empty.
+ *
+ * Returned Value:
+ *   The I/O buffer, or NULL if both the cache and the pool are empty.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  FAR struct iob_s *next;
+  irqstate_t flags;
+
+  cache = iob_cache_lock(&flags);
+
+  iob = cache->head;
+  if (iob != NULL)
+    {
+      cache->head = iob->io_flink;
+      cache->count--;
+      cache->nhit++;
+      iob_cache_unlock(cache, flags);
+      return iob_cache_init(iob);
+    }
+
+  cache->nmiss++;
+  iob_cache_unlock(cache, flags);
+
+  /* Refill in a batch from the global pool, keep the first one */
+
+  iob = iob_alloc_pool(CONFIG_IOB_CACHE_BATCH);
+  if (iob == NULL)
+    {
+      return NULL;
+    }
+
+  next = iob->io_flink;
+  if (next != NULL)
+    {
+      FAR struct iob_s *tail = next;
+      int count = 1;
+
+      while (tail->io_flink != NULL)
+        {
+          tail = tail->io_flink;
+          count++;
+        }
+
+      /* We may be on another CPU now, it doesn't matter */
+
+      cache = iob_cache_lock(&flags);
+      tail->io_flink = cache->head;
+      cache->head    = next;
+      cache->count  += count;
+      iob_cache_unlock(cache, flags);
+    }
+
+  return iob_cache_init(iob);
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Keep a free I/O buffer in the cache of this CPU, drain a batch to the
+ *   global pool if the cache is full.
+ *
+ * Returned Value:
+ *   true if the I/O buffer is taken by the cache, false if some task is
+ *   waiting for an I/O buffer and it must be freed to the global pool.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *drain = NULL;
+  irqstate_t flags;
+
+  cache = iob_cache_lock(&flags);
+
+  /* Checked with the cache locked: a waiter decreases the count before
+   * draining the caches, so either we see it here or it sees our buffer.
+   */
+
+  if (IOB_WAITING())
+    {
+      iob_cache_unlock(cache, flags);
+      return false;
+    }
+
+  if (cache->count >= CONFIG_IOB_CACHE_SIZE)
+    {
+      FAR struct iob_s *tail;
+      int i;
+
+      /* Detach a batch from the head of the cache */
+
+      drain = cache->head;
+      tail  = drain;
+      for (i = 1; i < CONFIG_IOB_CACHE_BATCH; i++)
+        {
+          tail = tail->io_flink;
+        }
+
+      cache->head    = tail->io_flink;
+      cache->count  -= CONFIG_IOB_CACHE_BATCH;
+      cache->ndrain++;
+      tail->io_flink = NULL;
+    }
+
+  iob->io_flink = cache->head;
+  cache->head   = iob;
+  cache->count++;
+  iob_cache_unlock(cache, flags);
+
+  if (drain != NULL)
+    {
+      iob_free_pool(drain);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the I/O buffers held by the caches of all CPUs to the global
+ *   pool.  Called before a task waits for a free I/O buffer.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *drain;
+  irqstate_t flags;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &g_iob_cache[cpu];
+      flags = spin_lock_irqsave(&cache->lock);
+
+      drain = cache->head;
+      if (drain != NULL)
+        {
+          cache->head  = NULL;
+          cache->count = 0;
+          cache->ndrain++;
+        }
+
+      spin_unlock_irqrestore(&cache->lock, flags);
+
+      if (drain != NULL)
+        {
+          iob_free_pool(drain);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers held by the caches of all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void)
+{
+  int navail = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      navail += g_iob_cache[cpu].count;
+    }
+
+  return navail;
+}
+
+/****************************************************************************
+ * Name: iob_cache_getstats
+ *
+ * Description:
+ *   Return the statistics of the caches of all CPUs.
+ *
+ ****************************************************************************/
+
+void iob_cache_getstats(FAR struct iob_stats_s *stats)
+{
+  FAR struct iob_cache_s *cache;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &g_iob_cache[cpu];
+      stats->cache[cpu].ncached = cache->count;
+      stats->cache[cpu].nhit    = cache->nhit;
+      stats->cache[cpu].nmiss   = cache->nmiss;
+      stats->cache[cpu].ndrain  = cache->ndrain;
+    }
+}
+
+#endif /* CONFIG_IOB_CACHE */
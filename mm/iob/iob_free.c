@@ -63,10 +63,149 @@
 
 #define IOB_MASK      (IOB_DIVIDER - 1)
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_free_signal
+ *
+ * Description:
+ *   Signal the threads waiting for the notification of an available IOB.
+ *
+ ****************************************************************************/
+
+static inline void iob_free_signal(void)
+{
+#ifdef CONFIG_IOB_NOTIFIER
+  int16_t navail;
+
+  /* Check if the IOB was claimed by a thread that is blocked waiting
+   * for an IOB.
+   */
+
+  navail = iob_navail(false);
+  if (navail > 0 && (navail & IOB_MASK) == 0)
+    {
+      /* Signal any threads that have requested a signal notification
+       * when an IOB becomes available.
+       */
+
+      iob_notifier_signal();
+    }
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_free_pool
+ *
+ * Description:
+ *   Return a list of I/O buffers linked by io_flink to the global pool
+ *   (the free list, or the committed list if there are tasks waiting for
+ *   I/O buffers) in one critical section.
+ *
+ ****************************************************************************/
+
+void iob_free_pool(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int npost = 0;
+#if CONFIG_IOB_THROTTLE > 0
+  int nthrottle = 0;
+#endif
+
+  /* Free the I/O buffers by adding them to the head of the free or the
+   * committed list. We don't know what context we are called from so
+   * we use extreme measures to protect the free list:  We disable
+   * interrupts very briefly.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  for (; iob != NULL; iob = next)
+    {
+      next = iob->io_flink;
+
+      /* Which list?  If there is a task waiting for an IOB, then put
+       * the IOB on either the free list or on the committed list where
+       * it is reserved for that allocation (and not available to
+       * iob_tryalloc()). This is true for both throttled and non-throttled
+       * cases.
+       */
+
+#if CONFIG_IOB_THROTTLE > 0
+      if ((g_iob_count < 0) ||
+          ((g_iob_count >= CONFIG_IOB_THROTTLE) &&
+           (g_throttle_count < 0)))
+#else
+      if (g_iob_count < 0)
+#endif
+        {
+          iob->io_flink   = g_iob_committed;
+          g_iob_committed = iob;
+
+#if CONFIG_IOB_THROTTLE > 0
+          if (g_iob_count < 0)
+            {
+              g_iob_count++;
+              npost++;
+            }
+          else
+            {
+              g_throttle_count++;
+              nthrottle++;
+            }
+#else
+          g_iob_count++;
+          npost++;
+#endif
+        }
+      else
+        {
+          g_iob_count++;
+#if CONFIG_IOB_THROTTLE > 0
+          if (g_iob_count > CONFIG_IOB_THROTTLE)
+            {
+              g_throttle_count++;
+            }
+#endif
+
+          iob->io_flink   = g_iob_freelist;
+          g_iob_freelist  = iob;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  /* Wake up the waiters after leaving the critical section */
+
+  while (npost-- > 0)
+    {
+      nxsem_post(&g_iob_sem);
+    }
+
+#if CONFIG_IOB_THROTTLE > 0
+  while (nthrottle-- > 0)
+    {
+      nxsem_post(&g_throttle_sem);
+    }
+#endif
+
+  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
+
+#if CONFIG_IOB_THROTTLE > 0
+  DEBUGASSERT(g_throttle_count <=
+              (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
+#endif
+
+  iob_free_signal();
+}
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -79,10 +218,6 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
-#ifdef CONFIG_IOB_NOTIFIER
-  int16_t navail;
-#endif
 
   iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
           iob, iob->io_pktlen, iob->io_len, next);
@@ -126,89 +261,18 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
     }
 #endif
 
-  /* Free the I/O buffer by adding it to the head of the free or the
-   * committed list. We don't know what context we are called from so
-   * we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
-   */
-
-  flags = spin_lock_irqsave(&g_iob_lock);
-
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()). This is true for both throttled and non-throttled
-   * cases.
-   */
+#ifdef CONFIG_IOB_CACHE
+  /* Try to keep the I/O buffer in the cache of this CPU */
 
-#if CONFIG_IOB_THROTTLE > 0
-  if ((g_iob_count < 0) ||
-      ((g_iob_count >= CONFIG_IOB_THROTTLE) &&
-       (g_throttle_count < 0)))
-#else
-  if (g_iob_count < 0)
-#endif
+  if (iob_cache_free(iob))
     {
-      FAR sem_t *sem;
-
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-
-#if CONFIG_IOB_THROTTLE > 0
-      if (g_iob_count < 0)
-        {
-          g_iob_count++;
-          sem = &g_iob_sem;
-        }
-      else
-        {
-          g_throttle_count++;
-          sem = &g_throttle_sem;
-        }
-#else
-      g_iob_count++;
-      sem = &g_iob_sem;
-#endif
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(sem);
-    }
-  else
-    {
-      g_iob_count++;
-#if CONFIG_IOB_THROTTLE > 0
-      if (g_iob_count > CONFIG_IOB_THROTTLE)
-        {
-          g_throttle_count++;
-        }
-#endif
-
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
+      iob_free_signal();
+      return next;
     }
-
-  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
-
-#if CONFIG_IOB_THROTTLE > 0
-  DEBUGASSERT(g_throttle_count <=
-              (CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE));
 #endif
 
-#ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
-   */
-
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
-    {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
-       */
-
-      iob_notifier_signal();
-    }
-#endif
+  iob->io_flink = NULL;
+  iob_free_pool(iob);
 
   /* And return the I/O buffer after the one that was freed */
 
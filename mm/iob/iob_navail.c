@@ -60,6 +60,17 @@ int iob_navail(bool throttled)
     }
 #endif
 
+#ifdef CONFIG_IOB_CACHE
+  /* The buffers in the per-CPU caches are available to the non-throttled
+   * allocations.
+   */
+
+  if (!throttled)
+    {
+      ret += iob_cache_navail();
+    }
+#endif
+
   if (ret < 0)
     {
       ret = 0;
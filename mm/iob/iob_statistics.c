@@ -78,6 +78,10 @@ void iob_getstats(FAR struct iob_stats_s *stats)
     {
       stats->nthrottle = 0;
     }
+
+#ifdef CONFIG_IOB_CACHE
+  iob_cache_getstats(stats);
+#endif
 }
 
 #endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
@@ -71,6 +71,21 @@
 #  define MM_MAX_SHIFT    (22)  /*  4 Mb */
 #endif
 
+/* Heap arenas are private sub-heaps of one public heap, the public heap
+ * holds the procfs controls shared by all of its arenas.
+ */
+
+#if CONFIG_MM_HEAP_ARENAS > 1
+#  define MM_ARENA_PARENT(heap) \
+     ((heap)->mm_parent != NULL ? (heap)->mm_parent : (heap))
+#else
+#  define MM_ARENA_PARENT(heap) (heap)
+#endif
+
+/* The smallest memory slice that is worth turning into an arena */
+
+#define MM_ARENA_MINSIZE (sizeof(struct mm_heap_s) + 64 * MM_MIN_CHUNK)
+
 #if CONFIG_MM_BACKTRACE == 0
 #  define MM_ADD_BACKTRACE(heap, ptr) \
      do \
@@ -88,7 +103,8 @@
          FAR struct tcb_s *tcb; \
          tmp->pid = _SCHED_GETTID(); \
          tcb = nxsched_get_tcb(tmp->pid); \
-         if ((heap)->mm_procfs.backtrace || (tcb && tcb->flags & TCB_FLAG_HEAP_DUMP)) \
+         if (MM_ARENA_PARENT(heap)->mm_procfs.backtrace || \
+             (tcb && tcb->flags & TCB_FLAG_HEAP_DUMP)) \
            { \
              int n = sched_backtrace(tmp->pid, tmp->backtrace, CONFIG_MM_BACKTRACE, \
                                      CONFIG_MM_BACKTRACE_SKIP); \
@@ -271,6 +287,17 @@ struct mm_heap_s
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
   struct procfs_meminfo_entry_s mm_procfs;
 #endif
+
+  /* The heap may be split into independently locked arenas. The public
+   * heap then only dispatches requests, and each arena is a complete heap
+   * instance that points back to its public heap through mm_parent.
+   */
+
+#if CONFIG_MM_HEAP_ARENAS > 1
+  int                   mm_narenas;
+  FAR struct mm_heap_s *mm_parent;
+  FAR struct mm_heap_s **mm_arenas; /* Only set in the parent heap */
+#endif
 };
 
 /* This describes the callback for mm_foreach */
@@ -301,6 +328,18 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
 
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
 
+/* Functions contained in mm_arena.c ****************************************/
+
+#if CONFIG_MM_HEAP_ARENAS > 1
+FAR struct mm_heap_s *mm_arena_owner(FAR struct mm_heap_s *heap,
+                                     FAR void *mem);
+FAR void *mm_arena_memalign(FAR struct mm_heap_s *heap, size_t alignment,
+                            size_t size);
+FAR void *mm_arena_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
+                           size_t size);
+struct mallinfo mm_arena_mallinfo(FAR struct mm_heap_s *heap);
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -0,0 +1,224 @@
+/****************************************************************************
+ * mm/mm_heap/mm_arena.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_arena_index
+ *
+ * Description:
+ *   Return the index of the arena that the caller should allocate from
+ *   first.  Either the current CPU or the current thread selects the
+ *   arena, so that concurrent allocations mostly land on different locks.
+ *
+ ****************************************************************************/
+
+static int mm_arena_index(FAR struct mm_heap_s *heap)
+{
+#ifdef CONFIG_MM_HEAP_ARENA_PERCPU
+  return this_cpu() % heap->mm_narenas;
+#else
+  pid_t tid = _SCHED_GETTID();
+
+  return tid < 0 ? 0 : tid % heap->mm_narenas;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_arena_owner
+ *
+ * Description:
+ *   Return the arena that the memory was allocated from, or NULL if the
+ *   memory does not belong to any arena of the heap.
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *mm_arena_owner(FAR struct mm_heap_s *heap,
+                                     FAR void *mem)
+{
+  int i;
+
+  for (i = 0; i < heap->mm_narenas; i++)
+    {
+      if (mm_heapmember(heap->mm_arenas[i], mem))
+        {
+          return heap->mm_arenas[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: mm_arena_memalign
+ *
+ * Description:
+ *   Allocate from the preferred arena of the caller, and fall back to the
+ *   other arenas in turn if the preferred one is exhausted.  Zero alignment
+ *   requests the natural malloc alignment.
+ *
+ ****************************************************************************/
+
+FAR void *mm_arena_memalign(FAR struct mm_heap_s *heap, size_t alignment,
+                            size_t size)
+{
+  FAR struct mm_heap_s *arena;
+  FAR void *ret = NULL;
+  int index;
+  int i;
+
+  index = mm_arena_index(heap);
+  for (i = 0; i < heap->mm_narenas && ret == NULL; i++)
+    {
+      arena = heap->mm_arenas[(index + i) % heap->mm_narenas];
+      if (alignment > 0)
+        {
+          ret = mm_memalign(arena, alignment, size);
+        }
+      else
+        {
+          ret = mm_malloc(arena, size);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_arena_realloc
+ *
+ * Description:
+ *   Resize the memory inside its owning arena.  If that arena can not hold
+ *   the new size, move the memory to any arena that can.
+ *
+ ****************************************************************************/
+
+FAR void *mm_arena_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
+                           size_t size)
+{
+  FAR struct mm_heap_s *arena;
+  FAR void *newmem;
+
+  arena = mm_arena_owner(heap, oldmem);
+  DEBUGASSERT(arena != NULL);
+
+  newmem = mm_realloc(arena, oldmem, size);
+  if (newmem == NULL && size > 0)
+    {
+      newmem = mm_arena_memalign(heap, 0, size);
+      if (newmem != NULL)
+        {
+          memcpy(newmem, oldmem,
+                 MIN(size, mm_malloc_size(arena, oldmem)));
+          mm_free(arena, oldmem);
+        }
+    }
+
+  return newmem;
+}
+
+/****************************************************************************
+ * Name: mm_arena_mallinfo
+ *
+ * Description:
+ *   Return the heap information accumulated over all arenas.
+ *
+ ****************************************************************************/
+
+struct mallinfo mm_arena_mallinfo(FAR struct mm_heap_s *heap)
+{
+  struct mallinfo info;
+  struct mallinfo tmp;
+  int i;
+
+  memset(&info, 0, sizeof(info));
+  for (i = 0; i < heap->mm_narenas; i++)
+    {
+      tmp = mm_mallinfo(heap->mm_arenas[i]);
+      info.arena    += tmp.arena;
+      info.ordblks  += tmp.ordblks;
+      info.aordblks += tmp.aordblks;
+      info.uordblks += tmp.uordblks;
+      info.fordblks += tmp.fordblks;
+      info.usmblks  += tmp.usmblks;
+      if (tmp.mxordblk > info.mxordblk)
+        {
+          info.mxordblk = tmp.mxordblk;
+        }
+    }
+
+  info.arena    += sizeof(struct mm_heap_s);
+  info.uordblks += sizeof(struct mm_heap_s);
+  info.usmblks  += sizeof(struct mm_heap_s);
+  return info;
+}
+
+/****************************************************************************
+ * Name: mm_mallinfo_arena
+ *
+ * Description:
+ *   Return the heap information of one arena of the heap.
+ *
+ * Input Parameters:
+ *   heap  - The heap split into arenas
+ *   arena - The index of the arena
+ *   info  - The location to return the arena information
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if the heap has no such arena.
+ *
+ ****************************************************************************/
+
+int mm_mallinfo_arena(FAR struct mm_heap_s *heap, int arena,
+                      FAR struct mallinfo *info)
+{
+  if (arena < 0 || arena >= heap->mm_narenas)
+    {
+      return -ENOENT;
+    }
+
+  *info = mm_mallinfo(heap->mm_arenas[arena]);
+  return OK;
+}
@@ -49,6 +49,15 @@ FAR void *mm_brkaddr(FAR struct mm_heap_s *heap, int region)
 {
   uintptr_t brkaddr;
 
+#if CONFIG_MM_HEAP_ARENAS > 1
+  /* The last arena receives a part of every region */
+
+  if (heap->mm_narenas > 0)
+    {
+      return mm_brkaddr(heap->mm_arenas[heap->mm_narenas - 1], region);
+    }
+#endif
+
 #if CONFIG_MM_REGIONS > 1
   DEBUGASSERT(heap && region < heap->mm_nregions);
 #else
@@ -62,6 +62,17 @@ void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
   /* Make sure that we were passed valid parameters */
 
   DEBUGASSERT(heap && mem);
+
+#if CONFIG_MM_HEAP_ARENAS > 1
+  /* The last arena holds the end of every region */
+
+  if (heap->mm_narenas > 0)
+    {
+      mm_extend(heap->mm_arenas[heap->mm_narenas - 1], mem, size, region);
+      return;
+    }
+#endif
+
 #if CONFIG_MM_REGIONS > 1
   DEBUGASSERT(size >= MIN_EXTEND && region >= 0 &&
               region < heap->mm_nregions);
@@ -59,6 +59,20 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
 
   DEBUGASSERT(handler);
 
+#if CONFIG_MM_HEAP_ARENAS > 1
+  if (heap->mm_narenas > 0)
+    {
+      int i;
+
+      for (i = 0; i < heap->mm_narenas; i++)
+        {
+          mm_foreach(heap->mm_arenas[i], handler, arg);
+        }
+
+      return;
+    }
+#endif
+
   /* Visit each region */
 
 #if CONFIG_MM_REGIONS > 1
@@ -252,5 +252,17 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
     }
 #endif
 
+#if CONFIG_MM_HEAP_ARENAS > 1
+  /* Route the memory back to the arena it was allocated from, no matter
+   * which CPU or thread releases it.
+   */
+
+  if (heap->mm_narenas > 0)
+    {
+      heap = mm_arena_owner(heap, mem);
+      DEBUGASSERT(heap != NULL);
+    }
+#endif
+
   mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
 }
@@ -58,6 +58,14 @@
 bool mm_heapmember(FAR struct mm_heap_s *heap, FAR void *mem)
 {
   mem = kasan_reset_tag(mem);
+
+#if CONFIG_MM_HEAP_ARENAS > 1
+  if (heap->mm_narenas > 0)
+    {
+      return mm_arena_owner(heap, mem) != NULL;
+    }
+#endif
+
 #if CONFIG_MM_REGIONS > 1
   int i;
 
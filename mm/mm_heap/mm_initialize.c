@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <string.h>
+#include <sys/param.h>
 #include <assert.h>
 #include <debug.h>
 
@@ -78,6 +79,159 @@ static FAR void *mempool_memalign(FAR void *arg, size_t alignment,
 #  define mempool_memalign mm_memalign
 #endif
 
+/****************************************************************************
+ * Name: mm_initialize_heap
+ *
+ * Description:
+ *   Carve a heap instance from the beginning of the memory and initialize
+ *   it, the remaining memory is returned through heapstart and heapsize.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_heap_s *mm_initialize_heap(FAR const char *name,
+                                                FAR void **heapstart,
+                                                FAR size_t *heapsize)
+{
+  FAR struct mm_heap_s *heap;
+  uintptr_t             heap_adj;
+  int                   i;
+
+  /* First ensure the memory to be used is aligned */
+
+  heap_adj   = MM_ALIGN_UP((uintptr_t)*heapstart);
+  *heapsize -= heap_adj - (uintptr_t)*heapstart;
+
+  /* Reserve a block space for mm_heap_s context */
+
+  DEBUGASSERT(*heapsize > sizeof(struct mm_heap_s));
+  heap = (FAR struct mm_heap_s *)heap_adj;
+  *heapsize -= sizeof(struct mm_heap_s);
+  *heapstart = (FAR char *)heap_adj + sizeof(struct mm_heap_s);
+
+  DEBUGASSERT(MM_MIN_CHUNK >= MM_SIZEOF_ALLOCNODE);
+
+  /* Set up global variables */
+
+  memset(heap, 0, sizeof(struct mm_heap_s));
+
+  /* Initialize the node array */
+
+  for (i = 1; i < MM_NNODES; i++)
+    {
+      heap->mm_nodelist[i - 1].flink = &heap->mm_nodelist[i];
+      heap->mm_nodelist[i].blink     = &heap->mm_nodelist[i - 1];
+    }
+
+  /* Initialize the malloc mutex to one (to support one-at-
+   * a-time access to private data sets).
+   */
+
+  nxmutex_init(&heap->mm_lock);
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+#  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  heap->mm_procfs.name = name;
+  heap->mm_procfs.heap = heap;
+#    ifdef CONFIG_MM_BACKTRACE_DEFAULT
+  heap->mm_procfs.backtrace = true;
+#    endif
+#  endif
+#endif
+
+  heap->mm_curused = sizeof(struct mm_heap_s);
+  return heap;
+}
+
+#if CONFIG_MM_HEAP_ARENAS > 1
+
+/****************************************************************************
+ * Name: mm_initialize_arenas
+ *
+ * Description:
+ *   Split the initial heap region into CONFIG_MM_HEAP_ARENAS equal slices
+ *   and turn every slice into an independently locked arena.  The heap is
+ *   left as a plain heap if the region is too small to be split.
+ *
+ ****************************************************************************/
+
+static void mm_initialize_arenas(FAR struct mm_heap_s *heap,
+                                 FAR const char *name,
+                                 FAR void *heapstart, size_t heapsize)
+{
+  FAR struct mm_heap_s *arena;
+  FAR void *slicestart;
+  size_t slicesize;
+  size_t size;
+  int narenas;
+  int i;
+
+  narenas = MIN(CONFIG_MM_HEAP_ARENAS, heapsize / MM_ARENA_MINSIZE);
+  if (narenas < 2)
+    {
+      mm_addregion(heap, heapstart, heapsize);
+      return;
+    }
+
+  /* Only the parent heap needs the table of its arenas, take it from the
+   * front of the region.
+   */
+
+  size = MM_ALIGN_UP(narenas * sizeof(FAR struct mm_heap_s *));
+  heap->mm_arenas   = heapstart;
+  heap->mm_curused += size;
+  heapstart         = (FAR char *)heapstart + size;
+  heapsize         -= size;
+
+  slicesize = MM_ALIGN_DOWN(heapsize / narenas);
+  for (i = 0; i < narenas; i++)
+    {
+      slicestart = (FAR char *)heapstart + i * slicesize;
+      size       = i < narenas - 1 ? slicesize : heapsize - i * slicesize;
+
+      arena = mm_initialize_heap(name, &slicestart, &size);
+      arena->mm_parent = heap;
+      mm_addregion(arena, slicestart, size);
+
+      heap->mm_arenas[i] = arena;
+    }
+
+  heap->mm_narenas = narenas;
+}
+
+/****************************************************************************
+ * Name: mm_addregion_arenas
+ *
+ * Description:
+ *   Share a new region between all arenas.  A region too small to be split
+ *   goes to the last arena, which therefore owns the end of every region.
+ *
+ ****************************************************************************/
+
+static void mm_addregion_arenas(FAR struct mm_heap_s *heap,
+                                FAR void *heapstart, size_t heapsize)
+{
+  size_t slicesize;
+  int i;
+
+  slicesize = MM_ALIGN_DOWN(heapsize / heap->mm_narenas);
+  if (slicesize < MM_ARENA_MINSIZE)
+    {
+      mm_addregion(heap->mm_arenas[heap->mm_narenas - 1],
+                   heapstart, heapsize);
+      return;
+    }
+
+  for (i = 0; i < heap->mm_narenas - 1; i++)
+    {
+      mm_addregion(heap->mm_arenas[i], heapstart, slicesize);
+      heapstart = (FAR char *)heapstart + slicesize;
+      heapsize -= slicesize;
+    }
+
+  mm_addregion(heap->mm_arenas[i], heapstart, heapsize);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -108,7 +262,17 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   uintptr_t heapend;
 #if CONFIG_MM_REGIONS > 1
   int idx;
+#endif
+
+#if CONFIG_MM_HEAP_ARENAS > 1
+  if (heap->mm_narenas > 0)
+    {
+      mm_addregion_arenas(heap, heapstart, heapsize);
+      return;
+    }
+#endif
 
+#if CONFIG_MM_REGIONS > 1
   DEBUGVERIFY(mm_lock(heap));
   idx = heap->mm_nregions;
 
@@ -234,57 +398,18 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
                                     FAR void *heapstart, size_t heapsize)
 {
   FAR struct mm_heap_s *heap;
-  uintptr_t             heap_adj;
-  int                   i;
 
   minfo("Heap: name=%s, start=%p size=%zu\n", name, heapstart, heapsize);
 
-  /* First ensure the memory to be used is aligned */
-
-  heap_adj  = MM_ALIGN_UP((uintptr_t)heapstart);
-  heapsize -= heap_adj - (uintptr_t)heapstart;
-
-  /* Reserve a block space for mm_heap_s context */
-
-  DEBUGASSERT(heapsize > sizeof(struct mm_heap_s));
-  heap = (FAR struct mm_heap_s *)heap_adj;
-  heapsize -= sizeof(struct mm_heap_s);
-  heapstart = (FAR char *)heap_adj + sizeof(struct mm_heap_s);
-
-  DEBUGASSERT(MM_MIN_CHUNK >= MM_SIZEOF_ALLOCNODE);
-
-  /* Set up global variables */
-
-  memset(heap, 0, sizeof(struct mm_heap_s));
-
-  /* Initialize the node array */
-
-  for (i = 1; i < MM_NNODES; i++)
-    {
-      heap->mm_nodelist[i - 1].flink = &heap->mm_nodelist[i];
-      heap->mm_nodelist[i].blink     = &heap->mm_nodelist[i - 1];
-    }
-
-  /* Initialize the malloc mutex to one (to support one-at-
-   * a-time access to private data sets).
-   */
-
-  nxmutex_init(&heap->mm_lock);
-
-#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
-#  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
-  heap->mm_procfs.name = name;
-  heap->mm_procfs.heap = heap;
-#    ifdef CONFIG_MM_BACKTRACE_DEFAULT
-  heap->mm_procfs.backtrace = true;
-#    endif
-#  endif
-#endif
+  heap = mm_initialize_heap(name, &heapstart, &heapsize);
 
   /* Add the initial region of memory to the heap */
 
-  heap->mm_curused = sizeof(struct mm_heap_s);
+#if CONFIG_MM_HEAP_ARENAS > 1
+  mm_initialize_arenas(heap, name, heapstart, heapsize);
+#else
   mm_addregion(heap, heapstart, heapsize);
+#endif
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
 #  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
@@ -375,6 +500,13 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
   mempool_multiple_deinit(heap->mm_mpool);
 #endif
 
+#if CONFIG_MM_HEAP_ARENAS > 1
+  for (i = 0; i < heap->mm_narenas; i++)
+    {
+      mm_uninitialize(heap->mm_arenas[i]);
+    }
+#endif
+
   for (i = 0; i < CONFIG_MM_REGIONS; i++)
     {
       kasan_unregister(heap->mm_heapstart[i]);
@@ -385,8 +517,16 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
 #  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
-  procfs_unregister_meminfo(&heap->mm_procfs);
+#    if CONFIG_MM_HEAP_ARENAS > 1
+  /* Only the parent heap is registered */
+
+  if (heap->mm_parent == NULL)
+#    endif
+    {
+      procfs_unregister_meminfo(&heap->mm_procfs);
+    }
 #  endif
 #endif
+
   nxmutex_destroy(&heap->mm_lock);
 }
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <assert.h>
 #include <debug.h>
 
@@ -133,11 +134,20 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
 #endif
 
   memset(&info, 0, sizeof(info));
-  mm_foreach(heap, mallinfo_handler, &info);
-  info.arena = heap->mm_heapsize;
-  info.arena += sizeof(struct mm_heap_s);
-  info.uordblks += sizeof(struct mm_heap_s);
-  info.usmblks = heap->mm_maxused + sizeof(struct mm_heap_s);
+#if CONFIG_MM_HEAP_ARENAS > 1
+  if (heap->mm_narenas > 0)
+    {
+      info = mm_arena_mallinfo(heap);
+    }
+  else
+#endif
+    {
+      mm_foreach(heap, mallinfo_handler, &info);
+      info.arena = heap->mm_heapsize;
+      info.arena += sizeof(struct mm_heap_s);
+      info.uordblks += sizeof(struct mm_heap_s);
+      info.usmblks = heap->mm_maxused + sizeof(struct mm_heap_s);
+    }
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   poolinfo = mempool_multiple_mallinfo(heap->mm_mpool);
@@ -190,6 +200,21 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
 
 size_t mm_heapfree(FAR struct mm_heap_s *heap)
 {
+#if CONFIG_MM_HEAP_ARENAS > 1
+  if (heap->mm_narenas > 0)
+    {
+      size_t size = 0;
+      int i;
+
+      for (i = 0; i < heap->mm_narenas; i++)
+        {
+          size += mm_heapfree(heap->mm_arenas[i]);
+        }
+
+      return size;
+    }
+#endif
+
   return heap->mm_heapsize - heap->mm_curused;
 }
 
@@ -204,6 +229,22 @@ size_t mm_heapfree(FAR struct mm_heap_s *heap)
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
 {
   FAR struct mm_freenode_s *node;
+
+#if CONFIG_MM_HEAP_ARENAS > 1
+  if (heap->mm_narenas > 0)
+    {
+      size_t largest = 0;
+      int i;
+
+      for (i = 0; i < heap->mm_narenas; i++)
+        {
+          largest = MAX(largest, mm_heapfree_largest(heap->mm_arenas[i]));
+        }
+
+      return largest;
+    }
+#endif
+
   for (node = heap->mm_nodelist[MM_NNODES - 1].blink; node;
        node = node->blink)
     {
@@ -152,6 +152,15 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap)
 {
   if (heap)
     {
+#if CONFIG_MM_HEAP_ARENAS > 1
+      int i;
+
+      for (i = 0; i < heap->mm_narenas; i++)
+        {
+          free_delaylist(heap->mm_arenas[i], true);
+        }
+#endif
+
        free_delaylist(heap, true);
     }
 }
@@ -190,6 +199,13 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+#if CONFIG_MM_HEAP_ARENAS > 1
+  if (heap->mm_narenas > 0)
+    {
+      return mm_arena_memalign(heap, 0, size);
+    }
+#endif
+
   /* Adjust the size to account for (1) the size of the allocated node and
    * (2) to make sure that it is aligned with MM_ALIGN and its size is at
    * least MM_MIN_CHUNK.
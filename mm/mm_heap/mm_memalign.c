@@ -87,6 +87,13 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
     }
 #endif
 
+#if CONFIG_MM_HEAP_ARENAS > 1
+  if (heap->mm_narenas > 0)
+    {
+      return mm_arena_memalign(heap, alignment, size);
+    }
+#endif
+
   /* If this requested alinement's less than or equal to the natural
    * alignment of malloc, then just let malloc do the work.
    */
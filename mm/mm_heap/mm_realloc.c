@@ -110,6 +110,13 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
     }
 #endif
 
+#if CONFIG_MM_HEAP_ARENAS > 1
+  if (heap->mm_narenas > 0)
+    {
+      return mm_arena_realloc(heap, oldmem, size);
+    }
+#endif
+
   /* Adjust the size to account for (1) the size of the allocated node and
    * (2) to make sure that it is aligned with MM_ALIGN and its size is at
    * least MM_MIN_CHUNK.
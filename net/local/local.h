@@ -51,6 +51,16 @@
 #define LOCAL_NPOLLWAITERS 2
 #define LOCAL_NCONTROLFDS  4
 
+/* Without a lock of their own, the local sockets are protected by the
+ * network lock.
+ */
+
+#ifndef CONFIG_NET_LOCAL_LOCK
+#  define local_lock()      net_lock()
+#  define local_unlock()    net_unlock()
+#  define local_sem_wait(s) net_sem_wait(s)
+#endif
+
 #if CONFIG_DEV_PIPE_MAXSIZE > 65535
 typedef uint32_t lc_size_t;  /* 32-bit index */
 #elif CONFIG_DEV_PIPE_MAXSIZE > 255
@@ -204,6 +214,42 @@ EXTERN const struct sock_intf_s g_local_sockif;
 struct sockaddr; /* Forward reference */
 struct socket;   /* Forward reference */
 
+#ifdef CONFIG_NET_LOCAL_LOCK
+
+/****************************************************************************
+ * Name: local_lock
+ *
+ * Description:
+ *   Take the lock protecting all the local connections.  This lock is
+ *   separate from the network lock, so the local sockets do not contend
+ *   with the network devices and the IP stack.
+ *
+ ****************************************************************************/
+
+int local_lock(void);
+
+/****************************************************************************
+ * Name: local_unlock
+ *
+ * Description:
+ *   Release the local socket lock.
+ *
+ ****************************************************************************/
+
+void local_unlock(void);
+
+/****************************************************************************
+ * Name: local_sem_wait
+ *
+ * Description:
+ *   Wait for sem while temporarily releasing the local socket lock, the
+ *   counterpart of net_sem_wait().
+ *
+ ****************************************************************************/
+
+int local_sem_wait(FAR sem_t *sem);
+#endif
+
 /****************************************************************************
  * Name: local_alloc
  *
@@ -31,12 +31,14 @@
 #include <errno.h>
 #include <debug.h>
 #include <unistd.h>
+#include <limits.h>
 
 #include <nuttx/sched.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/queue.h>
 
 #include "local/local.h"
+#include "utils/utils.h"
 
 /****************************************************************************
  * Private Data
@@ -46,10 +48,58 @@
 
 static dq_queue_t g_local_connections;
 
+#ifdef CONFIG_NET_LOCAL_LOCK
+/* The lock protecting all the local connections */
+
+static rmutex_t g_local_lock = NXRMUTEX_INITIALIZER;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_LOCAL_LOCK
+
+/****************************************************************************
+ * Name: local_lock
+ *
+ * Description:
+ *   Take the lock protecting all the local connections.
+ *
+ ****************************************************************************/
+
+int local_lock(void)
+{
+  return nxrmutex_lock(&g_local_lock);
+}
+
+/****************************************************************************
+ * Name: local_unlock
+ *
+ * Description:
+ *   Release the local socket lock.
+ *
+ ****************************************************************************/
+
+void local_unlock(void)
+{
+  nxrmutex_unlock(&g_local_lock);
+}
+
+/****************************************************************************
+ * Name: local_sem_wait
+ *
+ * Description:
+ *   Wait for sem while temporarily releasing the local socket lock.
+ *
+ ****************************************************************************/
+
+int local_sem_wait(FAR sem_t *sem)
+{
+  return net_rmutex_sem_timedwait(&g_local_lock, sem, UINT_MAX);
+}
+#endif /* CONFIG_NET_LOCAL_LOCK */
+
 /****************************************************************************
  * Name: local_nextconn
  *
@@ -57,7 +107,7 @@ static dq_queue_t g_local_connections;
  *   Traverse the list of local connections
  *
  * Assumptions:
- *   This function must be called with the network locked.
+ *   This function must be called with the local socket locked.
  *
  ****************************************************************************/
 
@@ -78,7 +128,7 @@ FAR struct local_conn_s *local_nextconn(FAR struct local_conn_s *conn)
  *   Traverse the connections list to find the local connection
  *
  * Assumptions:
- *   This function must be called with the network locked.
+ *   This function must be called with the local socket locked.
  *
  ****************************************************************************/
 
@@ -110,7 +160,7 @@ local_findconn(FAR const struct local_conn_s *local_conn,
  *   Traverse the connections list to find the peer
  *
  * Assumptions:
- *   This function must be called with the network locked.
+ *   This function must be called with the local socket locked.
  *
  ****************************************************************************/
 
@@ -139,7 +189,7 @@ FAR struct local_conn_s *local_peerconn(FAR struct local_conn_s *conn)
  *   API
  *
  * Assumptions:
- *   This function must be called with the network locked.
+ *   This function must be called with the local socket locked.
  *
  ****************************************************************************/
 
@@ -192,7 +242,7 @@ FAR struct local_conn_s *local_alloc(void)
  *    a new connection and initialize it.
  *
  * Assumptions:
- *   This function must be called with the network locked.
+ *   This function must be called with the local socket locked.
  *
  ****************************************************************************/
 
@@ -284,7 +334,7 @@ err:
  *   This should be done by the implementation of close().
  *
  * Assumptions:
- *   This function must be called with the network locked.
+ *   This function must be called with the local socket locked.
  *
  ****************************************************************************/
 
@@ -39,6 +39,30 @@
 #  include <nuttx/wqueue.h>
 #endif
 
+#ifdef CONFIG_RCU
+#  include <nuttx/rcu.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The lookups which only walk g_netdevices are read-side critical sections
+ * if RCU is enabled, the changes of the list still hold the network lock.
+ */
+
+#ifdef CONFIG_RCU
+#  define netdev_list_lock()    rcu_read_lock()
+#  define netdev_list_unlock()  rcu_read_unlock()
+#  define netdev_list_get(p)    rcu_dereference(p)
+#  define netdev_list_set(p, v) rcu_assign_pointer(p, v)
+#else
+#  define netdev_list_lock()    net_lock()
+#  define netdev_list_unlock()  net_unlock()
+#  define netdev_list_get(p)    (p)
+#  define netdev_list_set(p, v) ((p) = (v))
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -53,7 +77,8 @@ extern "C"
 #endif
 
 /* List of registered Ethernet device drivers.  You must have the network
- * locked in order to access this list.
+ * locked in order to access this list, or be in netdev_list_lock() to
+ * walk it.
  *
  * NOTE that this duplicates a declaration in net/tcp/tcp.h
  */
@@ -1229,6 +1229,20 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
         break;
 #endif
 
+#ifdef CONFIG_NETDEV_IOCTL
+      case SIOCETHTOOL:  /* Ethtool interface */
+        if (dev->d_ioctl)
+          {
+            ret = dev->d_ioctl(dev, cmd,
+                               (unsigned long)(uintptr_t)req->ifr_data);
+          }
+        else
+          {
+            ret = -ENOSYS;
+          }
+        break;
+#endif
+
 #ifdef CONFIG_NETDEV_IFINDEX
       case SIOCGIFINDEX:  /* Index to name mapping */
         req->ifr_ifindex = dev->d_ifindex;
@@ -454,7 +454,9 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
 
       snprintf(dev->d_ifname, IFNAMSIZ, devfmt, devnum);
 
-      /* Add the device to the list of known network devices */
+      /* Add the device to the list of known network devices.  The device
+       * is complete before it is published to the lockless lookups.
+       */
 
       last = &g_netdevices;
       while (*last)
@@ -462,9 +464,8 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
           last = &((*last)->flink);
         }
 
-      *last = dev;
-
       dev->flink = NULL;
+      netdev_list_set(*last, dev);
 
 #ifdef CONFIG_NET_IGMP
       /* Configure the device for IGMP support */
@@ -135,16 +135,14 @@ int netdev_unregister(FAR struct net_driver_s *dev)
             {
               /* The entry was in the middle or at the end of the list */
 
-              prev->flink = curr->flink;
+              netdev_list_set(prev->flink, curr->flink);
             }
           else
             {
               /* The entry was at the beginning of the list */
 
-              g_netdevices = curr->flink;
+              netdev_list_set(g_netdevices, curr->flink);
             }
-
-          curr->flink = NULL;
         }
 
 #ifdef CONFIG_NETDEV_IFINDEX
@@ -152,6 +150,18 @@ int netdev_unregister(FAR struct net_driver_s *dev)
 #endif
       net_unlock();
 
+      if (curr)
+        {
+#ifdef CONFIG_RCU
+          /* A lookup may still walk through the device, wait for it before
+           * the device can be freed.
+           */
+
+          synchronize_rcu();
+#endif
+          curr->flink = NULL;
+        }
+
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
       work_cancel_sync(NETDEV_STATISTICS_WORK, &dev->d_statistics.logwork);
 #endif
@@ -81,6 +81,10 @@ static int netprocfs_txstatistics_header(
     FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_errors(FAR struct netprocfs_file_s *netfile);
+#ifdef CONFIG_NETDEV_RSS
+static int netprocfs_queues_header(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_queues(FAR struct netprocfs_file_s *netfile);
+#endif
 #endif /* CONFIG_NETDEV_STATISTICS */
 
 /****************************************************************************
@@ -116,6 +120,10 @@ static const linegen_t g_netstat_linegen[] =
   netprocfs_rxpackets,
   netprocfs_txstatistics_header,
   netprocfs_txstatistics,
+#ifdef CONFIG_NETDEV_RSS
+  netprocfs_queues_header,
+  netprocfs_queues,
+#endif
   netprocfs_errors
 #endif /* CONFIG_NETDEV_STATISTICS */
 };
@@ -558,6 +566,62 @@ static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
+/****************************************************************************
+ * Name: netprocfs_queues_header
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_RSS)
+static int netprocfs_queues_header(FAR struct netprocfs_file_s *netfile)
+{
+  DEBUGASSERT(netfile != NULL);
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\tQueues: %s\n", "RX/Steered/TX");
+}
+#endif
+
+/****************************************************************************
+ * Name: netprocfs_queues
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_RSS)
+static int netprocfs_queues(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct netdev_queue_statistics_s *queue;
+  FAR struct net_driver_s *dev;
+  int len;
+  int ret;
+  int i;
+
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+  dev = netfile->dev;
+
+  len = snprintf(netfile->line, NET_LINELEN, "\t   ");
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      queue = &dev->d_statistics.queues[i];
+      ret   = snprintf(&netfile->line[len], NET_LINELEN - 1 - len,
+                       " %d:%lx/%lx/%lx", i,
+                       (unsigned long)queue->rx_packets,
+                       (unsigned long)queue->rx_steered,
+                       (unsigned long)queue->tx_packets);
+      if (ret >= NET_LINELEN - 1 - len)
+        {
+          /* No more room, the remaining queues are truncated */
+
+          len = NET_LINELEN - 2;
+          break;
+        }
+
+      len += ret;
+    }
+
+  netfile->line[len++] = '\n';
+  netfile->line[len]   = '\0';
+  return len;
+}
+#endif
+
 /****************************************************************************
  * Name: netprocfs_errors
  ****************************************************************************/
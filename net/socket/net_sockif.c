@@ -136,3 +136,57 @@ net_sockif(sa_family_t family, int type, int protocol)
 
   return sockif;
 }
+
+#ifdef CONFIG_NET_LOCAL_LOCK
+
+/****************************************************************************
+ * Name: psock_lock
+ *
+ * Description:
+ *   Take the lock protecting the connection of the socket.
+ *
+ * Input Parameters:
+ *   psock - The socket whose connection is to be accessed.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure (probably -ECANCELED).
+ *
+ ****************************************************************************/
+
+int psock_lock(FAR struct socket *psock)
+{
+  if (psock->s_domain == PF_LOCAL)
+    {
+      return local_lock();
+    }
+
+  return net_lock();
+}
+
+/****************************************************************************
+ * Name: psock_unlock
+ *
+ * Description:
+ *   Release the lock taken by psock_lock().
+ *
+ * Input Parameters:
+ *   psock - The socket whose connection was accessed.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void psock_unlock(FAR struct socket *psock)
+{
+  if (psock->s_domain == PF_LOCAL)
+    {
+      local_unlock();
+    }
+  else
+    {
+      net_unlock();
+    }
+}
+#endif /* CONFIG_NET_LOCAL_LOCK */
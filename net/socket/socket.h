@@ -123,6 +123,24 @@
 #  define _SO_SETERRNO(s,e)
 #endif /* CONFIG_NET_SOCKOPTS */
 
+/* The socket layer takes the lock that protects the connection of the
+ * socket with psock_lock().  Each connection is protected by exactly one
+ * lock, and the locks are taken in this order:
+ *
+ *   1. The local socket lock (net/local), for PF_LOCAL sockets when
+ *      CONFIG_NET_LOCAL_LOCK is enabled.  It is never held together with
+ *      the network lock.
+ *   2. The network lock, for all the other sockets, the network devices
+ *      and the TCP, UDP send and ICMP paths.
+ *   3. The UDP read-ahead lock of a connection, which is the innermost
+ *      lock and may be taken with or without the network lock.
+ */
+
+#ifndef CONFIG_NET_LOCAL_LOCK
+#  define psock_lock(p)   net_lock()
+#  define psock_unlock(p) net_unlock()
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -182,6 +200,27 @@ net_sockif(sa_family_t family, int type, int protocol);
 int net_timeo(clock_t start_time, socktimeo_t timeo);
 #endif
 
+/****************************************************************************
+ * Name: psock_lock and psock_unlock
+ *
+ * Description:
+ *   Take or release the lock protecting the connection of the socket: the
+ *   local socket lock for PF_LOCAL sockets, otherwise the network lock.
+ *
+ * Input Parameters:
+ *   psock - The socket whose connection is accessed.
+ *
+ * Returned Value:
+ *   psock_lock() returns zero (OK) on success; a negated errno value is
+ *   returned on failure (probably -ECANCELED).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_LOCK
+int psock_lock(FAR struct socket *psock);
+void psock_unlock(FAR struct socket *psock);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
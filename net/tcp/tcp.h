@@ -208,6 +208,10 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+#if CONFIG_NET_TCP_CONN_HASHSIZE > 0
+  dq_entry_t hnode;       /* Link in the connection hash table */
+  dq_entry_t pnode;       /* Link in the local port hash table */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
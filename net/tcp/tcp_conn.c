@@ -58,6 +58,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -73,6 +74,17 @@
 #include "netdev/netdev.h"
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_NET_TCP_CONN_HASHSIZE > 0
+#  define TCP_PORT_HASH(p)          ((p) % CONFIG_NET_TCP_CONN_HASHSIZE)
+#  define TCP_CONN_HASH(l, r, a, n) tcp_conn_hash(l, r, a, n)
+#else
+#  define TCP_CONN_HASH(l, r, a, n) 0
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -91,10 +103,160 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+#if CONFIG_NET_TCP_CONN_HASHSIZE > 0
+/* The active TCP connections hashed by their (local port, remote port,
+ * remote address) tuple and by their local port.
+ */
+
+static dq_queue_t g_tcp_conn_hash[CONFIG_NET_TCP_CONN_HASHSIZE];
+static dq_queue_t g_tcp_port_hash[CONFIG_NET_TCP_CONN_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#if CONFIG_NET_TCP_CONN_HASHSIZE > 0
+
+/****************************************************************************
+ * Name: tcp_conn_hash
+ *
+ * Description:
+ *   Return the connection hash table index of the tuple.  The remote
+ *   address is given as an array of 16-bit words in network order.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_conn_hash(uint16_t lport, uint16_t rport,
+                                  FAR const uint16_t *raddr, int nwords)
+{
+  uint32_t hash = ((uint32_t)lport << 16) | rport;
+  int i;
+
+  for (i = 0; i < nwords; i++)
+    {
+      hash = hash * 31 + raddr[i];
+    }
+
+  return (hash ^ (hash >> 16)) % CONFIG_NET_TCP_CONN_HASHSIZE;
+}
+
+/****************************************************************************
+ * Name: tcp_conn_hashkey
+ *
+ * Description:
+ *   Return the connection hash table index of the connection.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_conn_hashkey(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_conn_hash(conn->lport, conn->rport,
+                           (FAR const uint16_t *)&conn->u.ipv4.raddr, 2);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_conn_hash(conn->lport, conn->rport,
+                           conn->u.ipv6.raddr, 8);
+    }
+#endif
+}
+#endif /* CONFIG_NET_TCP_CONN_HASHSIZE > 0 */
+
+/****************************************************************************
+ * Name: tcp_nexthash
+ *
+ * Description:
+ *   Traverse the active TCP connections that may match the tuple hash
+ *   index.  All active connections are visited if the hash tables are
+ *   disabled.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *
+  tcp_nexthash(FAR struct tcp_conn_s *conn, unsigned int hash)
+{
+#if CONFIG_NET_TCP_CONN_HASHSIZE > 0
+  FAR dq_entry_t *node;
+
+  node = conn != NULL ? dq_next(&conn->hnode) :
+                        dq_peek(&g_tcp_conn_hash[hash]);
+  return node != NULL ? container_of(node, struct tcp_conn_s, hnode) : NULL;
+#else
+  return tcp_nextconn(conn);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_nextport
+ *
+ * Description:
+ *   Traverse the active TCP connections that may use the local port.  All
+ *   active connections are visited if the hash tables are disabled.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *
+  tcp_nextport(FAR struct tcp_conn_s *conn, uint16_t portno)
+{
+#if CONFIG_NET_TCP_CONN_HASHSIZE > 0
+  FAR dq_entry_t *node;
+
+  node = conn != NULL ? dq_next(&conn->pnode) :
+                        dq_peek(&g_tcp_port_hash[TCP_PORT_HASH(portno)]);
+  return node != NULL ? container_of(node, struct tcp_conn_s, pnode) : NULL;
+#else
+  return tcp_nextconn(conn);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_active_add
+ *
+ * Description:
+ *   Add the connection to the list (and the hash tables) of active
+ *   connections.  The addresses and ports of the connection must not
+ *   change until it is removed again.
+ *
+ ****************************************************************************/
+
+static void tcp_active_add(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#if CONFIG_NET_TCP_CONN_HASHSIZE > 0
+  dq_addlast(&conn->hnode, &g_tcp_conn_hash[tcp_conn_hashkey(conn)]);
+  dq_addlast(&conn->pnode, &g_tcp_port_hash[TCP_PORT_HASH(conn->lport)]);
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_active_remove
+ *
+ * Description:
+ *   Remove the connection from the list (and the hash tables) of active
+ *   connections.
+ *
+ ****************************************************************************/
+
+static void tcp_active_remove(FAR struct tcp_conn_s *conn)
+{
+  dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#if CONFIG_NET_TCP_CONN_HASHSIZE > 0
+  dq_rem(&conn->hnode, &g_tcp_conn_hash[tcp_conn_hashkey(conn)]);
+  dq_rem(&conn->pnode, &g_tcp_port_hash[TCP_PORT_HASH(conn->lport)]);
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -115,7 +277,7 @@ static FAR struct tcp_conn_s *
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
-  while ((conn = tcp_nextconn(conn)) != NULL)
+  while ((conn = tcp_nextport(conn, portno)) != NULL)
     {
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -188,8 +350,10 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
+  unsigned int hash;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+  hash       = TCP_CONN_HASH(tcp->destport, tcp->srcport, ip->srcipaddr, 2);
+  conn       = tcp_nexthash(NULL, hash);
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
@@ -228,7 +392,7 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+      conn = tcp_nexthash(conn, hash);
     }
 
   return conn;
@@ -255,8 +419,10 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
+  unsigned int hash;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+  hash       = TCP_CONN_HASH(tcp->destport, tcp->srcport, ip->srcipaddr, 8);
+  conn       = tcp_nexthash(NULL, hash);
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
@@ -295,7 +461,7 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+      conn = tcp_nexthash(conn, hash);
     }
 
   return conn;
@@ -922,7 +1088,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
     {
       /* Remove the connection from the active list */
 
-      dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_active_remove(conn);
     }
 
   tcp_free_rx_buffers(conn);
@@ -1231,7 +1397,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        * Interrupts should already be disabled in this context.
        */
 
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_active_add(conn);
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1542,7 +1708,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   /* And, finally, put the connection structure into the active list. */
 
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_active_add(conn);
   ret = OK;
 
 errout_with_lock:
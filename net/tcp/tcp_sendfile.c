@@ -73,6 +73,9 @@ struct sendfile_s
   FAR struct tcp_conn_s *snd_conn;         /* Connection associated with the socket */
   FAR struct devif_callback_s *snd_cb;     /* Reference to callback instance */
   FAR struct file   *snd_file;             /* File structure of the input file */
+  FAR const uint8_t *snd_xipbase;          /* Content of the input file, if
+                                            * directly addressable
+                                            */
   sem_t              snd_sem;              /* Used to wake up the waiting thread */
   off_t              snd_foffset;          /* Input file offset */
   size_t             snd_flen;             /* File length */
@@ -96,6 +99,27 @@ struct sendfile_s
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sendfile_send
+ *
+ * Description:
+ *   Set up a segment of the file to send, copied straight from the file
+ *   content into the device buffer if it is addressable.
+ *
+ ****************************************************************************/
+
+static int sendfile_send(FAR struct net_driver_s *dev,
+                         FAR struct sendfile_s *pstate, uint32_t sndlen,
+                         off_t offset, int hdrsize)
+{
+  if (pstate->snd_xipbase != NULL)
+    {
+      return devif_send(dev, pstate->snd_xipbase + offset, sndlen, hdrsize);
+    }
+
+  return devif_file_send(dev, pstate->snd_file, sndlen, offset, hdrsize);
+}
+
 /****************************************************************************
  * Name: sendfile_eventhandler
  *
@@ -269,9 +293,9 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
        * happen until the polling cycle completes).
        */
 
-      ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                            pstate->snd_foffset + pstate->snd_acked,
-                            tcpip_hdrsize(conn));
+      ret = sendfile_send(dev, pstate, sndlen,
+                          pstate->snd_foffset + pstate->snd_acked,
+                          tcpip_hdrsize(conn));
       if (ret < 0)
         {
           nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -340,9 +364,9 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = devif_file_send(dev, pstate->snd_file, sndlen,
-                                pstate->snd_foffset + pstate->snd_sent,
-                                tcpip_hdrsize(conn));
+          ret = sendfile_send(dev, pstate, sndlen,
+                              pstate->snd_foffset + pstate->snd_sent,
+                              tcpip_hdrsize(conn));
           if (ret < 0)
             {
               nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
@@ -417,8 +441,11 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
                       FAR off_t *offset, size_t count)
 {
   FAR struct tcp_conn_s *conn;
+  FAR const uint8_t *xipbase;
   struct sendfile_s state;
   off_t startpos;
+  off_t foffset;
+  off_t size;
   int ret = OK;
 
   conn = psock->s_conn;
@@ -470,6 +497,30 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
       return startpos;
     }
 
+  foffset = offset ? *offset : startpos;
+
+  /* Send straight from the file content if the file system keeps it
+   * addressable, this saves reading every segment through the file system.
+   */
+
+  if (file_xipbase(infile, &xipbase, &size) >= 0)
+    {
+      if (foffset >= size)
+        {
+          file_xiprelease(infile);
+          return 0;
+        }
+
+      if (count > size - foffset)
+        {
+          count = size - foffset;
+        }
+    }
+  else
+    {
+      xipbase = NULL;
+    }
+
   /* Initialize the state structure.  This is done with the network
    * locked because we don't want anything to happen until we are
    * ready.
@@ -483,9 +534,10 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   nxsem_init(&state.snd_sem, 0, 0);                /* Doesn't really fail */
 
   state.snd_conn    = conn;                        /* Tcp conn to use */
-  state.snd_foffset = offset ? *offset : startpos; /* Input file offset */
+  state.snd_foffset = foffset;                     /* Input file offset */
   state.snd_flen    = count;                       /* Number of bytes to send */
   state.snd_file    = infile;                      /* File to read from */
+  state.snd_xipbase = xipbase;                     /* Or the file content */
 
   /* Allocate resources to receive a callback */
 
@@ -547,7 +599,32 @@ errout_locked:
 
   /* Return the current file position */
 
-  if (offset)
+  if (xipbase != NULL)
+    {
+      /* No segment references the content any more, they were all
+       * acknowledged or the transfer failed.
+       */
+
+      file_xiprelease(infile);
+
+      /* The file was not read, so the position follows the data sent */
+
+      off_t curpos = foffset + (state.snd_sent > 0 ? state.snd_sent : 0);
+
+      if (offset)
+        {
+          *offset = curpos;
+        }
+      else
+        {
+          curpos = file_seek(infile, curpos, SEEK_SET);
+          if (curpos < 0)
+            {
+              return curpos;
+            }
+        }
+    }
+  else if (offset)
     {
       /* Use lseek to get the current file position */
 
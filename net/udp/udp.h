@@ -33,6 +33,7 @@
 #include <sys/socket.h>
 
 #include <nuttx/queue.h>
+#include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/net.h>
@@ -73,6 +74,28 @@
 
 #define _UDP_ISCONNECTMODE(f) (((f) & _UDP_FLAG_CONNECTMODE) != 0)
 
+/* The read-ahead queue of a connection has a lock of its own, so that
+ * recv() may take a queued datagram without the network lock.  Otherwise
+ * it is protected by the network lock.
+ */
+
+#ifdef CONFIG_NET_UDP_LOCK
+#  define udp_rdlock(c)   nxmutex_lock(&(c)->rdlock)
+#  define udp_rdunlock(c) nxmutex_unlock(&(c)->rdlock)
+#else
+#  define udp_rdlock(c)
+#  define udp_rdunlock(c)
+#endif
+
+/* The sum of the payload of a buffered datagram is calculated while it is
+ * copied into the write buffer, udp_send() then only adds the headers.
+ */
+
+#if defined(CONFIG_NET_UDP_WRITE_BUFFERS) && \
+    defined(CONFIG_NET_UDP_CHECKSUMS) && !defined(CONFIG_NET_ARCH_CHKSUM)
+#  define NET_UDP_COPYIN_CHKSUM 1
+#endif
+
 /* This is a helper pointer for accessing the contents of the udp header */
 
 #define UDPIPv4BUF ((FAR struct udp_hdr_s *)IPBUF(IPv4_HDRLEN))
@@ -110,6 +133,9 @@ struct udp_conn_s
 
   /* UDP-specific content follows */
 
+#if CONFIG_NET_UDP_CONN_HASHSIZE > 0
+  dq_entry_t pnode;       /* Link in the local port hash table */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
@@ -133,6 +159,9 @@ struct udp_conn_s
    */
 
   FAR struct iob_s *readahead;   /* Read-ahead buffering */
+#ifdef CONFIG_NET_UDP_LOCK
+  mutex_t  rdlock;               /* Protects readahead */
+#endif
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Write buffering
@@ -143,6 +172,10 @@ struct udp_conn_s
 
   sq_queue_t write_q;             /* Write buffering for UDP packets */
   FAR struct net_driver_s *dev;   /* Last device */
+#ifdef NET_UDP_COPYIN_CHKSUM
+  uint16_t sndsum;                /* Payload sum of the packet in d_iob */
+  bool sndsumvalid;               /* True: sndsum is valid */
+#endif
 
   /* Callback instance for UDP sendto() */
 
@@ -174,6 +207,10 @@ struct udp_wrbuffer_s
   sq_entry_t wb_node;              /* Supports a singly linked list */
   struct sockaddr_storage wb_dest; /* Destination address */
   FAR struct iob_s *wb_iob;        /* Head of the I/O buffer chain */
+#ifdef NET_UDP_COPYIN_CHKSUM
+  uint16_t wb_sum;                 /* Raw sum of the payload */
+  bool wb_sumvalid;                /* True: wb_sum is valid */
+#endif
 };
 #endif
 
@@ -282,6 +319,25 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
 uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u);
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port number of the connection.  All changes of the local
+ *   port of an active connection must go through this function to keep the
+ *   connection hash table up to date.
+ *
+ * Input Parameters:
+ *   conn   - The UDP connection
+ *   portno - The local port number (network byte order), or zero to unbind
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno);
+
 /****************************************************************************
  * Name: udp_bind
  *
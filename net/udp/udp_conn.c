@@ -59,6 +59,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -74,6 +75,14 @@
 #include "udp/udp.h"
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_NET_UDP_CONN_HASHSIZE > 0
+#  define UDP_PORT_HASH(p) ((p) % CONFIG_NET_UDP_CONN_HASHSIZE)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -93,10 +102,43 @@ static mutex_t g_free_lock = NXMUTEX_INITIALIZER;
 
 static dq_queue_t g_active_udp_connections;
 
+#if CONFIG_NET_UDP_CONN_HASHSIZE > 0
+/* The active UDP connections with a local port, hashed by that port */
+
+static dq_queue_t g_udp_port_hash[CONFIG_NET_UDP_CONN_HASHSIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_nextport
+ *
+ * Description:
+ *   Traverse the active UDP connections that may be bound to the local
+ *   port.  All active connections are visited if the hash table is
+ *   disabled.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static inline FAR struct udp_conn_s *
+udp_nextport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#if CONFIG_NET_UDP_CONN_HASHSIZE > 0
+  FAR dq_entry_t *node;
+
+  node = conn != NULL ? dq_next(&conn->pnode) :
+                        dq_peek(&g_udp_port_hash[UDP_PORT_HASH(portno)]);
+  return node != NULL ? container_of(node, struct udp_conn_s, pnode) : NULL;
+#else
+  return udp_nextconn(conn);
+#endif
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -126,7 +168,7 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
 
   /* Now search each connection structure. */
 
-  while ((conn = udp_nextconn(conn)) != NULL)
+  while ((conn = udp_nextport(conn, portno)) != NULL)
     {
       /* With SO_REUSEADDR set for both sockets, we do not need to check its
        * address and port.
@@ -199,7 +241,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextport(conn, udp->destport);
 
   while (conn)
     {
@@ -313,7 +355,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+      conn = udp_nextport(conn, udp->destport);
     }
 
   return conn;
@@ -339,7 +381,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextport(conn, udp->destport);
 
   while (conn != NULL)
     {
@@ -453,7 +495,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+      conn = udp_nextport(conn, udp->destport);
     }
 
   return conn;
@@ -650,6 +692,9 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
 
       nxsem_init(&conn->sndsem, 0, 0);
 #endif
+#ifdef CONFIG_NET_UDP_LOCK
+      nxmutex_init(&conn->rdlock);
+#endif
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
       /* Initialize the write buffer lists */
@@ -685,7 +730,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   nxmutex_lock(&g_free_lock);
-  conn->lport = 0;
+  udp_setport(conn, 0);
 
   /* Remove the connection from the active list */
 
@@ -694,6 +739,9 @@ void udp_free(FAR struct udp_conn_s *conn)
   /* Release any read-ahead buffers attached to the connection, NULL is ok */
 
   iob_free_chain(conn->readahead);
+#ifdef CONFIG_NET_UDP_LOCK
+  nxmutex_destroy(&conn->rdlock);
+#endif
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
@@ -733,6 +781,38 @@ void udp_free(FAR struct udp_conn_s *conn)
   nxmutex_unlock(&g_free_lock);
 }
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port number of the connection.  All changes of the local
+ *   port of an active connection must go through this function to keep the
+ *   connection hash table up to date.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#if CONFIG_NET_UDP_CONN_HASHSIZE > 0
+  /* Only connections with a local port are in the hash table */
+
+  if (conn->lport != 0)
+    {
+      dq_rem(&conn->pnode, &g_udp_port_hash[UDP_PORT_HASH(conn->lport)]);
+    }
+
+  if (portno != 0)
+    {
+      dq_addlast(&conn->pnode, &g_udp_port_hash[UDP_PORT_HASH(portno)]);
+    }
+#endif
+
+  conn->lport = portno;
+}
+
 /****************************************************************************
  * Name: udp_active
  *
@@ -928,7 +1008,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
       else
         {
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
     }
@@ -953,7 +1033,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
       else
@@ -1005,7 +1085,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
@@ -181,6 +181,7 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 
   pstate->ir_recvlen = -1;
 
+  udp_rdlock(conn);
   if ((iob = conn->readahead) != NULL)
     {
       int recvlen;
@@ -275,6 +276,8 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
             }
         }
     }
+
+  udp_rdunlock(conn);
 }
 
 /****************************************************************************
@@ -687,12 +690,24 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
   /* Perform the UDP recvfrom() operation */
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
+  udp_recvfrom_initialize(conn, msg, &state, flags);
+
+#ifdef CONFIG_NET_UDP_LOCK
+  /* A datagram already queued is taken without the network lock */
+
+  udp_readahead(&state);
+  if (state.ir_recvlen >= 0)
+    {
+      udp_recvfrom_uninitialize(&state);
+      return state.ir_recvlen;
+    }
+#endif
+
+  /* Look for a datagram again with the network locked, so that none can
+   * arrive before we are ready to wait for it.
    */
 
   net_lock();
-  udp_recvfrom_initialize(conn, msg, &state, flags);
 
   /* Copy the read-ahead data from the packet */
 
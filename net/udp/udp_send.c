@@ -121,6 +121,49 @@ static void udp_send_loopback(FAR struct net_driver_s *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: udp_copyin_chksum
+ *
+ * Description:
+ *   Calculate the UDP checksum of the packet in d_buf, the raw sum of the
+ *   payload having been calculated when copying it into the write buffer.
+ *
+ ****************************************************************************/
+
+#ifdef NET_UDP_COPYIN_CHKSUM
+static uint16_t udp_copyin_chksum(FAR struct net_driver_s *dev,
+                                  FAR struct udp_hdr_s *udp, uint16_t sum)
+{
+  uint32_t acc;
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (IFF_IS_IPv4(dev->d_flags))
+#endif
+    {
+      acc = ipv4_upperlayer_header_chksum(dev, IP_PROTO_UDP);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      acc = ipv6_upperlayer_header_chksum(dev, IP_PROTO_UDP, IPv6_HDRLEN);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+  /* The payload starts at an even offset, so its sum just adds up */
+
+  acc  = chksum(acc, (FAR const uint8_t *)udp, UDP_HDRLEN);
+  acc += sum;
+  acc  = (acc >> 16) + (acc & 0xffff);
+
+  return (acc == 0) ? 0xffff : HTONS(acc);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -250,6 +293,14 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
 #ifdef CONFIG_NET_UDP_CHECKSUMS
       /* Calculate UDP checksum. */
 
+#ifdef NET_UDP_COPYIN_CHKSUM
+      if (conn->sndsumvalid)
+        {
+          udp->udpchksum    = ~udp_copyin_chksum(dev, udp, conn->sndsum);
+          conn->sndsumvalid = false;
+        }
+      else
+#endif
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
       if (IFF_IS_IPv4(dev->d_flags))
@@ -258,7 +258,7 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
@@ -457,6 +457,13 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
 
       wrb->wb_iob = NULL;
 
+#ifdef NET_UDP_COPYIN_CHKSUM
+      /* Hand over the payload sum calculated by sendto_copyin() */
+
+      conn->sndsum      = wrb->wb_sum;
+      conn->sndsumvalid = wrb->wb_sumvalid;
+#endif
+
 #ifdef NEED_IPDOMAIN_SUPPORT
       /* If both IPv4 and IPv6 support are enabled, then we will need to
        * select which one to use when generating the outgoing packet.
@@ -485,6 +492,76 @@ static uint16_t sendto_eventhandler(FAR struct net_driver_s *dev,
   return flags;
 }
 
+/****************************************************************************
+ * Name: sendto_copyin
+ *
+ * Description:
+ *   Copy the user data into a write buffer after the UDP/IP headers.  If
+ *   the whole I/O buffer chain can be allocated without waiting, the sum
+ *   of the payload is calculated in the same pass.
+ *
+ * Input Parameters:
+ *   wrb      - The write buffer
+ *   buf      - The user data
+ *   len      - The length of the user data
+ *   udpiplen - The size of the UDP/IP headers
+ *   nonblock - True if the socket was opened non-blocking
+ *
+ * Returned Value:
+ *   The number of bytes copied, or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int sendto_copyin(FAR struct udp_wrbuffer_s *wrb,
+                         FAR const void *buf, size_t len,
+                         uint16_t udpiplen, bool nonblock)
+{
+  unsigned int count;
+  int blresult;
+  int ret;
+
+#ifdef NET_UDP_COPYIN_CHKSUM
+  wrb->wb_sum      = 0;
+  wrb->wb_sumvalid = false;
+
+  ret = iob_update_pktlen(wrb->wb_iob, udpiplen + len, false);
+  if (ret == (int)(udpiplen + len))
+    {
+      wrb->wb_sumvalid = true;
+      return chksum_iob_copyin(&wrb->wb_sum, wrb->wb_iob, buf, len,
+                               udpiplen);
+    }
+#endif
+
+  iob_update_pktlen(wrb->wb_iob, udpiplen, false);
+
+  /* We cannot wait for buffer space if the socket was opened
+   * non-blocking.
+   */
+
+  if (nonblock)
+    {
+      return iob_trycopyin(wrb->wb_iob, buf, len, udpiplen, false);
+    }
+
+  /* iob_copyin might wait for buffers to be freed, but if network is
+   * locked this might never happen, since network driver is also locked,
+   * therefore we need to break the lock
+   */
+
+  blresult = net_breaklock(&count);
+  ret = iob_copyin(wrb->wb_iob, buf, len, udpiplen, false);
+  if (blresult >= 0)
+    {
+      net_restorelock(count);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: udp_send_gettimeout
  *
@@ -811,36 +888,10 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       udpiplen = udpip_hdrsize(conn);
 
       iob_reserve(wrb->wb_iob, CONFIG_NET_LL_GUARDSIZE);
-      iob_update_pktlen(wrb->wb_iob, udpiplen, false);
-
-      /* Copy the user data into the write buffer.  We cannot wait for
-       * buffer space if the socket was opened non-blocking.
-       */
-
-      if (nonblock)
-        {
-          ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf,
-                              len, udpiplen, false);
-        }
-      else
-        {
-          unsigned int count;
-          int blresult;
-
-          /* iob_copyin might wait for buffers to be freed, but if
-           * network is locked this might never happen, since network
-           * driver is also locked, therefore we need to break the lock
-           */
 
-          blresult = net_breaklock(&count);
-          ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf,
-                           len, udpiplen, false);
-          if (blresult >= 0)
-            {
-              net_restorelock(count);
-            }
-        }
+      /* Copy the user data into the write buffer */
 
+      ret = sendto_copyin(wrb, buf, len, udpiplen, nonblock);
       if (ret < 0)
         {
           goto errout_with_wrb;
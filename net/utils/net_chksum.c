@@ -27,12 +27,258 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <stdint.h>
+#include <string.h>
+#include <sys/param.h>
+
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The native value of a 16-bit word holding only the byte b, either at the
+ * lower address (CHKSUM_BYTE0) or at the higher address (CHKSUM_BYTE1).
+ */
+
+#ifdef CONFIG_ENDIAN_BIG
+#  define CHKSUM_BYTE0(b)   ((uint16_t)(b) << 8)
+#  define CHKSUM_BYTE1(b)   ((uint16_t)(b))
+#else
+#  define CHKSUM_BYTE0(b)   ((uint16_t)(b))
+#  define CHKSUM_BYTE1(b)   ((uint16_t)(b) << 8)
+#endif
+
+#define CHKSUM_SWAP(s)      ((uint16_t)(((s) << 8) | ((s) >> 8)))
+
+#ifdef CONFIG_LIBC_ARCH_CHKSUM
+#  define chksum_native(d, l) up_chksum(d, l)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: chksum_fold
+ *
+ * Description:
+ *   Fold a wide one's complement accumulator into 16 bits.
+ *
+ ****************************************************************************/
+
+static inline uint16_t chksum_fold(uint64_t acc)
+{
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  return (uint16_t)acc;
+}
+
+/****************************************************************************
+ * Name: chksum_native
+ *
+ * Description:
+ *   Calculate the one's complement sum of the memory region described by
+ *   data and len, taken as 16-bit words in the native byte order.  The odd
+ *   trailing byte, if any, is padded with zero.
+ *
+ *   The words are summed 32 bits at a time into a 64-bit accumulator, so
+ *   the carries are folded only once at the end.  By RFC1071 the sum is
+ *   independent of the byte order except for a final swap, which is also
+ *   how a buffer starting at an odd address is handled.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_LIBC_ARCH_CHKSUM) && !defined(CONFIG_NET_ARCH_CHKSUM)
+static uint16_t chksum_native(FAR const void *data, size_t len)
+{
+  FAR const uint8_t *ptr = data;
+  FAR const uint32_t *word;
+  uint64_t acc = 0;
+  bool swap = false;
+  uint16_t sum;
+
+  /* Start as if there was a zero byte in front of an odd address */
+
+  if (((uintptr_t)ptr & 1) != 0 && len > 0)
+    {
+      acc  = CHKSUM_BYTE1(*ptr++);
+      swap = true;
+      len--;
+    }
+
+  if (((uintptr_t)ptr & 2) != 0 && len >= 2)
+    {
+      acc += *(FAR const uint16_t *)ptr;
+      ptr += 2;
+      len -= 2;
+    }
+
+  /* Now the address is word aligned, unroll by 32 bytes */
+
+  word = (FAR const uint32_t *)ptr;
+  while (len >= 32)
+    {
+      acc += word[0];
+      acc += word[1];
+      acc += word[2];
+      acc += word[3];
+      acc += word[4];
+      acc += word[5];
+      acc += word[6];
+      acc += word[7];
+      word += 8;
+      len  -= 32;
+    }
+
+  while (len >= 4)
+    {
+      acc += *word++;
+      len -= 4;
+    }
+
+  ptr = (FAR const uint8_t *)word;
+  if (len >= 2)
+    {
+      acc += *(FAR const uint16_t *)ptr;
+      ptr += 2;
+      len -= 2;
+    }
+
+  if (len > 0)
+    {
+      acc += CHKSUM_BYTE0(*ptr);
+    }
+
+  sum = chksum_fold(acc);
+  return swap ? CHKSUM_SWAP(sum) : sum;
+}
+#endif
+
+/****************************************************************************
+ * Name: chksum_native_copy
+ *
+ * Description:
+ *   Copy the memory region src to dest and return the same sum as
+ *   chksum_native() over it.  The generic version touches the data only
+ *   once, while a vectorized up_chksum() is faster over the freshly copied
+ *   and still cached destination.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && defined(CONFIG_MM_IOB)
+#ifdef CONFIG_LIBC_ARCH_CHKSUM
+static inline uint16_t chksum_native_copy(FAR uint8_t *dest,
+                                          FAR const uint8_t *src,
+                                          size_t len)
+{
+  memcpy(dest, src, len);
+  return up_chksum(dest, len);
+}
+#else
+static uint16_t chksum_native_copy(FAR uint8_t *dest,
+                                   FAR const uint8_t *src, size_t len)
+{
+  FAR const uint32_t *word;
+  uint64_t acc = 0;
+  bool swap = false;
+  uint32_t tmp[8];
+  uint16_t half;
+  uint16_t sum;
+
+  if (((uintptr_t)src & 1) != 0 && len > 0)
+    {
+      acc     = CHKSUM_BYTE1(*src);
+      *dest++ = *src++;
+      swap    = true;
+      len--;
+    }
+
+  if (((uintptr_t)src & 2) != 0 && len >= 2)
+    {
+      half = *(FAR const uint16_t *)src;
+      acc += half;
+      memcpy(dest, &half, 2);
+      src  += 2;
+      dest += 2;
+      len  -= 2;
+    }
+
+  /* The loads are aligned, the stores go through memcpy() so the compiler
+   * emits whatever the destination alignment allows.
+   */
+
+  word = (FAR const uint32_t *)src;
+  while (len >= 32)
+    {
+      acc += tmp[0] = word[0];
+      acc += tmp[1] = word[1];
+      acc += tmp[2] = word[2];
+      acc += tmp[3] = word[3];
+      acc += tmp[4] = word[4];
+      acc += tmp[5] = word[5];
+      acc += tmp[6] = word[6];
+      acc += tmp[7] = word[7];
+      memcpy(dest, tmp, 32);
+      word += 8;
+      dest += 32;
+      len  -= 32;
+    }
+
+  while (len >= 4)
+    {
+      acc += tmp[0] = *word++;
+      memcpy(dest, tmp, 4);
+      dest += 4;
+      len  -= 4;
+    }
+
+  src = (FAR const uint8_t *)word;
+  if (len >= 2)
+    {
+      half = *(FAR const uint16_t *)src;
+      acc += half;
+      memcpy(dest, &half, 2);
+      src  += 2;
+      dest += 2;
+      len  -= 2;
+    }
+
+  if (len > 0)
+    {
+      acc  += CHKSUM_BYTE0(*src);
+      *dest = *src;
+    }
+
+  sum = chksum_fold(acc);
+  return swap ? CHKSUM_SWAP(sum) : sum;
+}
+#endif
+#endif
+
+/****************************************************************************
+ * Name: chksum_add
+ *
+ * Description:
+ *   Add the native sum of a region to a running checksum in host byte
+ *   order, the region starting at the second byte of a word if odd is set.
+ *
+ ****************************************************************************/
+
+static inline uint16_t chksum_add(uint32_t acc, uint16_t sum, bool odd)
+{
+  /* The running checksum is kept as big-endian words */
+
+  sum  = HTONS(sum);
+  acc += odd ? CHKSUM_SWAP(sum) : sum;
+  acc  = (acc >> 16) + (acc & 0xffff);
+  acc  = (acc >> 16) + (acc & 0xffff);
+  return (uint16_t)acc;
+}
+
 /****************************************************************************
  * Name: checksum
  *
@@ -57,57 +303,46 @@
 uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
                     uint16_t len, bool *odd)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
-
-  dataptr = data;
-  last_byte = data + len - 1;
+  bool start = *odd;
 
-  if (*odd == true)
+  if (len == 0)
     {
-      t = dataptr[0];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 1;
+      return sum;
     }
 
-  while (dataptr < last_byte)
-    {
-      /* At least two more bytes */
+  /* A region following an odd length one continues the pending word, its
+   * sum is just byte swapped.
+   */
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  *odd = ((len & 1) != 0) != start;
+  return chksum_add(sum, chksum_native(data, len), start);
+}
 
-      dataptr += 2;
-    }
+/****************************************************************************
+ * Name: checksum_copy
+ *
+ * Description:
+ *   Copy a memory region and calculate the raw change sum over it in the
+ *   same pass, equivalent to memcpy() followed by checksum() on dest.
+ *
+ ****************************************************************************/
 
-  *odd = false;
+#ifdef CONFIG_MM_IOB
+static uint16_t checksum_copy(uint16_t sum, FAR uint8_t *dest,
+                              FAR const uint8_t *src, uint16_t len,
+                              FAR bool *odd)
+{
+  bool start = *odd;
 
-  if (dataptr == last_byte)
+  if (len == 0)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      *odd = true;
+      return sum;
     }
 
-  /* Return sum in host byte order. */
-
-  return sum;
+  *odd = ((len & 1) != 0) != start;
+  return chksum_add(sum, chksum_native_copy(dest, src, len), start);
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -188,6 +423,59 @@ uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset)
 }
 #endif /* CONFIG_MM_IOB */
 
+/****************************************************************************
+ * Name: chksum_iob_copyin
+ *
+ * Description:
+ *   Copy data into an iob chain and calculate the raw change sum over it
+ *   in the same pass, equivalent to iob_copyin() followed by chksum() on
+ *   src.  The chain must already be long enough, see iob_update_pktlen().
+ *
+ * Input Parameters:
+ *   sum    - Partial calculations carried over from a previous call,
+ *            updated on return.  This should be zero on the first call.
+ *   iob    - The iob chain to copy to.
+ *   src    - Beginning of the data to copy and include in the checksum.
+ *   len    - Number of bytes to copy.
+ *   offset - Byte offset of the destination in the chain.
+ *
+ * Returned Value:
+ *   The number of bytes copied, less than len only if the chain is too
+ *   short.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && defined(CONFIG_MM_IOB)
+unsigned int chksum_iob_copyin(FAR uint16_t *sum, FAR struct iob_s *iob,
+                               FAR const uint8_t *src, unsigned int len,
+                               unsigned int offset)
+{
+  unsigned int ncopied = 0;
+  unsigned int ncopy;
+  bool odd = false;
+
+  /* Skip to the I/O buffer containing the data offset */
+
+  while (iob != NULL && offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  while (iob != NULL && ncopied < len)
+    {
+      ncopy    = MIN(iob->io_len - offset, len - ncopied);
+      *sum     = checksum_copy(*sum, iob->io_data + iob->io_offset + offset,
+                               src + ncopied, ncopy, &odd);
+      ncopied += ncopy;
+      iob      = iob->io_flink;
+      offset   = 0;
+    }
+
+  return ncopied;
+}
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -63,17 +63,18 @@ static rmutex_t g_netlock = NXRMUTEX_INITIALIZER;
  ****************************************************************************/
 
 static int
-_net_timedwait(FAR sem_t *sem, bool interruptible, unsigned int timeout)
+_net_timedwait(FAR rmutex_t *lock, FAR sem_t *sem, bool interruptible,
+               unsigned int timeout)
 {
   unsigned int count;
   int          blresult;
   int          ret;
 
-  /* Release the network lock, remembering my count.  net_breaklock will
-   * return a negated value if the caller does not hold the network lock.
+  /* Release the lock, remembering my count.  nxrmutex_breaklock will
+   * return a negated value if the caller does not hold the lock.
    */
 
-  blresult = net_breaklock(&count);
+  blresult = nxrmutex_breaklock(lock, &count);
 
   /* Now take the semaphore, waiting if so requested. */
 
@@ -104,11 +105,11 @@ _net_timedwait(FAR sem_t *sem, bool interruptible, unsigned int timeout)
         }
     }
 
-  /* Recover the network lock at the proper count (if we held it before) */
+  /* Recover the lock at the proper count (if we held it before) */
 
   if (blresult >= 0)
     {
-      net_restorelock(count);
+      nxrmutex_restorelock(lock, count);
     }
 
   return ret;
@@ -235,7 +236,7 @@ int net_restorelock(unsigned int count)
 
 int net_sem_timedwait(FAR sem_t *sem, unsigned int timeout)
 {
-  return _net_timedwait(sem, true, timeout);
+  return _net_timedwait(&g_netlock, sem, true, timeout);
 }
 
 /****************************************************************************
@@ -364,7 +365,7 @@ int net_mutex_lock(FAR mutex_t *mutex)
 
 int net_sem_timedwait_uninterruptible(FAR sem_t *sem, unsigned int timeout)
 {
-  return _net_timedwait(sem, false, timeout);
+  return _net_timedwait(&g_netlock, sem, false, timeout);
 }
 
 /****************************************************************************
@@ -388,6 +389,30 @@ int net_sem_wait_uninterruptible(FAR sem_t *sem)
   return net_sem_timedwait_uninterruptible(sem, UINT_MAX);
 }
 
+/****************************************************************************
+ * Name: net_rmutex_sem_timedwait
+ *
+ * Description:
+ *   Atomically wait for sem (or a timeout) while temporarily releasing
+ *   the specified re-entrant lock.
+ *
+ * Input Parameters:
+ *   lock    - The re-entrant lock held by the caller.
+ *   sem     - A reference to the semaphore to be taken.
+ *   timeout - The relative time to wait until a timeout is declared.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int net_rmutex_sem_timedwait(FAR rmutex_t *lock, FAR sem_t *sem,
+                             unsigned int timeout)
+{
+  return _net_timedwait(lock, sem, true, timeout);
+}
+
 #ifdef CONFIG_MM_IOB
 
 /****************************************************************************
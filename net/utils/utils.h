@@ -31,6 +31,7 @@
 
 #include <stdlib.h>
 
+#include <nuttx/mutex.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
@@ -133,6 +134,28 @@ int net_breaklock(FAR unsigned int *count);
 
 int net_restorelock(unsigned int count);
 
+/****************************************************************************
+ * Name: net_rmutex_sem_timedwait
+ *
+ * Description:
+ *   Atomically wait for sem (or a timeout) while temporarily releasing
+ *   the specified re-entrant lock.  This is the same as net_sem_timedwait()
+ *   but for the network subsystems protected by a lock of their own.
+ *
+ * Input Parameters:
+ *   lock    - The re-entrant lock held by the caller.
+ *   sem     - A reference to the semaphore to be taken.
+ *   timeout - The relative time to wait until a timeout is declared.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int net_rmutex_sem_timedwait(FAR rmutex_t *lock, FAR sem_t *sem,
+                             unsigned int timeout);
+
 /****************************************************************************
  * Name: net_dsec2timeval
  *
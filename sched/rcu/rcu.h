@@ -0,0 +1,66 @@
+/****************************************************************************
+ * sched/rcu/rcu.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __SCHED_RCU_RCU_H
+#define __SCHED_RCU_RCU_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/rcu.h>
+
+#ifdef CONFIG_RCU
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_quiescent
+ *
+ * Description:
+ *   Report that this CPU is outside of any read-side critical section.
+ *   Called with the interrupts disabled on a context switch, and from the
+ *   IPI of synchronize_rcu().
+ *
+ ****************************************************************************/
+
+static inline_function void rcu_quiescent(void)
+{
+  FAR struct rcu_cpu_s *rcu = &g_rcu_cpu[this_cpu()];
+
+  /* A reader must not block */
+
+  DEBUGASSERT(rcu->nest == 0);
+
+  rcu->qs++;
+
+  /* Make the count visible before the next reader loads any pointer */
+
+  SP_DSB();
+}
+
+#endif /* CONFIG_RCU */
+#endif /* __SCHED_RCU_RCU_H */
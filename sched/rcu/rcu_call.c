@@ -0,0 +1,125 @@
+/****************************************************************************
+ * sched/rcu/rcu_call.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <stdbool.h>
+
+#include <nuttx/rcu.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define RCUWORK LPWORK
+#else
+#  define RCUWORK HPWORK
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static spinlock_t g_rcu_lock = SP_UNLOCKED;
+static FAR struct rcu_head_s *g_rcu_head;
+static FAR struct rcu_head_s **g_rcu_tail = &g_rcu_head;
+static struct work_s g_rcu_work;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_worker
+ *
+ * Description:
+ *   Wait for a grace period and invoke the callbacks queued before it
+ *   started.
+ *
+ ****************************************************************************/
+
+static void rcu_worker(FAR void *arg)
+{
+  FAR struct rcu_head_s *head;
+  FAR struct rcu_head_s *next;
+  irqstate_t flags;
+
+  flags      = spin_lock_irqsave(&g_rcu_lock);
+  head       = g_rcu_head;
+  g_rcu_head = NULL;
+  g_rcu_tail = &g_rcu_head;
+  spin_unlock_irqrestore(&g_rcu_lock, flags);
+
+  synchronize_rcu();
+
+  for (; head != NULL; head = next)
+    {
+      next = head->next;
+      head->func(head);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: call_rcu
+ *
+ * Description:
+ *   Call func(head) from the work queue after a grace period.
+ *
+ ****************************************************************************/
+
+void call_rcu(FAR struct rcu_head_s *head, rcu_callback_t func)
+{
+  irqstate_t flags;
+  bool kick;
+
+  DEBUGASSERT(head != NULL && func != NULL);
+
+  head->next = NULL;
+  head->func = func;
+
+  flags       = spin_lock_irqsave(&g_rcu_lock);
+  kick        = g_rcu_head == NULL;
+  *g_rcu_tail = head;
+  g_rcu_tail  = &head->next;
+  spin_unlock_irqrestore(&g_rcu_lock, flags);
+
+  /* Only the first callback after the worker took the list queues the
+   * work again, the others join its batch.
+   */
+
+  if (kick)
+    {
+      work_queue(RCUWORK, &g_rcu_work, rcu_worker, NULL, 0);
+    }
+}
@@ -0,0 +1,154 @@
+/****************************************************************************
+ * sched/rcu/rcu_sync.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <sched.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/rcu.h>
+#include <nuttx/sched.h>
+#include <nuttx/signal.h>
+
+#include "rcu/rcu.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct rcu_cpu_s g_rcu_cpu[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_quiescent_ipi
+ *
+ * Description:
+ *   Runs on the CPUs which did not switch context during the grace period.
+ *   The IPI is only taken with the interrupts enabled, that is outside of
+ *   any read-side critical section.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static int rcu_quiescent_ipi(FAR void *arg)
+{
+  rcu_quiescent();
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait until every read-side critical section which was in progress when
+ *   this function was called has completed.
+ *
+ *   Readers can't be preempted, so a CPU which switched context since the
+ *   call has left the sections it was in.  The CPUs which didn't within
+ *   CONFIG_RCU_EXPEDITE_TICKS are forced through a quiescent state by an
+ *   IPI.  The calling CPU runs no reader and is quiescent already, and
+ *   without SMP there is nothing to wait for.
+ *
+ ****************************************************************************/
+
+void synchronize_rcu(void)
+{
+#ifdef CONFIG_SMP
+  uint32_t snap[CONFIG_SMP_NCPUS];
+  cpu_set_t cpuset;
+  irqstate_t flags;
+  int retry;
+  int cpu;
+  int me;
+#endif
+
+  DEBUGASSERT(!up_interrupt_context() && !rcu_read_lock_held());
+
+#ifdef CONFIG_SMP
+  /* Only the boot CPU runs before the OS is ready */
+
+  if (!OSINIT_OS_READY())
+    {
+      return;
+    }
+
+  /* Order the unpublishing of the objects before the snapshot and take it
+   * without migrating to another CPU.
+   */
+
+  flags = up_irq_save();
+  SP_DSB();
+
+  me = this_cpu();
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      snap[cpu] = g_rcu_cpu[cpu].qs;
+    }
+
+  up_irq_restore(flags);
+
+  for (retry = 0; ; retry++)
+    {
+      CPU_ZERO(&cpuset);
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          if (cpu != me && g_rcu_cpu[cpu].qs == snap[cpu])
+            {
+              CPU_SET(cpu, &cpuset);
+            }
+        }
+
+      if (CPU_COUNT(&cpuset) == 0)
+        {
+          break;
+        }
+
+      if (retry >= CONFIG_RCU_EXPEDITE_TICKS)
+        {
+          DEBUGVERIFY(nxsched_smp_call(cpuset, rcu_quiescent_ipi, NULL));
+          break;
+        }
+
+      nxsig_usleep(USEC_PER_TICK);
+    }
+
+  /* Order the grace period before the reclaiming of the objects */
+
+  SP_DSB();
+#endif
+}
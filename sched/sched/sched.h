@@ -389,6 +389,10 @@ static inline_function FAR struct tcb_s *this_task(void)
 
 #ifdef CONFIG_SMP
 void nxsched_process_delivered(int cpu);
+void nxsched_queue_readytorun(FAR struct tcb_s *btcb);
+#  ifdef CONFIG_SCHED_PERCPU_READYQUEUE
+FAR struct tcb_s *nxsched_steal_tcb(int cpu);
+#  endif
 #else
 #  define nxsched_select_cpu(a)     (0)
 #endif
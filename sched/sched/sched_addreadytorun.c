@@ -151,6 +151,52 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
  ****************************************************************************/
 
 #ifdef CONFIG_SMP
+
+/****************************************************************************
+ * Name:  nxsched_queue_readytorun
+ *
+ * Description:
+ *   Add a TCB which is ready-to-run, but which is not going to run now,
+ *   to a ready-to-run queue.  With CONFIG_SCHED_PERCPU_READYQUEUE the TCB
+ *   is queued behind the running task of the CPU running the lowest
+ *   priority task within the TCB's affinity.  Otherwise, or if the TCB has
+ *   higher priority than any such running task, it is added to the global
+ *   g_readytorun list.
+ *
+ * Input Parameters:
+ *   btcb - Points to the TCB that is ready-to-run
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section before calling this
+ *   function.
+ * - The caller has already removed the input btcb from whatever list it
+ *   was in.
+ *
+ ****************************************************************************/
+
+void nxsched_queue_readytorun(FAR struct tcb_s *btcb)
+{
+#ifdef CONFIG_SCHED_PERCPU_READYQUEUE
+  int cpu = nxsched_select_cpu(btcb->affinity);
+
+  if (current_task(cpu)->sched_priority >= btcb->sched_priority)
+    {
+      /* Queue behind the running task, the head of the list is unchanged */
+
+      nxsched_add_prioritized(btcb, &g_assignedtasks[cpu]);
+      btcb->cpu        = cpu;
+      btcb->task_state = TSTATE_TASK_ASSIGNED;
+      return;
+    }
+#endif
+
+  nxsched_add_prioritized(btcb, list_readytorun());
+  btcb->task_state = TSTATE_TASK_READYTORUN;
+}
+
 bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 {
   FAR struct tcb_s *rtcb;
@@ -215,10 +261,8 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
        * Add the task to the ready-to-run (but not running) task list
        */
 
-      nxsched_add_prioritized(btcb, list_readytorun());
-
-      btcb->task_state = TSTATE_TASK_READYTORUN;
-      doswitch         = false;
+      nxsched_queue_readytorun(btcb);
+      doswitch = false;
     }
   else /* (task_state == TSTATE_TASK_RUNNING) */
     {
@@ -244,13 +288,11 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
                   g_delivertasks[cpu] = btcb;
                   btcb->cpu = cpu;
                   btcb->task_state = TSTATE_TASK_ASSIGNED;
-                  nxsched_add_prioritized(rtcb, &g_readytorun);
-                  rtcb->task_state = TSTATE_TASK_READYTORUN;
+                  nxsched_queue_readytorun(rtcb);
                 }
               else
                 {
-                  nxsched_add_prioritized(btcb, &g_readytorun);
-                  btcb->task_state = TSTATE_TASK_READYTORUN;
+                  nxsched_queue_readytorun(btcb);
                 }
             }
 
@@ -274,9 +274,19 @@ bool nxsched_merge_pending(void)
        * tasks in the pending task list to the ready-to-run task list.
        */
 
+#ifdef CONFIG_SCHED_PERCPU_READYQUEUE
+      /* Spread them over the per-CPU ready-to-run queues */
+
+      while ((tcb = (FAR struct tcb_s *)
+                    dq_remfirst(list_pendingtasks())) != NULL)
+        {
+          nxsched_queue_readytorun(tcb);
+        }
+#else
       nxsched_merge_prioritized(list_pendingtasks(),
                                 list_readytorun(),
                                 TSTATE_TASK_READYTORUN);
+#endif
     }
 
 errout:
@@ -135,6 +135,64 @@ void nxsched_remove_self(FAR struct tcb_s *tcb)
  ****************************************************************************/
 
 #ifdef CONFIG_SMP
+
+/****************************************************************************
+ * Name: nxsched_steal_tcb
+ *
+ * Description:
+ *   Find the highest priority task which is queued, but not running, in
+ *   the g_assignedtasks[] list of another CPU and which is permitted to run
+ *   on the specified CPU.
+ *
+ * Input Parameters:
+ *   cpu - The CPU which is looking for work
+ *
+ * Returned Value:
+ *   The TCB of the task to steal, or NULL if there is none.  The TCB is
+ *   not removed from its list.
+ *
+ * Assumptions:
+ * - The caller has established a critical section before calling this
+ *   function.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PERCPU_READYQUEUE
+FAR struct tcb_s *nxsched_steal_tcb(int cpu)
+{
+  FAR struct tcb_s *steal = NULL;
+  FAR struct tcb_s *rtrtcb;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (i == cpu)
+        {
+          continue;
+        }
+
+      /* Each list is prioritized, so stop as soon as the task can't beat
+       * the best one found so far.
+       */
+
+      for (rtrtcb = (FAR struct tcb_s *)g_assignedtasks[i].head;
+           !is_idle_task(rtrtcb) &&
+           (steal == NULL || rtrtcb->sched_priority > steal->sched_priority);
+           rtrtcb = rtrtcb->flink)
+        {
+          if (rtrtcb->task_state != TSTATE_TASK_RUNNING &&
+              CPU_ISSET(cpu, &rtrtcb->affinity))
+            {
+              steal = rtrtcb;
+              break;
+            }
+        }
+    }
+
+  return steal;
+}
+#endif
+
 void nxsched_remove_running(FAR struct tcb_s *tcb)
 {
   FAR dq_queue_t *tasklist;
@@ -184,6 +242,40 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
 
   dq_rem_head((FAR dq_entry_t *)tcb, tasklist);
 
+#ifdef CONFIG_SCHED_PERCPU_READYQUEUE
+  /* Search for the highest priority task in the g_readytorun list that can
+   * run on this CPU.
+   */
+
+  for (rtrtcb = (FAR struct tcb_s *)g_readytorun.head;
+        rtrtcb != NULL && !CPU_ISSET(cpu, &rtrtcb->affinity);
+        rtrtcb = rtrtcb->flink);
+
+  if (rtrtcb != NULL && rtrtcb->sched_priority >= nxttcb->sched_priority)
+    {
+      dq_rem((FAR dq_entry_t *)rtrtcb, &g_readytorun);
+      dq_addfirst_nonempty((FAR dq_entry_t *)rtrtcb, tasklist);
+
+      rtrtcb->cpu = cpu;
+      nxttcb = rtrtcb;
+    }
+
+  /* Steal the task from the queue of another CPU only if it is better than
+   * the local candidate, the tasks in our own queue are preferred on equal
+   * priority.  Only the selected task migrates, the queues of the other
+   * CPUs are otherwise left untouched.
+   */
+
+  rtrtcb = nxsched_steal_tcb(cpu);
+  if (rtrtcb != NULL && rtrtcb->sched_priority > nxttcb->sched_priority)
+    {
+      dq_rem((FAR dq_entry_t *)rtrtcb, &g_assignedtasks[rtrtcb->cpu]);
+      dq_addfirst_nonempty((FAR dq_entry_t *)rtrtcb, tasklist);
+
+      rtrtcb->cpu = cpu;
+      nxttcb = rtrtcb;
+    }
+#else
   /* Find the highest priority non-running tasks in the g_assignedtasks
    * list of other CPUs, and also non-idle tasks, place them in the
    * g_readytorun list. so as to find the task with the highest priority,
@@ -259,6 +351,7 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
       rtrtcb->cpu = cpu;
       nxttcb = rtrtcb;
     }
+#endif
 
   /* NOTE: If the task runs on another CPU(cpu), adjusting global IRQ
    * controls will be done in the pause handler on the new CPU(cpu).
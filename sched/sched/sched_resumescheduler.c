@@ -37,6 +37,7 @@
 #endif
 
 #include "irq/irq.h"
+#include "rcu/rcu.h"
 #include "sched/sched.h"
 
 #if defined(CONFIG_SCHED_RESUMESCHEDULER)
@@ -84,6 +85,12 @@ void nxsched_resume_scheduler(FAR struct tcb_s *tcb)
 #ifdef CONFIG_SCHED_PERF_EVENTS
   perf_event_task_sched_in(tcb);
 #endif
+
+#ifdef CONFIG_RCU
+  /* A context switch is a quiescent state of this CPU */
+
+  rcu_quiescent();
+#endif
 }
 
 #endif /* CONFIG_SCHED_RESUMESCHEDULER */
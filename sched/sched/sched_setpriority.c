@@ -126,15 +126,26 @@ static FAR struct tcb_s *nxsched_nexttcb(FAR struct tcb_s *tcb)
            rtrtcb != NULL && !CPU_ISSET(tcb->cpu, &rtrtcb->affinity);
            rtrtcb = rtrtcb->flink);
 
-      /* Return the TCB from the readyt-to-run list if it is the next
+      /* Use the TCB from the readyt-to-run list if it is the next
        * highest priority task.
        */
 
       if (rtrtcb != NULL &&
           rtrtcb->sched_priority >= nxttcb->sched_priority)
         {
-          return rtrtcb;
+          nxttcb = rtrtcb;
         }
+
+#ifdef CONFIG_SCHED_PERCPU_READYQUEUE
+      /* The task queued on another CPU may also run on tcb->cpu */
+
+      rtrtcb = nxsched_steal_tcb(tcb->cpu);
+      if (rtrtcb != NULL &&
+          rtrtcb->sched_priority > nxttcb->sched_priority)
+        {
+          nxttcb = rtrtcb;
+        }
+#endif
     }
 
   /* Otherwise, return the next TCB in the g_assignedtasks[] list...
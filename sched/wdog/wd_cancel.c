@@ -91,6 +91,10 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
 int wd_cancel_irq(FAR struct wdog_s *wdog)
 {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  clock_t prev;
+  clock_t next;
+#endif
   bool head;
 
   /* Make sure that the watchdog is valid and still active. */
@@ -107,11 +111,23 @@ int wd_cancel_irq(FAR struct wdog_s *wdog)
    * cancellation is complete
    */
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  head = wd_wheel_next(&prev);
+
+  /* Now, remove the watchdog from the timer wheel */
+
+  wd_wheel_remove(wdog);
+
+  /* The next wheel event only changes when the wdog is the first one */
+
+  head = head && (!wd_wheel_next(&next) || next != prev);
+#else
   head = list_is_head(&g_wdactivelist, &wdog->node);
 
   /* Now, remove the watchdog from the timer queue */
 
   list_delete(&wdog->node);
+#endif
 
   /* Mark the watchdog inactive */
 
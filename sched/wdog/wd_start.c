@@ -94,6 +94,49 @@ static unsigned int g_wdtimernested;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_getexpired
+ *
+ * Description:
+ *   Remove and return the first watchdog which is expired at the specified
+ *   time.
+ *
+ * Input Parameters:
+ *   ticks - current time in ticks
+ *
+ * Returned Value:
+ *   The expired watchdog, or NULL if no watchdog is expired.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct wdog_s *wd_getexpired(clock_t ticks)
+{
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  return wd_wheel_expired(ticks);
+#else
+  FAR struct wdog_s *wdog;
+
+  if (list_is_empty(&g_wdactivelist))
+    {
+      return NULL;
+    }
+
+  wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
+
+  /* Check if expected time is expired */
+
+  if (!clock_compare(wdog->expired, ticks))
+    {
+      return NULL;
+    }
+
+  /* Remove the watchdog from the head of the list */
+
+  list_delete(&wdog->node);
+  return wdog;
+#endif
+}
+
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -129,21 +172,8 @@ static inline_function void wd_expiration(clock_t ticks)
    * other watchdogs that became ready to run at this time
    */
 
-  while (!list_is_empty(&g_wdactivelist))
+  while ((wdog = wd_getexpired(ticks)) != NULL)
     {
-      wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
-
-      /* Check if expected time is expired */
-
-      if (!clock_compare(wdog->expired, ticks))
-        {
-          break;
-        }
-
-      /* Remove the watchdog from the head of the list */
-
-      list_delete(&wdog->node);
-
       /* Indicate that the watchdog is no longer active. */
 
       func = wdog->func;
@@ -169,7 +199,8 @@ static inline_function void wd_expiration(clock_t ticks)
  *
  * Description:
  *   Insert the timer into the global list to ensure that
- *   the list is sorted in increasing order of expiration absolute time.
+ *   the list is sorted in increasing order of expiration absolute time,
+ *   or into the timer wheel if CONFIG_WDOG_TIMER_WHEEL is enabled.
  *
  * Input Parameters:
  *   wdog     - Watchdog ID
@@ -189,8 +220,18 @@ static inline_function
 void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
 {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
   FAR struct wdog_s *curr;
+#endif
 
+  wdog->func = wdentry;
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+  wdog->expired = expired;
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  wd_wheel_insert(wdog);
+#else
   /* Traverse the watchdog list */
 
   list_for_every_entry(&g_wdactivelist, curr, struct wdog_s, node)
@@ -211,11 +252,7 @@ void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
    */
 
   list_add_before(&curr->node, &wdog->node);
-
-  wdog->func = wdentry;
-  up_getpicbase(&wdog->picbase);
-  wdog->arg = arg;
-  wdog->expired = expired;
+#endif
 }
 
 /****************************************************************************
@@ -261,6 +298,9 @@ void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
 int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
                      wdentry_t wdentry, wdparm_t arg)
 {
+#if defined(CONFIG_SCHED_TICKLESS) && defined(CONFIG_WDOG_TIMER_WHEEL)
+  clock_t next;
+#endif
   irqstate_t flags;
   bool reassess = false;
 
@@ -294,7 +334,36 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
    */
 
   flags = enter_critical_section();
-#ifdef CONFIG_SCHED_TICKLESS
+#if defined(CONFIG_SCHED_TICKLESS) && defined(CONFIG_WDOG_TIMER_WHEEL)
+  /* We need to reassess timer if the next wheel event has changed. */
+
+  reassess = !wd_wheel_next(&next);
+
+  if (WDOG_ISACTIVE(wdog))
+    {
+      wd_wheel_remove(wdog);
+      wdog->func = NULL;
+    }
+
+  wd_insert(wdog, ticks, wdentry, arg);
+
+  if (!reassess)
+    {
+      clock_t prev = next;
+
+      wd_wheel_next(&next);
+      reassess = next != prev;
+    }
+
+  if (!g_wdtimernested && reassess)
+    {
+      /* Resume the interval timer that will generate the next
+       * interval event.
+       */
+
+      nxsched_reassess_timer();
+    }
+#elif defined(CONFIG_SCHED_TICKLESS)
   /* We need to reassess timer if the watchdog list head has changed. */
 
   if (WDOG_ISACTIVE(wdog))
@@ -323,7 +392,11 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
   if (WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+      wd_wheel_remove(wdog);
+#else
       list_delete(&wdog->node);
+#endif
       wdog->func = NULL;
     }
 
@@ -414,7 +487,11 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
 #ifdef CONFIG_SCHED_TICKLESS
 clock_t wd_timer(clock_t ticks, bool noswitches)
 {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  clock_t next;
+#else
   FAR struct wdog_s *wdog;
+#endif
   irqstate_t flags;
   sclock_t ret;
 
@@ -429,6 +506,15 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
 
   /* Return the delay for the next watchdog to expire */
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  if (!wd_wheel_next(&next))
+    {
+      leave_critical_section(flags);
+      return 0;
+    }
+
+  ret = next - ticks;
+#else
   if (list_is_empty(&g_wdactivelist))
     {
       leave_critical_section(flags);
@@ -441,6 +527,7 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
 
   wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
   ret = wdog->expired - ticks;
+#endif
 
   leave_critical_section(flags);
 
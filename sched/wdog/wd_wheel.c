@@ -0,0 +1,371 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each level of the wheel has 64 slots so that the slot occupancy fits in
+ * one 64-bit bitmap.  Level n has a granularity of 64^n ticks.
+ */
+
+#define WD_WHEEL_BITS        6
+#define WD_WHEEL_SIZE        (1 << WD_WHEEL_BITS)
+#define WD_WHEEL_MASK        (WD_WHEEL_SIZE - 1)
+#define WD_WHEEL_LEVELS      CONFIG_WDOG_TIMER_WHEEL_LEVELS
+
+#define WD_WHEEL_SHIFT(l)    ((l) * WD_WHEEL_BITS)
+#define WD_WHEEL_SPAN(l)     ((clock_t)1 << WD_WHEEL_SHIFT(l))
+#define WD_WHEEL_INDEX(t, l) (((t) >> WD_WHEEL_SHIFT(l)) & WD_WHEEL_MASK)
+
+#define WD_WHEEL_SLOT(l, i)  (&g_wdwheel[(l) * WD_WHEEL_SIZE + (i)])
+#define WD_WHEEL_ISSLOT(n) \
+  ((n) >= &g_wdwheel[0] && (n) < &g_wdwheel[WD_WHEEL_LEVELS * WD_WHEEL_SIZE])
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The wheel slots.  A slot list head is only valid while the corresponding
+ * bit in g_wdbitmap is set, this avoids initializing the whole wheel.
+ */
+
+static struct list_node g_wdwheel[WD_WHEEL_LEVELS * WD_WHEEL_SIZE];
+static uint64_t g_wdbitmap[WD_WHEEL_LEVELS];
+
+/* The watchdogs expire beyond the range of the highest level */
+
+static struct list_node g_wdoverflow = LIST_INITIAL_VALUE(g_wdoverflow);
+
+/* All the watchdogs expire before g_wdbase are already processed */
+
+static clock_t g_wdbase;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Place the watchdog into the slot determined by the highest bit that
+ *   differs between the expiration time and the wheel base.  An expired
+ *   watchdog is placed into the current level 0 slot.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_add(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *slot;
+  clock_t expired = wdog->expired;
+  int level = 0;
+  int index;
+
+  if (clock_compare(expired, g_wdbase))
+    {
+      expired = g_wdbase;
+    }
+  else
+    {
+      level = (flsll((long long)(expired ^ g_wdbase)) - 1) / WD_WHEEL_BITS;
+      if (level >= WD_WHEEL_LEVELS)
+        {
+          list_add_tail(&g_wdoverflow, &wdog->node);
+          return;
+        }
+    }
+
+  index = WD_WHEEL_INDEX(expired, level);
+  slot  = WD_WHEEL_SLOT(level, index);
+
+  if ((g_wdbitmap[level] & ((uint64_t)1 << index)) == 0)
+    {
+      g_wdbitmap[level] |= (uint64_t)1 << index;
+      list_initialize(slot);
+    }
+
+  list_add_tail(slot, &wdog->node);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Move all the watchdogs from the list into the lower levels, relative to
+ *   the current wheel base.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(FAR struct list_node *list)
+{
+  FAR struct wdog_s *wdog;
+  FAR struct wdog_s *tmp;
+  struct list_node pending;
+
+  /* Detach the list first, a watchdog may be placed back to the same list
+   * (e.g. the overflow list).
+   */
+
+  pending.next       = list->next;
+  pending.prev       = list->prev;
+  pending.next->prev = &pending;
+  pending.prev->next = &pending;
+  list_initialize(list);
+
+  list_for_every_entry_safe(&pending, wdog, tmp, struct wdog_s, node)
+    {
+      list_delete(&wdog->node);
+      wd_wheel_add(wdog);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_setbase
+ *
+ * Description:
+ *   Move the wheel base forward.  If the new base crosses into a new slot
+ *   of the upper levels, the watchdogs of that slot are cascaded down.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_setbase(clock_t base)
+{
+  int level;
+  int index;
+
+  g_wdbase = base;
+
+  if ((base & (WD_WHEEL_SPAN(WD_WHEEL_LEVELS) - 1)) == 0 &&
+      !list_is_empty(&g_wdoverflow))
+    {
+      wd_wheel_cascade(&g_wdoverflow);
+    }
+
+  for (level = WD_WHEEL_LEVELS - 1; level > 0; level--)
+    {
+      if ((base & (WD_WHEEL_SPAN(level) - 1)) != 0)
+        {
+          continue;
+        }
+
+      index = WD_WHEEL_INDEX(base, level);
+      if ((g_wdbitmap[level] & ((uint64_t)1 << index)) != 0)
+        {
+          g_wdbitmap[level] &= ~((uint64_t)1 << index);
+          wd_wheel_cascade(WD_WHEEL_SLOT(level, index));
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Insert the watchdog into the timer wheel in O(1).
+ *
+ * Assumptions:
+ *   Called inside the critical section, wdog->expired is already set.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  int level;
+
+  /* Resync the wheel base to the current time if the wheel is empty, so
+   * that the next expiration is not stepped from a stale base.
+   */
+
+  if (list_is_empty(&g_wdoverflow))
+    {
+      for (level = 0; level < WD_WHEEL_LEVELS; level++)
+        {
+          if (g_wdbitmap[level] != 0)
+            {
+              break;
+            }
+        }
+
+      if (level >= WD_WHEEL_LEVELS)
+        {
+          g_wdbase = clock_systime_ticks();
+        }
+    }
+
+  wd_wheel_add(wdog);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove the watchdog from the timer wheel in O(1).
+ *
+ * Assumptions:
+ *   Called inside the critical section, the watchdog is active.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *prev = wdog->node.prev;
+  int offset;
+
+  list_delete(&wdog->node);
+
+  /* Only the slot head could become an empty list, clear its bit */
+
+  if (list_is_empty(prev) && WD_WHEEL_ISSLOT(prev))
+    {
+      offset = prev - g_wdwheel;
+      g_wdbitmap[offset / WD_WHEEL_SIZE] &=
+        ~((uint64_t)1 << (offset % WD_WHEEL_SIZE));
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Get the next time the wheel needs to be serviced: either the expiration
+ *   of the first level 0 slot in use, or the time to cascade the first
+ *   upper level slot in use.  This is never later than the real next
+ *   expiration, so it could be used directly to program the tickless timer.
+ *
+ * Input Parameters:
+ *   next - The location to return the next time
+ *
+ * Returned Value:
+ *   true if any watchdog is active, otherwise false.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR clock_t *next)
+{
+  uint64_t pending;
+  int level;
+  int index;
+
+  for (level = 0; level < WD_WHEEL_LEVELS; level++)
+    {
+      index = WD_WHEEL_INDEX(g_wdbase, level);
+
+      /* The current slot of the upper level is already cascaded */
+
+      if (level > 0)
+        {
+          index++;
+        }
+
+      if (index >= WD_WHEEL_SIZE)
+        {
+          continue;
+        }
+
+      pending = g_wdbitmap[level] & (~(uint64_t)0 << index);
+      if (pending != 0)
+        {
+          index = ffsll((long long)pending) - 1;
+          *next = (g_wdbase & ~(WD_WHEEL_SPAN(level + 1) - 1)) |
+                  ((clock_t)index << WD_WHEEL_SHIFT(level));
+          return true;
+        }
+    }
+
+  if (!list_is_empty(&g_wdoverflow))
+    {
+      *next = (g_wdbase | (WD_WHEEL_SPAN(WD_WHEEL_LEVELS) - 1)) + 1;
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Advance the wheel up to the specified time and remove the next expired
+ *   watchdog.  Only the slots in use are visited, the idle slots are
+ *   skipped with the bitmaps.
+ *
+ * Input Parameters:
+ *   ticks - current time in ticks
+ *
+ * Returned Value:
+ *   The expired watchdog, or NULL if there is no more expired watchdog.
+ *
+ * Assumptions:
+ *   Called inside the critical section.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(clock_t ticks)
+{
+  FAR struct list_node *slot;
+  FAR struct wdog_s *wdog;
+  clock_t next;
+  int index;
+
+  while (clock_compare(g_wdbase, ticks))
+    {
+      index = WD_WHEEL_INDEX(g_wdbase, 0);
+      if ((g_wdbitmap[0] & ((uint64_t)1 << index)) != 0)
+        {
+          slot = WD_WHEEL_SLOT(0, index);
+          wdog = list_first_entry(slot, struct wdog_s, node);
+          wd_wheel_remove(wdog);
+          return wdog;
+        }
+
+      /* Skip to the next slot in use or cascade point */
+
+      if (!wd_wheel_next(&next) || !clock_compare(next, ticks))
+        {
+          next = ticks + 1;
+        }
+
+      wd_wheel_setbase(next);
+    }
+
+  return NULL;
+}
@@ -58,12 +58,14 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern struct list_node g_wdactivelist;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -123,6 +125,88 @@ void wd_timer(clock_t ticks);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Insert the watchdog into the hierarchical timer wheel.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog with the expiration time already set
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumptions:
+ *   Called inside the critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove the active watchdog from the hierarchical timer wheel.
+ *
+ * Input Parameters:
+ *   wdog - The watchdog to remove
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumptions:
+ *   Called inside the critical section.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Get the next time the timer wheel needs to be serviced, the time is
+ *   never later than the expiration of the first watchdog.
+ *
+ * Input Parameters:
+ *   next - The location to return the next time
+ *
+ * Returned Value:
+ *   true if any watchdog is active, otherwise false.
+ *
+ * Assumptions:
+ *   Called inside the critical section.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR clock_t *next);
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Advance the timer wheel to the specified time and remove the next
+ *   expired watchdog.
+ *
+ * Input Parameters:
+ *   ticks - current time in ticks
+ *
+ * Returned Value:
+ *   The expired watchdog, or NULL if there is no more expired watchdog.
+ *
+ * Assumptions:
+ *   Called inside the critical section.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(clock_t ticks);
+
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -59,16 +59,41 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
    */
 
   flags = enter_critical_section();
+
+  /* The work belongs to the queue it was last queued to, which may be the
+   * queue of another CPU.
+   */
+
+  if (work->wq != NULL)
+    {
+      wqueue = work->wq;
+    }
+
   if (work->worker != NULL)
     {
       /* Remove the entry from the work queue and make sure that it is
        * marked as available (i.e., the worker field is nullified).
        */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_TIMER
+      if ((work->flags & WORK_FLAG_DELAYED) != 0)
+        {
+          dq_rem((FAR dq_entry_t *)work, &wqueue->dq);
+          work->flags &= ~WORK_FLAG_DELAYED;
+
+          /* The timer would only expire for nothing now */
+
+          if (dq_empty(&wqueue->dq))
+            {
+              wd_cancel(&wqueue->timer);
+            }
+        }
+#else
       if (WDOG_ISACTIVE(&work->u.timer))
         {
           wd_cancel(&work->u.timer);
         }
+#endif
       else
         {
           dq_rem((FAR dq_entry_t *)work, &wqueue->q);
@@ -0,0 +1,362 @@
+/****************************************************************************
+ * sched/wqueue/kwork_procfs.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "wqueue/wqueue.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Output format, one line for each high and low priority work queue with
+ * the maximum latency and the number of work started within each latency
+ * range, in microseconds:
+ *
+ *   QUEUE  CPU PENDING   MAX <1 <2 <4 ... <16384 >=16384
+ *   hpwork   0       0    12 96 40  3 ...      0       0
+ */
+
+#define WQUEUE_LINELEN  (32 + 11 * WORK_LATENCY_NBUCKETS)
+
+#if defined(CONFIG_SCHED_HPWORK) && defined(CONFIG_SCHED_LPWORK)
+#  define WQUEUE_NQUEUES (2 * WORK_NQUEUES)
+#else
+#  define WQUEUE_NQUEUES WORK_NQUEUES
+#endif
+
+#define WQUEUE_BUFSIZE  ((WQUEUE_NQUEUES + 1) * WQUEUE_LINELEN)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct wqueue_file_s
+{
+  struct procfs_file_s base;        /* Base open file structure */
+  size_t linesize;                  /* Number of valid characters in buf */
+  char buf[WQUEUE_BUFSIZE];         /* Snapshot taken at offset zero */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     wqueue_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     wqueue_close(FAR struct file *filep);
+static ssize_t wqueue_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     wqueue_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     wqueue_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly extern'ed there. */
+
+const struct procfs_operations g_wqueue_operations =
+{
+  wqueue_open,    /* open */
+  wqueue_close,   /* close */
+  wqueue_read,    /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+
+  wqueue_dup,     /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  wqueue_stat     /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wqueue_line
+ *
+ * Description:
+ *   Format the statistics of one work queue.
+ *
+ ****************************************************************************/
+
+static size_t wqueue_line(FAR char *buf, size_t size, FAR const char *name,
+                          FAR struct kwork_wqueue_s *wqueue)
+{
+  struct kwork_latency_s latency;
+  struct timespec ts;
+  irqstate_t flags;
+  size_t pending;
+  size_t len;
+  int cpu = -1;
+  int i;
+
+  flags   = enter_critical_section();
+  latency = wqueue->latency;
+  pending = dq_count(&wqueue->q);
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  cpu     = wqueue->cpu;
+#endif
+  leave_critical_section(flags);
+
+  perf_convert(latency.max, &ts);
+
+  if (cpu < 0)
+    {
+      len = procfs_snprintf(buf, size, "%-6s   -", name);
+    }
+  else
+    {
+      len = procfs_snprintf(buf, size, "%-6s %3d", name, cpu);
+    }
+
+  len += procfs_snprintf(buf + len, size - len, " %7zu %5lu", pending,
+                         (unsigned long)(ts.tv_sec * USEC_PER_SEC +
+                                         ts.tv_nsec / NSEC_PER_USEC));
+  for (i = 0; i < WORK_LATENCY_NBUCKETS; i++)
+    {
+      len += procfs_snprintf(buf + len, size - len, " %" PRIu32,
+                             latency.count[i]);
+    }
+
+  len += procfs_snprintf(buf + len, size - len, "\n");
+  return len;
+}
+
+/****************************************************************************
+ * Name: wqueue_open
+ ****************************************************************************/
+
+static int wqueue_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct wqueue_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct wqueue_file_s));
+  if (attr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_close
+ ****************************************************************************/
+
+static int wqueue_close(FAR struct file *filep)
+{
+  FAR struct wqueue_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_read
+ ****************************************************************************/
+
+static ssize_t wqueue_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct wqueue_file_s *attr;
+  FAR char *buf;
+  size_t size;
+  off_t offset;
+  ssize_t ret;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Take a snapshot of all queues at the start, so that the output stays
+   * consistent however it is read.
+   */
+
+  if (filep->f_pos == 0)
+    {
+      buf  = attr->buf;
+      size = sizeof(attr->buf);
+
+      attr->linesize = procfs_snprintf(buf, size,
+                                       "QUEUE  CPU PENDING   MAX");
+      for (i = 0; i < WORK_LATENCY_NBUCKETS - 1; i++)
+        {
+          attr->linesize += procfs_snprintf(buf + attr->linesize,
+                                            size - attr->linesize,
+                                            " <%d", 1 << i);
+        }
+
+      attr->linesize += procfs_snprintf(buf + attr->linesize,
+                                        size - attr->linesize, " >=%d\n",
+                                        1 << (WORK_LATENCY_NBUCKETS - 2));
+
+      for (i = 0; i < WORK_NQUEUES; i++)
+        {
+#ifdef CONFIG_SCHED_HPWORK
+          attr->linesize += wqueue_line(buf + attr->linesize,
+                                        size - attr->linesize, HPWORKNAME,
+                                        (FAR struct kwork_wqueue_s *)
+                                        &g_hpwork[i]);
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+          attr->linesize += wqueue_line(buf + attr->linesize,
+                                        size - attr->linesize, LPWORKNAME,
+                                        (FAR struct kwork_wqueue_s *)
+                                        &g_lpwork[i]);
+#endif
+        }
+    }
+
+  offset = filep->f_pos;
+  ret = procfs_memcpy(attr->buf, attr->linesize, buffer, buflen, &offset);
+
+  /* Update the file offset */
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: wqueue_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int wqueue_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct wqueue_file_s *oldattr;
+  FAR struct wqueue_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct wqueue_file_s));
+  if (newattr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct wqueue_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: wqueue_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int wqueue_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "wqueue" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_WORKQUEUE_LATENCY */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -41,26 +42,155 @@
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Private Functions
  ****************************************************************************/
 
-#define queue_work(wqueue, work) \
-  do \
-    { \
-      int sem_count; \
-      dq_addlast((FAR dq_entry_t *)(work), &(wqueue)->q); \
-      nxsem_get_value(&(wqueue)->sem, &sem_count); \
-      if (sem_count < 0) /* There are threads waiting for sem. */ \
-        { \
-          nxsem_post(&(wqueue)->sem); \
-        } \
-    } \
-  while (0)
+/****************************************************************************
+ * Name: work_wakeup
+ *
+ * Description:
+ *   Wake up a worker thread waiting on the work queue.  Return false if
+ *   none of them is waiting.
+ *
+ ****************************************************************************/
+
+static bool work_wakeup(FAR struct kwork_wqueue_s *wqueue)
+{
+  int sem_count;
+
+  nxsem_get_value(&wqueue->sem, &sem_count);
+  if (sem_count < 0) /* There are threads waiting for sem. */
+    {
+      nxsem_post(&wqueue->sem);
+      return true;
+    }
+
+  return false;
+}
 
 /****************************************************************************
- * Private Functions
+ * Name: queue_work
+ *
+ * Description:
+ *   Add the work to the queue of ready work and wake up a worker.  If all
+ *   of the workers of a per-CPU queue are busy, an idle worker of the next
+ *   CPUs is woken up instead to take the work, unless it is pinned.
+ *
  ****************************************************************************/
 
+static void queue_work(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+  work->u.s.qtime = perf_gettime();
+#endif
+
+  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  if (!work_wakeup(wqueue) && (work->flags & WORK_FLAG_PINNED) == 0)
+    {
+      FAR struct kwork_wqueue_s *next;
+
+      for (next = wqueue->next; next != NULL && next != wqueue;
+           next = next->next)
+        {
+          if (work_wakeup(next))
+            {
+              break;
+            }
+        }
+    }
+#else
+  work_wakeup(wqueue);
+#endif
+}
+
+#ifdef CONFIG_SCHED_WORKQUEUE_TIMER
+
+/****************************************************************************
+ * Name: work_timer_expiry
+ *
+ * Description:
+ *   Move all of the delayed work which expired to the ready queue, then
+ *   restart the timer for the next one.
+ *
+ ****************************************************************************/
+
+static void work_timer_expiry(wdparm_t arg)
+{
+  FAR struct kwork_wqueue_s *wqueue = (FAR struct kwork_wqueue_s *)arg;
+  FAR struct work_s *work;
+  irqstate_t flags = enter_critical_section();
+  clock_t now = clock_systime_ticks();
+
+  while ((work = (FAR struct work_s *)dq_peek(&wqueue->dq)) != NULL)
+    {
+      if ((sclock_t)(work->u.s.qtime - now) > 0)
+        {
+          wd_start_abstick(&wqueue->timer, work->u.s.qtime,
+                           work_timer_expiry, (wdparm_t)wqueue);
+          break;
+        }
+
+      dq_remfirst(&wqueue->dq);
+      work->flags &= ~WORK_FLAG_DELAYED;
+      queue_work(wqueue, work);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: work_delay
+ *
+ * Description:
+ *   Insert the work in the delayed list, after any work with the same
+ *   expiry, and restart the timer if it is the first one to expire.
+ *
+ ****************************************************************************/
+
+static void work_delay(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work, clock_t delay)
+{
+  FAR dq_entry_t *curr;
+  clock_t expiry;
+
+  expiry = clock_systime_ticks() + delay;
+#if CONFIG_SCHED_WORKQUEUE_TIMER_SLACK > 1
+  expiry += CONFIG_SCHED_WORKQUEUE_TIMER_SLACK - 1;
+  expiry -= expiry % CONFIG_SCHED_WORKQUEUE_TIMER_SLACK;
+#endif
+
+  work->u.s.qtime = expiry;
+  work->flags    |= WORK_FLAG_DELAYED;
+
+  for (curr = dq_peek(&wqueue->dq); curr != NULL; curr = dq_next(curr))
+    {
+      if ((sclock_t)(((FAR struct work_s *)curr)->u.s.qtime - expiry) > 0)
+        {
+          break;
+        }
+    }
+
+  if (curr != NULL)
+    {
+      dq_addbefore(curr, (FAR dq_entry_t *)work, &wqueue->dq);
+    }
+  else
+    {
+      dq_addlast((FAR dq_entry_t *)work, &wqueue->dq);
+    }
+
+  if (dq_peek(&wqueue->dq) == (FAR dq_entry_t *)work)
+    {
+      wd_start_abstick(&wqueue->timer, expiry, work_timer_expiry,
+                       (wdparm_t)wqueue);
+    }
+}
+
+#else
+
 /****************************************************************************
  * Name: work_timer_expiry
  ****************************************************************************/
@@ -74,6 +204,8 @@ static void work_timer_expiry(wdparm_t arg)
   leave_critical_section(flags);
 }
 
+#endif /* CONFIG_SCHED_WORKQUEUE_TIMER */
+
 static bool work_is_canceling(FAR struct kworker_s *kworkers, int nthreads,
                               FAR struct work_s *work)
 {
@@ -96,43 +228,19 @@ static bool work_is_canceling(FAR struct kworker_s *kworkers, int nthreads,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: work_queue/work_queue_wq
+ * Name: work_qqueue
  *
  * Description:
- *   Queue work to be performed at a later time.  All queued work will be
- *   performed on the worker thread of execution (not the caller's).
- *
- *   The work structure is allocated and must be initialized to all zero by
- *   the caller.  Otherwise, the work structure is completely managed by the
- *   work queue logic.  The caller should never modify the contents of the
- *   work queue structure directly.  If work_queue() is called before the
- *   previous work has been performed and removed from the queue, then any
- *   pending work will be canceled and lost.
- *
- * Input Parameters:
- *   qid    - The work queue ID (must be HPWORK or LPWORK)
- *   wqueue - The work queue handle
- *   work   - The work structure to queue
- *   worker - The worker callback to be invoked.  The callback will be
- *            invoked on the worker thread of execution.
- *   arg    - The argument that will be passed to the worker callback when
- *            it is invoked.
- *   delay  - Delay (in clock ticks) from the time queue until the worker
- *            is invoked. Zero means to perform the work immediately.
- *
- * Returned Value:
- *   Zero on success, a negated errno on failure
+ *   Queue work, see work_queue_wq().  pinned is true if the work must be
+ *   performed by the workers of this queue only.
  *
  ****************************************************************************/
 
-int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
-                  FAR struct work_s *work, worker_t worker,
-                  FAR void *arg, clock_t delay)
+static int work_qqueue(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work, worker_t worker,
+                       FAR void *arg, clock_t delay, bool pinned)
 {
+  FAR struct kwork_wqueue_s *prev;
   irqstate_t flags;
   int ret = OK;
 
@@ -154,7 +262,10 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
       work_cancel_wq(wqueue, work);
     }
 
-  if (work_is_canceling(wqueue->worker, wqueue->nthreads, work))
+  /* The work may still be running in the queue it was last queued to */
+
+  prev = work->wq != NULL ? work->wq : wqueue;
+  if (work_is_canceling(prev->worker, prev->nthreads, work))
     {
       goto out;
     }
@@ -165,6 +276,17 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
   work->arg    = arg;              /* Callback argument */
   work->wq     = wqueue;           /* Work queue */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  if (pinned)
+    {
+      work->flags |= WORK_FLAG_PINNED;
+    }
+  else
+    {
+      work->flags &= ~WORK_FLAG_PINNED;
+    }
+#endif
+
   /* Queue the new work */
 
   if (!delay)
@@ -173,7 +295,11 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
     }
   else
     {
+#ifdef CONFIG_SCHED_WORKQUEUE_TIMER
+      work_delay(wqueue, work, delay);
+#else
       wd_start(&work->u.timer, delay, work_timer_expiry, (wdparm_t)work);
+#endif
     }
 
 out:
@@ -181,10 +307,117 @@ out:
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_queue/work_queue_wq
+ *
+ * Description:
+ *   Queue work to be performed at a later time.  All queued work will be
+ *   performed on the worker thread of execution (not the caller's).
+ *
+ *   The work structure is allocated and must be initialized to all zero by
+ *   the caller.  Otherwise, the work structure is completely managed by the
+ *   work queue logic.  The caller should never modify the contents of the
+ *   work queue structure directly.  If work_queue() is called before the
+ *   previous work has been performed and removed from the queue, then any
+ *   pending work will be canceled and lost.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
+                  FAR struct work_s *work, worker_t worker,
+                  FAR void *arg, clock_t delay)
+{
+  return work_qqueue(wqueue, work, worker, arg, delay, false);
+}
+
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay)
 {
-  return work_queue_wq(work_qid2wq(qid), work, worker, arg, delay);
+  return work_qqueue(work_qid2wq(qid), work, worker, arg, delay, false);
 }
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue work to be performed by the worker threads of one CPU.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   cpu    - The CPU to perform the work
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.
+ *   arg    - The argument that will be passed to the worker callback.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, clock_t delay)
+{
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  return work_qqueue(work_cpu2wq(qid, cpu), work, worker, arg, delay, true);
+#else
+  return work_qqueue(work_qid2wq(qid), work, worker, arg, delay, false);
+#endif
+}
+
+#ifdef CONFIG_SCHED_WORKQUEUE_TIMER
+
+/****************************************************************************
+ * Name: work_timeleft
+ *
+ * Description:
+ *   Return the time in system ticks remaining until the work starts, zero
+ *   if it is not delayed.
+ *
+ ****************************************************************************/
+
+sclock_t work_timeleft(FAR struct work_s *work)
+{
+  irqstate_t flags = enter_critical_section();
+  sclock_t left = 0;
+
+  if (work->worker != NULL && (work->flags & WORK_FLAG_DELAYED) != 0)
+    {
+      left = (sclock_t)(work->u.s.qtime - clock_systime_ticks());
+      if (left < 0)
+        {
+          left = 0;
+        }
+    }
+
+  leave_critical_section(flags);
+  return left;
+}
+
+#endif /* CONFIG_SCHED_WORKQUEUE_TIMER */
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
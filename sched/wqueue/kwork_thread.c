@@ -81,12 +81,14 @@
 #if defined(CONFIG_SCHED_HPWORK)
 /* The state of the kernel mode, high priority work queue(s). */
 
-struct hp_wqueue_s g_hpwork =
+struct hp_wqueue_s g_hpwork[WORK_NQUEUES] =
 {
-  {NULL, NULL},
-  SEM_INITIALIZER(0),
-  SEM_INITIALIZER(0),
-  CONFIG_SCHED_HPNTHREADS,
+  {
+    {NULL, NULL},
+    SEM_INITIALIZER(0),
+    SEM_INITIALIZER(0),
+    CONFIG_SCHED_HPNTHREADS,
+  },
 };
 
 #endif /* CONFIG_SCHED_HPWORK */
@@ -94,12 +96,14 @@ struct hp_wqueue_s g_hpwork =
 #if defined(CONFIG_SCHED_LPWORK)
 /* The state of the kernel mode, low priority work queue(s). */
 
-struct lp_wqueue_s g_lpwork =
+struct lp_wqueue_s g_lpwork[WORK_NQUEUES] =
 {
-  {NULL, NULL},
-  SEM_INITIALIZER(0),
-  SEM_INITIALIZER(0),
-  CONFIG_SCHED_LPNTHREADS,
+  {
+    {NULL, NULL},
+    SEM_INITIALIZER(0),
+    SEM_INITIALIZER(0),
+    CONFIG_SCHED_LPNTHREADS,
+  },
 };
 
 #endif /* CONFIG_SCHED_LPWORK */
@@ -108,6 +112,86 @@ struct lp_wqueue_s g_lpwork =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_dequeue
+ *
+ * Description:
+ *   Remove the first ready work from the queue.  If there is none, take the
+ *   first one which isn't pinned from the queues of the other CPUs.
+ *
+ ****************************************************************************/
+
+static FAR struct work_s *work_dequeue(FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR struct work_s *work;
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  FAR struct kwork_wqueue_s *next;
+  FAR dq_entry_t *curr;
+#endif
+
+  work = (FAR struct work_s *)dq_remfirst(&wqueue->q);
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  for (next = wqueue->next; work == NULL && next != NULL && next != wqueue;
+       next = next->next)
+    {
+      for (curr = dq_peek(&next->q); curr != NULL; curr = dq_next(curr))
+        {
+          work = (FAR struct work_s *)curr;
+          if ((work->flags & WORK_FLAG_PINNED) == 0)
+            {
+              /* It now belongs to this queue, for work_cancel_sync() */
+
+              dq_rem(curr, &next->q);
+              work->wq = wqueue;
+              break;
+            }
+
+          work = NULL;
+        }
+    }
+#endif
+
+  return work;
+}
+
+/****************************************************************************
+ * Name: work_latency
+ *
+ * Description:
+ *   Add the time since the work was ready to the latency histogram.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+static void work_latency(FAR struct kwork_wqueue_s *wqueue,
+                         FAR struct work_s *work)
+{
+  FAR struct kwork_latency_s *latency = &wqueue->latency;
+  clock_t elapsed = perf_gettime() - work->u.s.qtime;
+  struct timespec ts;
+  unsigned long us;
+  int bucket = 0;
+
+  perf_convert(elapsed, &ts);
+  us = ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+
+  while (us > 0 && bucket < WORK_LATENCY_NBUCKETS - 1)
+    {
+      us >>= 1;
+      bucket++;
+    }
+
+  latency->count[bucket]++;
+  if (elapsed > latency->max)
+    {
+      latency->max = elapsed;
+    }
+}
+#else
+#  define work_latency(wqueue, work)
+#endif
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -160,13 +244,15 @@ static int work_thread(int argc, FAR char *argv[])
 
       /* Remove the ready-to-execute work from the list */
 
-      while ((work = (FAR struct work_s *)dq_remfirst(&wqueue->q)) != NULL)
+      while ((work = work_dequeue(wqueue)) != NULL)
         {
           if (work->worker == NULL)
             {
               continue;
             }
 
+          work_latency(wqueue, work);
+
           /* Extract the work description from the entry (in case the work
            * instance will be re-used after it has been de-queued).
            */
@@ -277,12 +363,74 @@ static int work_thread_create(FAR const char *name, int priority,
         }
 
       wqueue->worker[wndx].pid = pid;
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      /* Bind the worker to the CPU of a per-CPU queue */
+
+      if (wqueue->cpu >= 0)
+        {
+          cpu_set_t cpuset;
+
+          CPU_ZERO(&cpuset);
+          CPU_SET(wqueue->cpu, &cpuset);
+          nxsched_set_affinity(pid, sizeof(cpuset), &cpuset);
+        }
+#endif
     }
 
   sched_unlock();
   return OK;
 }
 
+/****************************************************************************
+ * Name: work_start_queues
+ *
+ * Description:
+ *   Start the worker threads of the high or low priority work queue(s).
+ *   Per-CPU queues are linked in a ring and named after their CPU.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_HPWORK) || defined(CONFIG_SCHED_LPWORK)
+static int work_start_queues(int qid, FAR const char *name, int priority,
+                             int stack_size, int nthreads)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  FAR struct kwork_wqueue_s *wqueue;
+  char cpuname[CONFIG_TASK_NAME_SIZE + 1];
+  int ret;
+  int cpu;
+
+  for (cpu = 0; cpu < WORK_NQUEUES; cpu++)
+    {
+      /* Work may be queued already, don't touch the queue */
+
+      wqueue           = work_cpu2wq(qid, cpu);
+      wqueue->nthreads = nthreads;
+      wqueue->cpu      = cpu;
+      wqueue->next     = work_cpu2wq(qid, (cpu + 1) % WORK_NQUEUES);
+    }
+
+  for (cpu = 0; cpu < WORK_NQUEUES; cpu++)
+    {
+      snprintf(cpuname, sizeof(cpuname), "%s%d", name, cpu);
+      ret = work_thread_create(cpuname, priority, NULL, stack_size,
+                               work_cpu2wq(qid, cpu));
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+#else
+  UNUSED(nthreads);
+  return work_thread_create(name, priority, NULL, stack_size,
+                            work_qid2wq(qid));
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -337,6 +485,9 @@ FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
   nxsem_init(&wqueue->sem, 0, 0);
   nxsem_init(&wqueue->exsem, 0, 0);
   wqueue->nthreads = nthreads;
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  wqueue->cpu      = -1;
+#endif
 
   /* Create the work queue thread pool */
 
@@ -391,6 +542,10 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
       nxsem_wait_uninterruptible(&wqueue->exsem);
     }
 
+#ifdef CONFIG_SCHED_WORKQUEUE_TIMER
+  wd_cancel(&wqueue->timer);
+#endif
+
   nxsem_destroy(&wqueue->sem);
   nxsem_destroy(&wqueue->exsem);
   kmm_free(wqueue);
@@ -460,9 +615,9 @@ int work_start_highpri(void)
 
   sinfo("Starting high-priority kernel worker thread(s)\n");
 
-  return work_thread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY, NULL,
-                            CONFIG_SCHED_HPWORKSTACKSIZE,
-                            (FAR struct kwork_wqueue_s *)&g_hpwork);
+  return work_start_queues(HPWORK, HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY,
+                           CONFIG_SCHED_HPWORKSTACKSIZE,
+                           CONFIG_SCHED_HPNTHREADS);
 }
 #endif /* CONFIG_SCHED_HPWORK */
 
@@ -488,9 +643,9 @@ int work_start_lowpri(void)
 
   sinfo("Starting low-priority kernel worker thread(s)\n");
 
-  return work_thread_create(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY, NULL,
-                            CONFIG_SCHED_LPWORKSTACKSIZE,
-                            (FAR struct kwork_wqueue_s *)&g_lpwork);
+  return work_start_queues(LPWORK, LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY,
+                           CONFIG_SCHED_LPWORKSTACKSIZE,
+                           CONFIG_SCHED_LPNTHREADS);
 }
 #endif /* CONFIG_SCHED_LPWORK */
 
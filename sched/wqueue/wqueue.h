@@ -34,6 +34,8 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/queue.h>
+#include <nuttx/sched.h>
+#include <nuttx/wdog.h>
 #include <nuttx/wqueue.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
@@ -47,10 +49,43 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* Number of high and low priority work queues, one for each CPU if they
+ * are per-CPU.
+ */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+#  define WORK_NQUEUES      CONFIG_SMP_NCPUS
+#  define WORK_THISQUEUE    this_cpu()
+#else
+#  define WORK_NQUEUES      1
+#  define WORK_THISQUEUE    0
+#endif
+
+/* Values of work_s::flags */
+
+#define WORK_FLAG_PINNED    (1 << 0) /* Queued by work_queue_cpu() */
+#define WORK_FLAG_DELAYED   (1 << 1) /* In the delayed list of the queue */
+
+/* Latency histogram: bucket 0 counts latencies below 1 microsecond, bucket
+ * n below 2^n microseconds, and the last one everything above.
+ */
+
+#define WORK_LATENCY_NBUCKETS 16
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
 
+/* Latency from when work is ready until a worker starts it */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+struct kwork_latency_s
+{
+  clock_t           max;       /* Maximum latency, in perf counts */
+  uint32_t          count[WORK_LATENCY_NBUCKETS];
+};
+#endif
+
 /* This represents one worker */
 
 struct kworker_s
@@ -69,6 +104,20 @@ struct kwork_wqueue_s
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  int16_t           cpu;       /* The CPU of the workers, -1 if any */
+
+  /* The queue of the next CPU in the ring, or NULL */
+
+  FAR struct kwork_wqueue_s *next;
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_TIMER
+  struct dq_queue_s dq;        /* Delayed work, sorted by expiry */
+  struct wdog_s     timer;     /* Expiry of the first delayed work */
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+  struct kwork_latency_s latency;
+#endif
   struct kworker_s  worker[0]; /* Describes a worker thread */
 };
 
@@ -84,6 +133,20 @@ struct hp_wqueue_s
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  int16_t           cpu;       /* The CPU of the workers, -1 if any */
+
+  /* The queue of the next CPU in the ring, or NULL */
+
+  FAR struct kwork_wqueue_s *next;
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_TIMER
+  struct dq_queue_s dq;        /* Delayed work, sorted by expiry */
+  struct wdog_s     timer;     /* Expiry of the first delayed work */
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+  struct kwork_latency_s latency;
+#endif
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -103,6 +166,20 @@ struct lp_wqueue_s
   sem_t             exsem;     /* Sync waiting for thread exit */
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  int16_t           cpu;       /* The CPU of the workers, -1 if any */
+
+  /* The queue of the next CPU in the ring, or NULL */
+
+  FAR struct kwork_wqueue_s *next;
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_TIMER
+  struct dq_queue_s dq;        /* Delayed work, sorted by expiry */
+  struct wdog_s     timer;     /* Expiry of the first delayed work */
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_LATENCY
+  struct kwork_latency_s latency;
+#endif
 
   /* Describes each thread in the low priority queue's thread pool */
 
@@ -115,34 +192,39 @@ struct lp_wqueue_s
  ****************************************************************************/
 
 #ifdef CONFIG_SCHED_HPWORK
-/* The state of the kernel mode, high priority work queue. */
+/* The state of the kernel mode, high priority work queue(s). */
 
-extern struct hp_wqueue_s g_hpwork;
+extern struct hp_wqueue_s g_hpwork[WORK_NQUEUES];
 #endif
 
 #ifdef CONFIG_SCHED_LPWORK
 /* The state of the kernel mode, low priority work queue(s). */
 
-extern struct lp_wqueue_s g_lpwork;
+extern struct lp_wqueue_s g_lpwork[WORK_NQUEUES];
 #endif
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
-static inline_function FAR struct kwork_wqueue_s *work_qid2wq(int qid)
+/* Return the work queue of qid which belongs to one CPU, or the work queue
+ * of the calling CPU.
+ */
+
+static inline_function FAR struct kwork_wqueue_s *
+work_cpu2wq(int qid, int index)
 {
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
-      return (FAR struct kwork_wqueue_s *)&g_hpwork;
+      return (FAR struct kwork_wqueue_s *)&g_hpwork[index];
     }
   else
 #endif
 #ifdef CONFIG_SCHED_LPWORK
   if (qid == LPWORK)
     {
-      return (FAR struct kwork_wqueue_s *)&g_lpwork;
+      return (FAR struct kwork_wqueue_s *)&g_lpwork[index];
     }
   else
 #endif
@@ -151,6 +233,8 @@ static inline_function FAR struct kwork_wqueue_s *work_qid2wq(int qid)
     }
 }
 
+#define work_qid2wq(qid) work_cpu2wq(qid, WORK_THISQUEUE)
+
 /****************************************************************************
  * Name: work_start_highpri
  *
@@ -617,6 +617,14 @@ static const char *g_white_content_list[] =
   "unzGetCurrentFileInfo64",
   "unzGoToNextFile",
   "unzGoToFirstFile",
+  "unzGetCurrentFileZStreamPos64",
+  "unzCloseCurrentFile",
+  "uInt",
+  "inflateInit2",
+  "inflateReset",
+  "inflatePrime",
+  "inflateGetDictionary",
+  "inflateSetDictionary",
   NULL
 };
 